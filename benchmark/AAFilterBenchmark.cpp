@@ -0,0 +1,92 @@
+#include "AAFilterBenchmark.hpp"
+#include "../src/ChowDSP.hpp"
+
+// Throughput of chowdsp::processPipelinedCascade() against the serial biquad loop that AAFilter::process() runs,
+// for cascades of N biquads (filter order 2N) over blocks of a given length. Oversampling filters blocks of `ratio`
+// samples, so the block lengths cover 1x to 16x (and 32). The speedup column is what AAFilter::MIN_PIPELINED_FRAMES
+// and MIN_PIPELINED_ORDER are chosen from.
+
+namespace benchmark {
+
+static volatile float resultSink;
+
+// the Butterworth cascade AAFilter uses at 4x
+template <int N>
+static void designCascade(chowdsp::TBiquadFilter<float>* filters) {
+	const chowdsp::BiquadCoefficients* sections = chowdsp::AAFilterTable::get(chowdsp::BUTTERWORTH, 2, N);
+	for (int k = 0; k < N; ++k) {
+		filters[k].setCoefficients(sections[k].b, sections[k].a);
+	}
+}
+
+template <int N, bool pipelined>
+static double nsPerSample(int frames, int blockSize) {
+	chowdsp::TBiquadFilter<float> filters[N];
+	designCascade<N>(filters);
+
+	float block[32];
+	const int numBlocks = std::max(1, frames / blockSize);
+	const auto start = std::chrono::steady_clock::now();
+	for (int b = 0; b < numBlocks; ++b) {
+		for (int n = 0; n < blockSize; ++n) {
+			block[n] = ((b * blockSize + n) & 63) * 0.01f;
+		}
+		if (pipelined) {
+			chowdsp::processPipelinedCascade<N>(filters, block, blockSize);
+		}
+		else {
+			for (int n = 0; n < blockSize; ++n)
+				for (int k = 0; k < N; ++k)
+					block[n] = filters[k].process(block[n]);
+		}
+		// keep the result alive
+		resultSink = block[blockSize - 1];
+	}
+	const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	return ns / (numBlocks * blockSize);
+}
+
+// largest difference between the two over a block of a noisy signal, a check that they compute the same thing
+template <int N>
+static double maxDifference(int blockSize) {
+	chowdsp::TBiquadFilter<float> serial[N], pipelined[N];
+	designCascade<N>(serial);
+	designCascade<N>(pipelined);
+
+	double maxDiff = 0.;
+	for (int b = 0; b < 256; ++b) {
+		float x[32], y[32];
+		for (int n = 0; n < blockSize; ++n) {
+			x[n] = y[n] = std::sin(0.7 * (b * blockSize + n)) + ((b * blockSize + n) % 5 == 0);
+		}
+		for (int n = 0; n < blockSize; ++n)
+			for (int k = 0; k < N; ++k)
+				x[n] = serial[k].process(x[n]);
+		chowdsp::processPipelinedCascade<N>(pipelined, y, blockSize);
+		for (int n = 0; n < blockSize; ++n) {
+			maxDiff = std::max(maxDiff, (double) std::fabs(x[n] - y[n]));
+		}
+	}
+	return maxDiff;
+}
+
+template <int N>
+static void compareOrder(int frames) {
+	for (int blockSize : {1, 2, 4, 8, 16, 32}) {
+		const double serial = nsPerSample<N, false>(frames, blockSize);
+		const double pipelined = nsPerSample<N, true>(frames, blockSize);
+		std::printf("%d,%d,%.2f,%.2f,%.2f,%.1e\n", 2 * N, blockSize, serial, pipelined, serial / pipelined, maxDifference<N>(blockSize));
+		std::fflush(stdout);
+	}
+}
+
+int runAAFilterBenchmark(int frames) {
+	std::printf("order,block_size,serial_ns_per_sample,pipelined_ns_per_sample,speedup,max_difference\n");
+	compareOrder<2>(frames);
+	compareOrder<4>(frames);
+	compareOrder<6>(frames);
+	compareOrder<8>(frames);
+	return 0;
+}
+
+} // namespace benchmark
@@ -0,0 +1,10 @@
+#pragma once
+#include "BenchmarkHarness.hpp"
+
+namespace benchmark {
+
+/** Compares running mono blocks through AAFilter's biquads serially and as a pipelined cascade, for 2 to 8 biquads
+ and block lengths 1 to 32, printing ns per sample as CSV */
+int runAAFilterBenchmark(int frames);
+
+} // namespace benchmark
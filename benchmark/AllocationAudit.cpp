@@ -0,0 +1,98 @@
+#include "AllocationAudit.hpp"
+
+// Audio-thread allocation audit: pushes every module through the kind of input that has caused dropouts in the
+// past (program CV changing Noise Plethora's algorithm, knobs being turned, the sample rate changing) and counts
+// what the audit hooks in src/AudioThreadAudit.cpp catch. Each offending module is reported once per kind with a
+// stack trace on stderr as it happens, and summarised on stdout as CSV.
+
+namespace benchmark {
+
+static const float AUDIT_SAMPLE_RATE = 48000.f;
+static const float AUDIT_SECOND_SAMPLE_RATE = 96000.f;
+static const int AUDIT_FRAMES = 1 << 17;
+static const int PARAM_UPDATE_FRAMES = 64;
+
+// a bipolar triangle covering the full +-10V range, with a different period on each port
+static float sweepVoltage(int portId, int channel, int64_t frame) {
+	const float period = AUDIT_FRAMES / (2.f + portId + 0.5f * channel);
+	const float phase = std::fmod(frame / period, 1.f);
+	return 10.f * (4.f * std::fabs(phase - 0.5f) - 1.f);
+}
+
+static int auditModule(Model* model, int channels) {
+	Module* module = createModuleAt(model, AUDIT_SAMPLE_RATE);
+	// setChannels() leaves a disconnected port alone, so patch the inputs directly
+	for (Input& input : module->inputs) {
+		input.channels = channels;
+	}
+
+	Module::ProcessArgs args;
+	args.sampleRate = AUDIT_SAMPLE_RATE;
+	args.sampleTime = 1.f / AUDIT_SAMPLE_RATE;
+
+	const int violationsBefore = audit::getNumViolations();
+	for (int64_t frame = 0; frame < AUDIT_FRAMES; ++frame) {
+		if (frame == AUDIT_FRAMES / 2) {
+			// as the engine does when the audio device changes rate
+			APP->engine->setSampleRate(AUDIT_SECOND_SAMPLE_RATE);
+			Module::SampleRateChangeEvent e;
+			e.sampleRate = AUDIT_SECOND_SAMPLE_RATE;
+			e.sampleTime = 1.f / AUDIT_SECOND_SAMPLE_RATE;
+			module->onSampleRateChange(e);
+			args.sampleRate = e.sampleRate;
+			args.sampleTime = e.sampleTime;
+		}
+
+		// even ports sweep (CV), odd ports get the usual synthetic gates so triggers and clocks fire
+		for (size_t i = 0; i < module->inputs.size(); ++i) {
+			for (int c = 0; c < channels; ++c) {
+				module->inputs[i].setVoltage(i % 2 == 0 ? sweepVoltage(i, c, frame) : syntheticVoltage(i, c, frame, args.sampleRate), c);
+			}
+		}
+
+		// knobs and switches sweep their whole range too, as they would if turned from the UI thread
+		if (frame % PARAM_UPDATE_FRAMES == 0) {
+			for (size_t i = 0; i < module->paramQuantities.size(); ++i) {
+				ParamQuantity* pq = module->paramQuantities[i];
+				if (std::isfinite(pq->minValue) && std::isfinite(pq->maxValue)) {
+					pq->setValue(math::rescale(sweepVoltage(i, 0, frame), -10.f, 10.f, pq->minValue, pq->maxValue));
+				}
+			}
+		}
+
+		args.frame = frame;
+		module->process(args);
+	}
+	const int violations = audit::getNumViolations() - violationsBefore;
+
+	delete module;
+	return violations;
+}
+
+int runAudit(Plugin* plugin, const std::string& moduleFilter) {
+#ifndef BEFACO_AUDIT_AUDIO_THREAD
+	std::fprintf(stderr, "--audit needs a build made with `make AUDIT=1`\n");
+	return 1;
+#endif
+
+	std::printf("module,channels,violations\n");
+	int failures = 0;
+	for (Model* model : plugin->models) {
+		if (!moduleFilter.empty() && model->slug != moduleFilter) {
+			continue;
+		}
+		for (int channels : {1, 16}) {
+			const int violations = auditModule(model, channels);
+			std::printf("%s,%d,%d\n", model->slug.c_str(), channels, violations);
+			std::fflush(stdout);
+			if (violations) {
+				failures++;
+			}
+		}
+	}
+
+	std::fprintf(stderr, "%d module runs allocated or locked on the audio thread\n", failures);
+	return failures ? 1 : 0;
+}
+
+} // namespace benchmark
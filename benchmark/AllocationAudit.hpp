@@ -0,0 +1,11 @@
+#pragma once
+#include "BenchmarkHarness.hpp"
+
+namespace benchmark {
+
+/** Runs every module (or only `moduleFilter`) under CV and parameter sweeps with a sample rate change part way
+ through, and returns non-zero if any of them allocated, freed or locked a mutex on the audio thread. Needs a
+ `make AUDIT=1` build, otherwise nothing is hooked and it refuses to run. */
+int runAudit(Plugin* plugin, const std::string& moduleFilter);
+
+} // namespace benchmark
@@ -0,0 +1,210 @@
+// Headless benchmark for the Befaco modules.
+//
+// Creates every Model registered in plugin.cpp against a bare engine context (no window, no
+// audio driver, modules are never added to the engine so no worker threads are started) and
+// pushes fixed-length synthetic input through Module::process() at a range of sample rates and
+// polyphony counts. Results are written to stdout as CSV, one row per (module, sample rate,
+// channels) so that runs from different plugin versions can be diffed or plotted directly.
+//
+// The same tool renders and checks golden outputs (see GoldenRender.cpp), so that DSP
+// optimisations can be checked for both correctness and speedup in one run.
+//
+// Built with `make AUDIT=1 benchmark`, --audit runs every module under CV sweeps and fails if any of them
+// allocates or locks a mutex on the audio thread (see AllocationAudit.cpp).
+//
+// Build with `make benchmark`, then run e.g.
+//   build/benchmark/befaco-benchmark --module PonyVCO --frames 262144 > pony.csv
+//   build/benchmark/befaco-benchmark --module HexmixVCA --data '{"blockSize": 32}'
+//   build/benchmark/befaco-benchmark --render-golden golden/
+//   build/benchmark/befaco-benchmark --check-golden golden/ --tolerance 1e-3
+//   build/benchmark/befaco-benchmark --check-golden golden/ --tolerances benchmark/golden-tolerances.csv
+//   build/benchmark/befaco-benchmark --audit
+//   build/benchmark/befaco-benchmark --oversampling > oversampling.csv
+//   build/benchmark/befaco-benchmark --aa-filter > aa-filter.csv
+//   build/benchmark/befaco-benchmark --denormals > denormals.csv
+//   build/benchmark/befaco-benchmark --plethora-graphs > plethora.csv
+
+#include "BenchmarkHarness.hpp"
+#include "GoldenRender.hpp"
+#include "AllocationAudit.hpp"
+#include "OversamplingBenchmark.hpp"
+#include "AAFilterBenchmark.hpp"
+#include "DenormalBenchmark.hpp"
+#include "NoisePlethoraBenchmark.hpp"
+
+using namespace benchmark;
+
+
+static const float sampleRates[] = {44100.f, 48000.f, 96000.f, 192000.f};
+static const int channelCounts[] = {1, 4, 8, 16};
+
+struct BenchmarkOptions {
+	int frames = 1 << 16;
+	int warmupFrames = 1 << 12;
+	std::string moduleFilter;
+	// module settings applied with dataFromJson() before running, e.g. {"oversamplingIndex": 2}
+	json_t* dataJ = NULL;
+};
+
+struct BenchmarkResult {
+	double nsPerSample = 0.;
+	double samplesPerSec = 0.;
+	double cyclesPerSample = 0.;
+};
+
+static BenchmarkResult runBenchmark(Model* model, float sampleRate, int channels, const BenchmarkOptions& options) {
+	Module* module = createModuleAt(model, sampleRate);
+	if (options.dataJ) {
+		module->dataFromJson(options.dataJ);
+	}
+	const SyntheticInput input(module, channels, sampleRate);
+
+	Module::ProcessArgs args;
+	args.sampleRate = sampleRate;
+	args.sampleTime = 1.f / sampleRate;
+
+	auto runFrames = [&](int64_t firstFrame, int frames) {
+		for (int64_t frame = firstFrame; frame < firstFrame + frames; ++frame) {
+			input.apply(module, frame);
+			args.frame = frame;
+			module->process(args);
+		}
+	};
+
+	runFrames(0, options.warmupFrames);
+
+	const auto start = std::chrono::steady_clock::now();
+	const uint64_t startCycles = readCycleCounter();
+	runFrames(options.warmupFrames, options.frames);
+	const uint64_t endCycles = readCycleCounter();
+	const auto end = std::chrono::steady_clock::now();
+
+	delete module;
+
+	const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+	BenchmarkResult result;
+	result.nsPerSample = ns / options.frames;
+	result.samplesPerSec = 1e9 / result.nsPerSample;
+	result.cyclesPerSample = (endCycles > startCycles) ? double(endCycles - startCycles) / options.frames : NAN;
+	return result;
+}
+
+static void printUsage(const char* name) {
+	std::fprintf(stderr, "usage: %s [--frames N] [--warmup N] [--module SLUG] [--data JSON]\n", name);
+	std::fprintf(stderr, "       %s --render-golden DIR [--missing-only]\n", name);
+	std::fprintf(stderr, "       %s --check-golden DIR [--tolerance VOLTS] [--tolerances CSV]\n", name);
+	std::fprintf(stderr, "       %s --audit [--module SLUG]\n", name);
+	std::fprintf(stderr, "       %s --oversampling [--frames N]\n", name);
+	std::fprintf(stderr, "       %s --aa-filter [--frames N]\n", name);
+	std::fprintf(stderr, "       %s --denormals [--module SLUG]\n", name);
+	std::fprintf(stderr, "       %s --plethora-graphs [--frames N]\n", name);
+}
+
+int main(int argc, char* argv[]) {
+	BenchmarkOptions options;
+	std::string renderGoldenDir, checkGoldenDir, tolerancesPath;
+	bool renderMissingOnly = false;
+	float tolerance = 1e-3f;
+	bool runAllocationAudit = false;
+	bool compareOversampling = false;
+	bool compareAAFilterCascades = false;
+	bool stressDenormals = false;
+	bool timePlethoraGraphs = false;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--frames" && i + 1 < argc) {
+			options.frames = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--warmup" && i + 1 < argc) {
+			options.warmupFrames = std::max(0, std::atoi(argv[++i]));
+		}
+		else if (arg == "--module" && i + 1 < argc) {
+			options.moduleFilter = argv[++i];
+		}
+		else if (arg == "--data" && i + 1 < argc) {
+			json_error_t error;
+			options.dataJ = json_loads(argv[++i], 0, &error);
+			if (!options.dataJ) {
+				std::fprintf(stderr, "invalid --data JSON (%s)\n", error.text);
+				return 1;
+			}
+		}
+		else if (arg == "--render-golden" && i + 1 < argc) {
+			renderGoldenDir = argv[++i];
+		}
+		else if (arg == "--check-golden" && i + 1 < argc) {
+			checkGoldenDir = argv[++i];
+		}
+		else if (arg == "--missing-only") {
+			renderMissingOnly = true;
+		}
+		else if (arg == "--tolerance" && i + 1 < argc) {
+			tolerance = std::atof(argv[++i]);
+		}
+		else if (arg == "--tolerances" && i + 1 < argc) {
+			tolerancesPath = argv[++i];
+		}
+		else if (arg == "--audit") {
+			runAllocationAudit = true;
+		}
+		else if (arg == "--oversampling") {
+			compareOversampling = true;
+		}
+		else if (arg == "--aa-filter") {
+			compareAAFilterCascades = true;
+		}
+		else if (arg == "--denormals") {
+			stressDenormals = true;
+		}
+		else if (arg == "--plethora-graphs") {
+			timePlethoraGraphs = true;
+		}
+		else {
+			printUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	Plugin* plugin = initHeadless();
+
+	if (!renderGoldenDir.empty()) {
+		return renderGolden(plugin, renderGoldenDir, renderMissingOnly);
+	}
+	if (!checkGoldenDir.empty()) {
+		return checkGolden(plugin, checkGoldenDir, tolerance, tolerancesPath);
+	}
+	if (runAllocationAudit) {
+		return runAudit(plugin, options.moduleFilter);
+	}
+	if (compareOversampling) {
+		return runOversamplingBenchmark(options.frames);
+	}
+	if (compareAAFilterCascades) {
+		return runAAFilterBenchmark(options.frames);
+	}
+	if (stressDenormals) {
+		return runDenormalBenchmark(plugin, options.moduleFilter);
+	}
+	if (timePlethoraGraphs) {
+		return runNoisePlethoraGraphBenchmark(options.frames);
+	}
+
+	std::printf("module,sample_rate,channels,frames,ns_per_sample,samples_per_sec,cycles_per_sample\n");
+	for (Model* model : plugin->models) {
+		if (!options.moduleFilter.empty() && model->slug != options.moduleFilter) {
+			continue;
+		}
+
+		for (float sampleRate : sampleRates) {
+			for (int channels : channelCounts) {
+				const BenchmarkResult result = runBenchmark(model, sampleRate, channels, options);
+				std::printf("%s,%d,%d,%d,%.3f,%.0f,%.1f\n", model->slug.c_str(), (int) sampleRate, channels, options.frames,
+				            result.nsPerSample, result.samplesPerSec, result.cyclesPerSample);
+				std::fflush(stdout);
+			}
+		}
+	}
+
+	return 0;
+}
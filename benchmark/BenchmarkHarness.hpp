@@ -0,0 +1,118 @@
+#pragma once
+#include "../src/plugin.hpp"
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Shared pieces of the headless benchmark / golden-output tool: a bare engine context, module
+// creation at a given sample rate, and deterministic synthetic input.
+
+namespace benchmark {
+
+inline uint64_t readCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/** Sets up a minimal engine context (no window, no audio driver) and registers all models */
+inline Plugin* initHeadless() {
+	random::init();
+
+	Context* context = new Context;
+	contextSet(context);
+	settings::sampleRate = 0.f;
+	context->engine = new engine::Engine;
+
+	// assets (e.g. the SpringReverb IR) are resolved relative to the plugin directory, i.e. where this is run from
+	Plugin* plugin = new Plugin;
+	plugin->path = ".";
+	plugin->slug = "Befaco";
+	init(plugin);
+	return plugin;
+}
+
+inline Model* findModel(Plugin* plugin, const std::string& slug) {
+	for (Model* model : plugin->models) {
+		if (model->slug == slug) {
+			return model;
+		}
+	}
+	return nullptr;
+}
+
+/** Creates a module as if it were added to an engine running at `sampleRate`, with every output patched */
+inline Module* createModuleAt(Model* model, float sampleRate) {
+	// modules (and e.g. the Noise Plethora graphs) read the rate back from the engine, and without an
+	// audio driver nothing applies a suggested rate, so set it directly
+	APP->engine->setSampleRate(sampleRate);
+
+	Module* module = model->createModule();
+
+	Module::SampleRateChangeEvent e;
+	e.sampleRate = sampleRate;
+	e.sampleTime = 1.f / sampleRate;
+	module->onSampleRateChange(e);
+
+	// an output with no channels reports as disconnected, and most modules skip their DSP entirely in that case;
+	// setChannels() leaves a disconnected port alone, so patch the ports the way the engine does when a cable is added
+	for (Output& output : module->outputs) {
+		output.channels = 1;
+	}
+	return module;
+}
+
+// even-numbered ports get audio-rate signals, odd-numbered ports get slow gates so that trigger,
+// clock and sync inputs actually fire during the run
+inline float syntheticVoltage(int portId, int channel, int frame, float sampleRate) {
+	const float t = frame / sampleRate;
+	if (portId % 2 == 0) {
+		const float freq = 55.f * (1 + portId / 2) * (1.f + 0.01f * channel);
+		return 5.f * std::sin(2.f * M_PI * freq * t + channel);
+	}
+	else {
+		const float freq = 2.f * (1 + portId / 2);
+		return (std::fmod(freq * t + 0.1f * channel, 1.f) < 0.5f) ? 10.f : 0.f;
+	}
+}
+
+/** Synthetic input is generated once into a short periodic table, so that generating it isn't part of the measured cost */
+struct SyntheticInput {
+	static const int TABLE_FRAMES = 4096;
+
+	int numInputs = 0;
+	int channels = 0;
+	std::vector<float> table;
+
+	SyntheticInput(Module* module, int channels, float sampleRate) : numInputs(module->inputs.size()), channels(channels) {
+		table.resize(TABLE_FRAMES * numInputs * channels);
+		for (int frame = 0; frame < TABLE_FRAMES; ++frame) {
+			for (int i = 0; i < numInputs; ++i) {
+				for (int c = 0; c < channels; ++c) {
+					table[(frame * numInputs + i) * channels + c] = syntheticVoltage(i, c, frame, sampleRate);
+				}
+			}
+		}
+		// as above, setChannels() would leave these unpatched
+		for (Input& input : module->inputs) {
+			input.channels = channels;
+		}
+	}
+
+	/** Copies the input voltages for `frame` into the module's patched input ports */
+	void apply(Module* module, int64_t frame) const {
+		const float* inputFrame = &table[(frame % TABLE_FRAMES) * numInputs * channels];
+		for (int i = 0; i < numInputs; ++i) {
+			// a caller may have unpatched some, whose voltages stay at 0V as in the engine
+			if (!module->inputs[i].isConnected()) {
+				continue;
+			}
+			std::memcpy(module->inputs[i].voltages, &inputFrame[i * channels], channels * sizeof(float));
+		}
+	}
+};
+
+} // namespace benchmark
@@ -0,0 +1,87 @@
+#include "DenormalBenchmark.hpp"
+
+// Denormal stress test: each module runs for a second on the usual synthetic input, then every input drops to 0 V
+// and it runs on in silence while its filters decay, which is when their state would reach the denormal range.
+// process() is timed over windows of the silent run, once with FlushDenormals (which sets FTZ/DAZ on the thread
+// running process()) disabled and the thread's flush-to-zero mode cleared, and once with the mode set, as it runs in
+// Rack. Without the
+// filters' own state snapping, the worst silent window would cost many times what the live input did when the
+// guard is off (see Denormals.hpp).
+//
+// - live: ns per sample over the second of synthetic input
+// - silent mean / worst: ns per sample over the silent run, on average and in its slowest window
+
+namespace benchmark {
+
+static const float STRESS_SAMPLE_RATE = 48000.f;
+static const int LIVE_FRAMES = 48000;
+static const int SILENT_FRAMES = 10 * 48000;
+static const int WINDOW_FRAMES = 4800;
+
+struct StressResult {
+	double liveNsPerSample = 0.;
+	double silentMeanNsPerSample = 0.;
+	double silentWorstNsPerSample = 0.;
+};
+
+static StressResult runStress(Model* model) {
+	Module* module = createModuleAt(model, STRESS_SAMPLE_RATE);
+	const SyntheticInput input(module, 1, STRESS_SAMPLE_RATE);
+
+	Module::ProcessArgs args;
+	args.sampleRate = STRESS_SAMPLE_RATE;
+	args.sampleTime = 1.f / STRESS_SAMPLE_RATE;
+	args.frame = 0;
+
+	StressResult result;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < LIVE_FRAMES; ++i, ++args.frame) {
+		input.apply(module, args.frame);
+		module->process(args);
+	}
+	result.liveNsPerSample = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / LIVE_FRAMES;
+
+	for (Input& port : module->inputs) {
+		std::fill(port.voltages, port.voltages + PORT_MAX_CHANNELS, 0.f);
+	}
+
+	double totalNs = 0.;
+	for (int window = 0; window < SILENT_FRAMES / WINDOW_FRAMES; ++window) {
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < WINDOW_FRAMES; ++i, ++args.frame) {
+			module->process(args);
+		}
+		const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		totalNs += ns;
+		result.silentWorstNsPerSample = std::max(result.silentWorstNsPerSample, ns / WINDOW_FRAMES);
+	}
+	result.silentMeanNsPerSample = totalNs / (SILENT_FRAMES / WINDOW_FRAMES * WINDOW_FRAMES);
+
+	delete module;
+	return result;
+}
+
+int runDenormalBenchmark(Plugin* plugin, const std::string& moduleFilter) {
+	std::printf("module,ftz_daz,live_ns_per_sample,silent_mean_ns_per_sample,silent_worst_ns_per_sample\n");
+	for (Model* model : plugin->models) {
+		if (!moduleFilter.empty() && model->slug != moduleFilter) {
+			continue;
+		}
+		for (bool flushToZero : {false, true}) {
+			// FlushDenormals only sets the mode once per thread, so it is set here for each run, and disabled so that
+			// nothing but the modules' own code stops denormals in the run without it
+			FlushDenormals::enabled.store(false);
+			FlushDenormals::set(flushToZero);
+
+			const StressResult result = runStress(model);
+			std::printf("%s,%d,%.2f,%.2f,%.2f\n", model->slug.c_str(), flushToZero, result.liveNsPerSample,
+			            result.silentMeanNsPerSample, result.silentWorstNsPerSample);
+			std::fflush(stdout);
+		}
+	}
+	FlushDenormals::enabled.store(true);
+	return 0;
+}
+
+} // namespace benchmark
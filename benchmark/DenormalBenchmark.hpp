@@ -0,0 +1,10 @@
+#pragma once
+#include "BenchmarkHarness.hpp"
+
+namespace benchmark {
+
+/** Runs every module (or only `moduleFilter`) on live input and then on silence while its filters decay, with and
+ without flush-to-zero, printing ns per sample for the live input and the silent run as CSV */
+int runDenormalBenchmark(Plugin* plugin, const std::string& moduleFilter);
+
+} // namespace benchmark
@@ -0,0 +1,393 @@
+#include "GoldenRender.hpp"
+#include "../src/noise-plethora/plugins/Banks.hpp"
+#include <fstream>
+#include <sstream>
+
+// Golden-output regression checks: a fixed list of canonical patches is rendered through the
+// modules and compared against reference renders (raw float32, interleaved per frame as
+// output 0 channels 0..N-1, output 1 channels 0..N-1, ...). The CPU time of each render is
+// stored alongside, so a single run shows whether an optimisation changed the sound and how
+// much faster it is.
+//
+// Cases are always rendered in the same order from a freshly seeded random generator, so
+// modules that use random numbers (Burst, the NoisePlethora random walks) are reproducible.
+//
+// A case whose data the module doesn't save back (see supportsCase()) is skipped by a build
+// that predates the setting, so that golden-baseline.sh leaves it to the current build.
+
+namespace benchmark {
+
+static const float GOLDEN_SAMPLE_RATE = 44100.f;
+static const int GOLDEN_FRAMES = 16384;
+
+struct GoldenCase {
+	std::string name;
+	std::string modelSlug;
+	/** parameter overrides, matched by ParamQuantity name */
+	std::vector<std::pair<std::string, float>> params;
+	/** JSON passed to Module::dataFromJson(), e.g. to select an algorithm or oversampling factor */
+	std::string data;
+	/** inputs left unpatched, matched by PortInfo name (every other input gets synthetic input) */
+	std::vector<std::string> unpatched;
+	int channels = 1;
+};
+
+struct GoldenRender {
+	std::vector<float> samples;
+	/** PortInfo names of the outputs, in the order their samples are interleaved */
+	std::vector<std::string> outputNames;
+	double nsPerSample = 0.;
+};
+
+static std::vector<GoldenCase> buildCases(Plugin* plugin) {
+	std::vector<GoldenCase> cases;
+
+	// NoisePlethora's program CV would switch algorithms every few samples. Since the algorithms are built on a
+	// worker thread, when a switch takes effect depends on thread timing, and the render wouldn't be reproducible
+	// (nor would it play the algorithm the case is named after)
+	const std::vector<std::string> plethoraUnpatched = {"Program select A", "Program select B"};
+
+	// every module with default settings, both mono and polyphonic
+	for (Model* model : plugin->models) {
+		for (int channels : {1, 4}) {
+			GoldenCase c;
+			c.name = string::f("%s-default-%dch", model->slug.c_str(), channels);
+			c.modelSlug = model->slug;
+			if (model->slug == "NoisePlethora") {
+				c.unpatched = plethoraUnpatched;
+			}
+			c.channels = channels;
+			cases.push_back(c);
+		}
+	}
+
+	// NoisePlethora: every algorithm in every bank
+	for (int bank = 0; bank < numBanks; ++bank) {
+		for (int program = 0; program < getBankForIndex(bank).getSize(); ++program) {
+			const std::string algorithm = getBankForIndex(bank).getProgramName(program);
+			GoldenCase c;
+			c.name = "NoisePlethora-" + algorithm;
+			c.modelSlug = "NoisePlethora";
+			c.data = string::f("{\"algorithmA\": \"%s\", \"algorithmB\": \"%s\"}", algorithm.c_str(), algorithm.c_str());
+			c.unpatched = plethoraUnpatched;
+			cases.push_back(c);
+		}
+	}
+
+	// NoisePlethora: polyphonic, four voices per section with CV of their own, with each graph engine
+	const char* graphEngines[] = {"int16", "float"};
+	for (int graphEngine = 0; graphEngine < 2; ++graphEngine) {
+		GoldenCase c;
+		c.name = string::f("NoisePlethora-polyphonic-%s", graphEngines[graphEngine]);
+		c.modelSlug = "NoisePlethora";
+		c.data = string::f("{\"polyphonic\": true, \"graphEngine\": %d}", graphEngine);
+		c.unpatched = plethoraUnpatched;
+		c.channels = 4;
+		cases.push_back(c);
+	}
+
+	// PonyVCO: each waveform at each oversampling factor, with some timbre so the folder is active
+	const char* ponyWaves[] = {"sin", "tri", "saw", "pulse"};
+	for (int wave = 0; wave < 4; ++wave) {
+		for (int oversamplingIndex = 0; oversamplingIndex < 4; ++oversamplingIndex) {
+			GoldenCase c;
+			c.name = string::f("PonyVCO-%s-os%d", ponyWaves[wave], 1 << oversamplingIndex);
+			c.modelSlug = "PonyVCO";
+			c.params = {{"Wave", wave}, {"Timbre", 0.6f}};
+			c.data = string::f("{\"oversamplingIndex\": %d}", oversamplingIndex);
+			c.channels = 4;
+			cases.push_back(c);
+		}
+	}
+
+	// ChoppingKinky: both folders driven hard, at each oversampling factor
+	for (int oversamplingIndex = 0; oversamplingIndex < 5; ++oversamplingIndex) {
+		GoldenCase c;
+		c.name = string::f("ChoppingKinky-folders-os%d", 1 << oversamplingIndex);
+		c.modelSlug = "ChoppingKinky";
+		c.params = {{"Gain/shape control for channel A", 1.5f}, {"Gain/shape control for channel B", 1.5f}};
+		c.data = string::f("{\"oversamplingIndex\": %d, \"filterDC\": true}", oversamplingIndex);
+		cases.push_back(c);
+	}
+
+	return cases;
+}
+
+/** Whether the module knows every setting in the case's data, i.e. saves each of them back */
+static bool supportsCase(Module* module, const GoldenCase& c, json_t* dataJ) {
+	json_t* savedJ = module->dataToJson();
+	bool supported = true;
+	const char* key;
+	json_t* value;
+	json_object_foreach(dataJ, key, value) {
+		if (!savedJ || !json_object_get(savedJ, key)) {
+			std::fprintf(stderr, "%s: not supported by this build (no '%s' setting)\n", c.name.c_str(), key);
+			supported = false;
+			break;
+		}
+	}
+	json_decref(savedJ);
+	return supported;
+}
+
+enum RenderResult {
+	RENDERED,
+	UNSUPPORTED,
+	FAILED
+};
+
+static RenderResult renderCase(Plugin* plugin, const GoldenCase& c, GoldenRender& render) {
+	Model* model = findModel(plugin, c.modelSlug);
+	if (!model) {
+		std::fprintf(stderr, "%s: no model with slug %s\n", c.name.c_str(), c.modelSlug.c_str());
+		return FAILED;
+	}
+
+	random::local().seed(0x8badf00d, 0x5eed);
+	Module* module = createModuleAt(model, GOLDEN_SAMPLE_RATE);
+
+	// patched before the settings are loaded, as NoisePlethora builds the algorithms for the patched channels then
+	const SyntheticInput input(module, c.channels, GOLDEN_SAMPLE_RATE);
+	for (const std::string& name : c.unpatched) {
+		bool found = false;
+		for (size_t i = 0; i < module->inputs.size(); ++i) {
+			if (module->inputInfos[i]->name == name) {
+				module->inputs[i].channels = 0;
+				found = true;
+			}
+		}
+		if (!found) {
+			std::fprintf(stderr, "%s: no input named '%s'\n", c.name.c_str(), name.c_str());
+			delete module;
+			return FAILED;
+		}
+	}
+
+	if (!c.data.empty()) {
+		json_error_t error;
+		json_t* dataJ = json_loads(c.data.c_str(), 0, &error);
+		if (!dataJ) {
+			std::fprintf(stderr, "%s: invalid JSON data (%s)\n", c.name.c_str(), error.text);
+			delete module;
+			return FAILED;
+		}
+		module->dataFromJson(dataJ);
+		const bool supported = supportsCase(module, c, dataJ);
+		json_decref(dataJ);
+		if (!supported) {
+			delete module;
+			return UNSUPPORTED;
+		}
+	}
+
+	for (const auto& param : c.params) {
+		bool found = false;
+		for (ParamQuantity* pq : module->paramQuantities) {
+			if (pq->name == param.first) {
+				pq->setValue(param.second);
+				found = true;
+			}
+		}
+		if (!found) {
+			std::fprintf(stderr, "%s: no param named '%s'\n", c.name.c_str(), param.first.c_str());
+			delete module;
+			return FAILED;
+		}
+	}
+
+	const int numOutputs = module->outputs.size();
+	for (int i = 0; i < numOutputs; ++i) {
+		render.outputNames.push_back(module->outputInfos[i]->name);
+	}
+
+	Module::ProcessArgs args;
+	args.sampleRate = GOLDEN_SAMPLE_RATE;
+	args.sampleTime = 1.f / GOLDEN_SAMPLE_RATE;
+
+	render.samples.resize(GOLDEN_FRAMES * numOutputs * c.channels);
+	double ns = 0.;
+	for (int64_t frame = 0; frame < GOLDEN_FRAMES; ++frame) {
+		input.apply(module, frame);
+		args.frame = frame;
+
+		const auto start = std::chrono::steady_clock::now();
+		module->process(args);
+		ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		for (int i = 0; i < numOutputs; ++i) {
+			std::memcpy(&render.samples[(frame * numOutputs + i) * c.channels], module->outputs[i].voltages, c.channels * sizeof(float));
+		}
+	}
+	render.nsPerSample = ns / GOLDEN_FRAMES;
+
+	delete module;
+	return RENDERED;
+}
+
+static std::string goldenPath(const std::string& dir, const GoldenCase& c) {
+	return dir + "/" + c.name + ".f32";
+}
+
+struct ToleranceRow {
+	/** case name, a trailing * matches any suffix */
+	std::string pattern;
+	/** PortInfo name of the one output the row is for, or empty for all of them */
+	std::string output;
+	float volts;
+};
+
+/** Rows of a tolerances file, in file order */
+static bool loadTolerances(const std::string& path, std::vector<ToleranceRow>& tolerances) {
+	std::ifstream file(path);
+	if (!file) {
+		std::fprintf(stderr, "Cannot read %s\n", path.c_str());
+		return false;
+	}
+	std::string line;
+	std::getline(file, line);
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		std::istringstream row(line);
+		std::string name, tolerance, output;
+		if (std::getline(row, name, ',') && std::getline(row, tolerance, ',')) {
+			std::getline(row, output, ',');
+			tolerances.push_back({name, output, (float) std::atof(tolerance.c_str())});
+		}
+	}
+	return true;
+}
+
+/** Index of the first row that matches the case and output (empty for the case as a whole), or -1 */
+static int findTolerance(const std::vector<ToleranceRow>& tolerances, const std::string& name, const std::string& output) {
+	for (size_t i = 0; i < tolerances.size(); ++i) {
+		const std::string& pattern = tolerances[i].pattern;
+		const bool prefix = !pattern.empty() && pattern.back() == '*';
+		const bool nameMatches = prefix ? name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0 : name == pattern;
+		if (nameMatches && (tolerances[i].output.empty() || tolerances[i].output == output)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int renderGolden(Plugin* plugin, const std::string& dir, bool missingOnly) {
+	std::ofstream timings(dir + "/golden.csv", missingOnly ? std::ios::app : std::ios::trunc);
+	if (!timings) {
+		std::fprintf(stderr, "Cannot write to %s\n", dir.c_str());
+		return 1;
+	}
+	if (!missingOnly) {
+		timings << "case,frames,ns_per_sample\n";
+	}
+
+	int failures = 0;
+	for (const GoldenCase& c : buildCases(plugin)) {
+		if (missingOnly && std::ifstream(goldenPath(dir, c))) {
+			continue;
+		}
+
+		GoldenRender render;
+		const RenderResult result = renderCase(plugin, c, render);
+		if (result != RENDERED) {
+			// an unsupported case is left missing, for a newer build to render
+			failures += (result == FAILED);
+			continue;
+		}
+
+		std::ofstream file(goldenPath(dir, c), std::ios::binary);
+		file.write((const char*) render.samples.data(), render.samples.size() * sizeof(float));
+		timings << c.name << "," << GOLDEN_FRAMES << "," << render.nsPerSample << "\n";
+		std::printf("%s,%.3f\n", c.name.c_str(), render.nsPerSample);
+	}
+	return failures ? 1 : 0;
+}
+
+int checkGolden(Plugin* plugin, const std::string& dir, float defaultTolerance, const std::string& tolerancesPath) {
+	std::vector<ToleranceRow> tolerances;
+	if (!tolerancesPath.empty() && !loadTolerances(tolerancesPath, tolerances)) {
+		return 1;
+	}
+
+	// reference CPU cost per case
+	std::map<std::string, double> referenceNs;
+	std::ifstream timings(dir + "/golden.csv");
+	std::string line;
+	std::getline(timings, line);
+	while (std::getline(timings, line)) {
+		std::istringstream row(line);
+		std::string name, frames, ns;
+		if (std::getline(row, name, ',') && std::getline(row, frames, ',') && std::getline(row, ns, ',')) {
+			referenceNs[name] = std::atof(ns.c_str());
+		}
+	}
+
+	std::printf("case,max_abs_error,tolerance,result,ns_per_sample,reference_ns_per_sample,speedup\n");
+	int failures = 0;
+	for (const GoldenCase& c : buildCases(plugin)) {
+		GoldenRender render;
+		if (renderCase(plugin, c, render) != RENDERED) {
+			failures++;
+			continue;
+		}
+
+		std::ifstream file(goldenPath(dir, c), std::ios::binary);
+		std::vector<float> reference(render.samples.size());
+		file.read((char*) reference.data(), reference.size() * sizeof(float));
+		// a short read means the reference is missing, or the module's outputs have changed
+		const bool missing = !file || file.peek() != EOF;
+
+		// outputs that a row of the tolerances file names get a result line of their own, after the case's
+		const int numOutputs = render.outputNames.size();
+		const int caseRow = findTolerance(tolerances, c.name, "");
+		std::vector<int> outputRows(numOutputs);
+		std::vector<float> maxErrors(numOutputs, 0.f);
+		std::vector<bool> passes(numOutputs, !missing);
+		for (int output = 0; output < numOutputs; ++output) {
+			outputRows[output] = findTolerance(tolerances, c.name, render.outputNames[output]);
+		}
+		auto toleranceOf = [&](int row) {
+			return row >= 0 ? tolerances[row].volts : defaultTolerance;
+		};
+		for (size_t i = 0; !missing && i < reference.size(); ++i) {
+			const int output = (i / c.channels) % numOutputs;
+			const float error = std::fabs(render.samples[i] - reference[i]);
+			// NaN never passes, even if the reference was also NaN
+			if (!(error <= toleranceOf(outputRows[output]))) {
+				passes[output] = false;
+			}
+			maxErrors[output] = std::max(maxErrors[output], error);
+		}
+
+		float maxError = 0.f;
+		bool pass = !missing;
+		for (int output = 0; output < numOutputs; ++output) {
+			if (outputRows[output] == caseRow) {
+				maxError = std::max(maxError, maxErrors[output]);
+				pass = pass && passes[output];
+			}
+		}
+		const double referenceNsPerSample = referenceNs.count(c.name) ? referenceNs[c.name] : NAN;
+		std::printf("%s,%g,%g,%s,%.3f,%.3f,%.2f\n", c.name.c_str(), missing ? NAN : maxError, toleranceOf(caseRow), missing ? "missing" : (pass ? "pass" : "FAIL"),
+		            render.nsPerSample, referenceNsPerSample, referenceNsPerSample / render.nsPerSample);
+		if (!pass) {
+			failures++;
+		}
+
+		for (int output = 0; !missing && output < numOutputs; ++output) {
+			if (outputRows[output] != caseRow) {
+				std::printf("%s:%s,%g,%g,%s,,,\n", c.name.c_str(), render.outputNames[output].c_str(), maxErrors[output],
+				            toleranceOf(outputRows[output]), passes[output] ? "pass" : "FAIL");
+				if (!passes[output]) {
+					failures++;
+				}
+			}
+		}
+	}
+
+	std::fprintf(stderr, "%d golden-output mismatches\n", failures);
+	return failures ? 1 : 0;
+}
+
+} // namespace benchmark
@@ -0,0 +1,17 @@
+#pragma once
+#include "BenchmarkHarness.hpp"
+
+namespace benchmark {
+
+/** Renders every canonical patch to `<dir>/<case>.f32`, and records its CPU cost in `<dir>/golden.csv`. With
+ `missingOnly`, only the patches that have no reference yet are rendered (and appended to golden.csv), e.g. cases
+ added since the build that rendered the rest. */
+int renderGolden(Plugin* plugin, const std::string& dir, bool missingOnly = false);
+
+/** Re-renders every canonical patch and compares against the files written by renderGolden(),
+ returns non-zero if any render differs by more than its tolerance (or is missing). The tolerance is `tolerance`
+ volts, unless a row of the CSV file `tolerancesPath` (if not empty) matches the case or one of its outputs, see
+ golden-tolerances.csv */
+int checkGolden(Plugin* plugin, const std::string& dir, float tolerance, const std::string& tolerancesPath = "");
+
+} // namespace benchmark
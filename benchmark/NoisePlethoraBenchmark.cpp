@@ -0,0 +1,95 @@
+#include "NoisePlethoraBenchmark.hpp"
+#include "../src/noise-plethora/plugins/NoisePlethoraPlugin.hpp"
+#include "../src/noise-plethora/plugins/Banks.hpp"
+#include <numeric>
+
+// Cost of Noise Plethora's audio graphs as seen by Rack's engine, which runs every module for a block of samples
+// at a time. The graphs render AUDIO_BLOCK_SAMPLES (128) samples at once, so with engine blocks shorter than that
+// the whole cost lands in some blocks and none in others. Each algorithm is rendered with
+// NoisePlethoraPlugin::processGraph(out, frames) one engine block at a time, and each block is timed:
+//
+// - voices: 1 is a mono section; 32 is A and B in polyphonic mode with 16 channels each, all playing the algorithm
+// - staggered: whether the voices' block boundaries are spread evenly over a graph block, as the module does
+// - mean: ns per sample over the whole run, all voices together
+// - p99: ns per sample of the engine blocks at the 99th percentile, which unlike worst leaves out the odd block
+//   slowed down by the OS, so shows how the graphs' cost is spread
+// - worst: ns per sample of the slowest engine block, the figure that decides whether the audio drops out
+// - bytes_per_voice: size of one instance, which the polyphonic mode holds for every channel of A and B
+//
+// Staggering only helps engine blocks shorter than a graph block: an engine block of 128 samples or more contains
+// a block boundary of every voice wherever they are, so all the voices render in it.
+
+namespace benchmark {
+
+static const int engineBlockSizes[] = {16, 32, 64, 128, 256};
+static const char* engineNames[NUM_GRAPH_ENGINES] = {"int16", "float"};
+
+static const int MAX_VOICES = 2 * PORT_MAX_CHANNELS;
+
+static volatile float resultSink;
+
+static void timeVoices(AlgorithmId id, GraphEngine engine, int blockSize, int numVoices, bool staggered, int frames) {
+	random::local().seed(0x8badf00d, 0x5eed);
+	std::unique_ptr<NoisePlethoraPlugin> voices[MAX_VOICES];
+	for (int v = 0; v < numVoices; ++v) {
+		voices[v] = createAlgorithm(id, engine);
+		if (!voices[v]) {
+			return;
+		}
+		voices[v]->init();
+		if (staggered) {
+			voices[v]->setBlockPosition(v * AUDIO_BLOCK_SAMPLES / numVoices);
+		}
+	}
+
+	float out[256];
+	const int numBlocks = std::max(1, frames / blockSize);
+	std::vector<double> blockNs(numBlocks);
+	for (int b = 0; b < numBlocks; ++b) {
+		// the module updates the algorithms' parameters about once per graph block
+		const int frame = b * blockSize;
+		if (frame % AUDIO_BLOCK_SAMPLES < blockSize) {
+			for (int v = 0; v < numVoices; ++v) {
+				voices[v]->process(0.5f + 0.4f * std::sin(frame * 1e-4f), 0.5f);
+			}
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int v = 0; v < numVoices; ++v) {
+			voices[v]->processGraph(out, blockSize);
+		}
+		blockNs[b] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		resultSink = out[blockSize - 1];
+	}
+
+	const double totalNs = std::accumulate(blockNs.begin(), blockNs.end(), 0.);
+	const double worstNs = *std::max_element(blockNs.begin(), blockNs.end());
+	std::nth_element(blockNs.begin(), blockNs.begin() + numBlocks * 99 / 100, blockNs.end());
+	const double p99Ns = blockNs[numBlocks * 99 / 100];
+
+	std::printf("%s,%s,%d,%d,%s,%.2f,%.2f,%.2f,%zu\n", getAlgorithmName(id), engineNames[engine], blockSize, numVoices,
+	            staggered ? "yes" : "no", totalNs / (numBlocks * blockSize), p99Ns / blockSize, worstNs / blockSize,
+	            getAlgorithmSize(id, engine));
+	std::fflush(stdout);
+}
+
+int runNoisePlethoraGraphBenchmark(int frames) {
+	std::printf("algorithm,engine,engine_block,voices,staggered,mean_ns_per_sample,p99_ns_per_sample,worst_ns_per_sample,bytes_per_voice\n");
+
+	for (int bank = 0; bank < numBanks; ++bank) {
+		for (int program = 0; program < getBankForIndex(bank).getSize(); ++program) {
+			const AlgorithmId id = getBankForIndex(bank).getProgramId(program);
+
+			for (int engine = 0; engine < NUM_GRAPH_ENGINES; ++engine) {
+				for (int blockSize : engineBlockSizes) {
+					timeVoices(id, (GraphEngine) engine, blockSize, 1, false, frames);
+					timeVoices(id, (GraphEngine) engine, blockSize, MAX_VOICES, false, frames);
+					timeVoices(id, (GraphEngine) engine, blockSize, MAX_VOICES, true, frames);
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+} // namespace benchmark
@@ -0,0 +1,11 @@
+#pragma once
+#include "BenchmarkHarness.hpp"
+
+namespace benchmark {
+
+/** Renders every Noise Plethora algorithm's graph, with each engine, in chunks the length of a Rack engine block,
+ for one voice and for every channel of A and B, printing the mean, 99th percentile and worst-case ns per sample of
+ the chunks, and the size of an instance, as CSV */
+int runNoisePlethoraGraphBenchmark(int frames);
+
+} // namespace benchmark
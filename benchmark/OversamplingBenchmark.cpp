@@ -0,0 +1,183 @@
+#include "OversamplingBenchmark.hpp"
+#include "../src/ChowDSP.hpp"
+
+// Oversampler comparison, independent of any module. The filters under test are the ones the modules use:
+// chowdsp::Oversampling<ratio, 6> (12th order Butterworth, as in PonyVCO and ChoppingKinky) along with its
+// Chebyshev II and elliptic versions, chowdsp::PolyphaseOversampling<ratio> and chowdsp::FIROversampling<ratio>.
+//
+// - CPU: ns per base rate sample for one upsample() + downsample(), mono float and 4 lane float_4, and for
+//   processBlock() over blocks of MAX_BLOCK_FRAMES mono samples
+// - passband: gain of upsample() followed by downsample() for a tone at 0.1 * fs
+// - alias rejection: a tone at 0.6 * fs written straight into the oversampled buffer, which downsample() would
+//   fold back to 0.4 * fs, measured relative to the input level
+// - image rejection: after upsample() of a tone at 0.1 * fs, the level of its image at 0.9 * fs relative to the tone
+
+namespace benchmark {
+
+static const float OS_SAMPLE_RATE = 48000.f;
+// skip the filters' start-up transient
+static const int SETTLE_FRAMES = 4096;
+
+// magnitude of the component of `x` at normalised frequency `f` (Goertzel / single DFT bin)
+struct ToneDetector {
+	double re = 0., im = 0.;
+	void add(double f, int64_t n, float x) {
+		re += x * std::cos(2. * M_PI * f * n);
+		im += x * std::sin(2. * M_PI * f * n);
+	}
+	double power() const {
+		return re * re + im * im;
+	}
+};
+
+static double toDb(double powerRatio) {
+	return 10. * std::log10(powerRatio);
+}
+
+template <class TOversampling>
+static double passbandGainDb(int frames) {
+	TOversampling os;
+	os.reset(OS_SAMPLE_RATE);
+	double inPower = 0., outPower = 0.;
+	for (int n = 0; n < frames; ++n) {
+		const float x = std::sin(2. * M_PI * 0.1 * n);
+		os.upsample(x);
+		const float y = os.downsample();
+		if (n >= SETTLE_FRAMES) {
+			inPower += x * x;
+			outPower += y * y;
+		}
+	}
+	return toDb(outPower / inPower);
+}
+
+template <class TOversampling, int ratio>
+static double aliasRejectionDb(int frames) {
+	TOversampling os;
+	os.reset(OS_SAMPLE_RATE);
+	double inPower = 0., outPower = 0.;
+	int64_t k = 0;
+	for (int n = 0; n < frames; ++n) {
+		float* osBuffer = os.getOSBuffer();
+		for (int i = 0; i < ratio; ++i, ++k) {
+			osBuffer[i] = std::sin(2. * M_PI * 0.6 * k / ratio);
+		}
+		const float y = os.downsample();
+		if (n >= SETTLE_FRAMES) {
+			inPower += 0.5;
+			outPower += y * y;
+		}
+	}
+	return toDb(outPower / inPower);
+}
+
+template <class TOversampling, int ratio>
+static double imageRejectionDb(int frames) {
+	TOversampling os;
+	os.reset(OS_SAMPLE_RATE);
+	ToneDetector tone, image;
+	int64_t k = 0;
+	for (int n = 0; n < frames; ++n) {
+		os.upsample(std::sin(2. * M_PI * 0.1 * n));
+		const float* osBuffer = os.getOSBuffer();
+		for (int i = 0; i < ratio; ++i, ++k) {
+			if (n >= SETTLE_FRAMES) {
+				tone.add(0.1 / ratio, k, osBuffer[i]);
+				image.add(0.9 / ratio, k, osBuffer[i]);
+			}
+		}
+	}
+	return toDb(image.power() / tone.power());
+}
+
+static volatile float resultSink;
+
+template <class TOversampling, typename T>
+static double nsPerSample(int frames) {
+	TOversampling os;
+	os.reset(OS_SAMPLE_RATE);
+	// inputs are independent of the outputs, so this measures throughput rather than latency
+	T sum = 0.f;
+	const auto start = std::chrono::steady_clock::now();
+	for (int n = 0; n < frames; ++n) {
+		os.upsample(T((n & 63) * 0.01f));
+		sum += os.downsample();
+	}
+	const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	// keep the result alive
+	float lanes[sizeof(T) / sizeof(float)];
+	std::memcpy(lanes, &sum, sizeof(T));
+	resultSink = lanes[0];
+	return ns / frames;
+}
+
+// does nothing to the oversampled samples, so only the oversampler itself is timed
+struct Passthrough {
+	void operator()(float* /*osBlock*/, int /*osFrames*/) const {}
+};
+
+template <class TOversampling>
+static double nsPerSampleBlock(int frames) {
+	static const int BLOCK_FRAMES = TOversampling::MAX_BLOCK_FRAMES;
+	TOversampling os;
+	os.reset(OS_SAMPLE_RATE);
+	float in[BLOCK_FRAMES], out[BLOCK_FRAMES];
+	for (int n = 0; n < BLOCK_FRAMES; ++n) {
+		in[n] = (n & 63) * 0.01f;
+	}
+	float sum = 0.f;
+	const auto start = std::chrono::steady_clock::now();
+	for (int n = 0; n + BLOCK_FRAMES <= frames; n += BLOCK_FRAMES) {
+		os.processBlock(in, out, BLOCK_FRAMES, Passthrough());
+		sum += out[BLOCK_FRAMES - 1];
+	}
+	const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	resultSink = sum;
+	return ns / (frames - frames % BLOCK_FRAMES);
+}
+
+template <int ratio, template <int, typename> class TOversampling>
+static void compare(const char* name, int frames) {
+	using Mono = TOversampling<ratio, float>;
+	using Simd = TOversampling<ratio, simd::float_4>;
+
+	std::printf("%s,%d,%.2f,%.2f,%.2f,%.6f,%.1f,%.1f\n", name, ratio, nsPerSample<Mono, float>(frames),
+	            nsPerSample<Simd, simd::float_4>(frames), nsPerSampleBlock<Mono>(frames), passbandGainDb<Mono>(frames),
+	            aliasRejectionDb<Mono, ratio>(frames), imageRejectionDb<Mono, ratio>(frames));
+	std::fflush(stdout);
+}
+
+// blocks as long as the modules' (BlockProcessor::MAX_BLOCK_SIZE) for processBlock()
+static const int OS_BLOCK_FRAMES = 32;
+
+template <int ratio, typename T>
+using Butterworth = chowdsp::Oversampling<ratio, 6, T, chowdsp::BUTTERWORTH, OS_BLOCK_FRAMES>;
+template <int ratio, typename T>
+using ChebyshevII = chowdsp::Oversampling<ratio, 6, T, chowdsp::CHEBYSHEV_II, OS_BLOCK_FRAMES>;
+template <int ratio, typename T>
+using Elliptic = chowdsp::Oversampling<ratio, 6, T, chowdsp::ELLIPTIC, OS_BLOCK_FRAMES>;
+template <int ratio, typename T>
+using Polyphase = chowdsp::PolyphaseOversampling<ratio, T, OS_BLOCK_FRAMES>;
+template <int ratio, typename T>
+using FIR = chowdsp::FIROversampling<ratio, T, OS_BLOCK_FRAMES>;
+
+template <int ratio>
+static void compareAt(int frames) {
+	compare<ratio, Butterworth>("iir", frames);
+	compare<ratio, ChebyshevII>("chebyshev_ii", frames);
+	compare<ratio, Elliptic>("elliptic", frames);
+	compare<ratio, Polyphase>("polyphase", frames);
+	compare<ratio, FIR>("fir", frames);
+}
+
+int runOversamplingBenchmark(int frames) {
+	frames = std::max(frames, 2 * SETTLE_FRAMES);
+	std::printf("filter,ratio,ns_per_sample,ns_per_sample_float_4,ns_per_sample_block,passband_db,alias_rejection_db,image_rejection_db\n");
+	compareAt<2>(frames);
+	compareAt<4>(frames);
+	compareAt<8>(frames);
+	compareAt<16>(frames);
+	return 0;
+}
+
+} // namespace benchmark
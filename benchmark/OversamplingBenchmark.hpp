@@ -0,0 +1,11 @@
+#pragma once
+#include "BenchmarkHarness.hpp"
+
+namespace benchmark {
+
+/** Compares the IIR (Butterworth, Chebyshev II and elliptic cascades), polyphase half-band and linear phase FIR
+ oversamplers at 2x, 4x, 8x and 16x, printing CPU cost per base rate sample (one sample at a time and in blocks) along with passband gain, alias rejection
+ and image rejection as CSV */
+int runOversamplingBenchmark(int frames);
+
+} // namespace benchmark
@@ -0,0 +1,48 @@
+#!/bin/sh
+# Renders golden references from the baseline DSP and checks the working tree against them.
+#
+#   RACK_DIR=/path/to/Rack-SDK benchmark/golden-baseline.sh [DIR]
+#
+# The references (and the reference CPU timings in DIR/golden.csv) come from BASELINE, by default the commit that
+# added the golden check, whose modules are the unoptimised originals. It is checked out into a temporary git
+# worktree and built there, with the working tree's golden-output cases. Cases that need settings added since then
+# (e.g. Noise Plethora's polyphonic mode) have no baseline render, so they are rendered by the working tree's build
+# instead: they only guard later changes. The working tree is then checked against DIR with the per-case tolerances
+# in benchmark/golden-tolerances.csv, and the script exits with the check's status.
+#
+# DIR defaults to golden/ (ignored by git). Run it again to re-check without re-rendering: existing references are
+# kept unless DIR is removed first.
+
+set -e
+
+BASELINE=${BASELINE:-cf359c0}
+ROOT=$(git rev-parse --show-toplevel)
+DIR=${1:-$ROOT/golden}
+: "${RACK_DIR:?set RACK_DIR to the Rack SDK}"
+RACK_DIR=$(cd "$RACK_DIR" && pwd)
+JOBS=${JOBS:-$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 4)}
+
+mkdir -p "$DIR"
+DIR=$(cd "$DIR" && pwd)
+
+if [ ! -f "$DIR/golden.csv" ]; then
+	WORKTREE=$(mktemp -d)
+	trap 'git -C "$ROOT" worktree remove --force "$WORKTREE"' EXIT
+	git -C "$ROOT" worktree add --detach "$WORKTREE" "$BASELINE"
+	# the harness and the cases (how ports are patched, which sample rate the engine reports, which inputs are left
+	# unpatched) have been fixed since the baseline, and both sides must be driven the same way for the comparison
+	# to mean anything. Cases the baseline's modules have no setting for are skipped, and rendered below
+	for file in BenchmarkHarness.hpp GoldenRender.hpp GoldenRender.cpp; do
+		cp "$ROOT/benchmark/$file" "$WORKTREE/benchmark/$file"
+	done
+	make -C "$WORKTREE" RACK_DIR="$RACK_DIR" -j"$JOBS" benchmark
+	# from the plugin directory, so that assets such as the Spring Reverb IR are found
+	# the baseline's Noise Plethora graphs read some state they never initialise, which on the Teensy is zeroed as
+	# every audio object is a global. glibc fills new allocations with MALLOC_PERTURB_ ^ 0xff, i.e. zeroes here
+	(cd "$WORKTREE" && MALLOC_PERTURB_=255 build/benchmark/befaco-benchmark --render-golden "$DIR")
+fi
+
+make -C "$ROOT" RACK_DIR="$RACK_DIR" -j"$JOBS" benchmark
+cd "$ROOT"
+build/benchmark/befaco-benchmark --render-golden "$DIR" --missing-only
+build/benchmark/befaco-benchmark --check-golden "$DIR" --tolerances benchmark/golden-tolerances.csv
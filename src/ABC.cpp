@@ -156,4 +156,4 @@ struct ABCWidget : ModuleWidget {
 };
 
 
-Model* modelABC = createModel<ABC, ABCWidget>("ABC");
+Model* modelABC = createModelWithTelemetry<ABC, ABCWidget>("ABC");
@@ -340,4 +340,4 @@ struct ADSRWidget : ModuleWidget {
 };
 
 
-Model* modelADSR = createModel<ADSR, ADSRWidget>("ADSR");
\ No newline at end of file
+Model* modelADSR = createModelWithTelemetry<ADSR, ADSRWidget>("ADSR");
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "plugin.hpp"
+
+// Audio-thread audit hooks, only built with `make AUDIT=1` (see audit::ProcessScope in plugin.hpp).
+//
+// This file replaces the global operator new/delete and pthread_mutex_lock (forwarding to the real one). In an
+// executable (the benchmark tool) the replacements see every call in the process, including allocations made
+// inside libstdc++ on the plugin's behalf. Loaded into Rack, the plugin is linked with -Bsymbolic-functions so
+// that at least its own calls (inlined std::vector / std::shared_ptr / std::mutex code and so on) reach them.
+
+#ifdef BEFACO_AUDIT_AUDIO_THREAD
+
+#include <execinfo.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace audit {
+
+// module whose process() is running on this thread, if any
+static thread_local const Module* currentModule = nullptr;
+// set while reporting, as the report itself may allocate
+static thread_local bool reporting = false;
+
+static std::atomic<int> numViolations{0};
+
+// (model, kind) pairs already reported with a stack trace, so a module allocating every sample prints once
+static const int MAX_REPORTED = 256;
+static std::atomic<const Model*> reportedModels[NUM_VIOLATIONS][MAX_REPORTED];
+
+static const char* violationNames[NUM_VIOLATIONS] = {"heap allocation", "heap free", "mutex lock"};
+
+static bool claimReport(Violation kind, const Model* model) {
+	for (int i = 0; i < MAX_REPORTED; ++i) {
+		const Model* expected = nullptr;
+		if (reportedModels[kind][i].compare_exchange_strong(expected, model)) {
+			return true;
+		}
+		if (expected == model) {
+			return false;
+		}
+	}
+	return false;
+}
+
+static void report(Violation kind, size_t size) {
+	const Module* module = currentModule;
+	if (!module || reporting) {
+		return;
+	}
+	reporting = true;
+	numViolations++;
+
+	const Model* model = module->model;
+	if (claimReport(kind, model)) {
+		// backtrace_symbols_fd() writes straight to the fd without allocating
+		void* frames[64];
+		const int numFrames = backtrace(frames, 64);
+		std::fprintf(stderr, "[audit] %s (%zu bytes) on the audio thread in %s process()\n", violationNames[kind], size,
+		             model ? model->slug.c_str() : "unknown module");
+		std::fflush(stderr);
+		backtrace_symbols_fd(frames, numFrames, STDERR_FILENO);
+	}
+	reporting = false;
+}
+
+ProcessScope::ProcessScope(const Module* module) : previous(currentModule) {
+	currentModule = module;
+}
+
+ProcessScope::~ProcessScope() {
+	currentModule = previous;
+}
+
+int getNumViolations() {
+	return numViolations.load();
+}
+
+} // namespace audit
+
+namespace audit {
+
+static void* allocate(size_t size, size_t alignment) {
+	report(ALLOCATION, size);
+	if (alignment <= alignof(std::max_align_t)) {
+		return std::malloc(size);
+	}
+	void* p = nullptr;
+	return (posix_memalign(&p, alignment, size) == 0) ? p : nullptr;
+}
+
+static void deallocate(void* p) {
+	if (p) {
+		report(DEALLOCATION, 0);
+	}
+	std::free(p);
+}
+
+} // namespace audit
+
+// every form of the global operators is replaced, so that e.g. nothrow or over-aligned (alignas, simd::float_4)
+// allocations are reported as well
+
+void* operator new(size_t size) {
+	void* p = audit::allocate(size, 0);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return audit::allocate(size, 0);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return audit::allocate(size, 0);
+}
+
+void operator delete(void* p) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete(void* p, size_t size) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete[](void* p, size_t size) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	audit::deallocate(p);
+}
+
+#ifdef __cpp_aligned_new
+void* operator new(size_t size, std::align_val_t alignment) {
+	void* p = audit::allocate(size, (size_t) alignment);
+	if (!p) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+	return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return audit::allocate(size, (size_t) alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return audit::allocate(size, (size_t) alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete(void* p, size_t size, std::align_val_t) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete[](void* p, size_t size, std::align_val_t) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	audit::deallocate(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+	audit::deallocate(p);
+}
+#endif
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) {
+	using LockFunction = int (*)(pthread_mutex_t*);
+	// looked up without a guarded static, whose guard could itself lock a mutex; racing threads store the same value
+	static std::atomic<LockFunction> realLock{nullptr};
+	if (!realLock.load(std::memory_order_relaxed)) {
+		realLock.store((LockFunction) dlsym(RTLD_NEXT, "pthread_mutex_lock"), std::memory_order_relaxed);
+	}
+	audit::report(audit::MUTEX_LOCK, 0);
+	return realLock.load(std::memory_order_relaxed)(mutex);
+}
+
+#endif // BEFACO_AUDIT_AUDIO_THREAD
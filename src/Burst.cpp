@@ -345,5 +345,5 @@ struct BurstWidget : ModuleWidget {
 };
 
 
-Model* modelBurst = createModel<Burst, BurstWidget>("Burst");
+Model* modelBurst = createModelWithTelemetry<Burst, BurstWidget>("Burst");
 
@@ -39,16 +39,66 @@ struct ChoppingKinky : Module {
 	};
 
 	static const int WAVESHAPE_CACHE_SIZE = 256;
-	float waveshapeA[WAVESHAPE_CACHE_SIZE + 1] = {};
-	float waveshapeBPositive[WAVESHAPE_CACHE_SIZE + 1] = {};
-	float waveshapeBNegative[WAVESHAPE_CACHE_SIZE + 1] = {};
+	struct WaveshaperTables {
+		float a[WAVESHAPE_CACHE_SIZE + 1] = {};
+		float bPositive[WAVESHAPE_CACHE_SIZE + 1] = {};
+		float bNegative[WAVESHAPE_CACHE_SIZE + 1] = {};
+	};
+	// the same for every instance, so shared between them
+	std::shared_ptr<const WaveshaperTables> waveshapers;
 
 	dsp::SchmittTrigger trigger;
 	bool outputAToChopp = false;
 	float previousA = 0.0;
 
-	chowdsp::VariableOversampling<6> oversampler[NUM_CHANNELS]; 	// uses a 2*6=12th order Butterworth filter
+	static const int MAX_BLOCK_SIZE = BlockProcessor<NUM_INPUTS, NUM_OUTPUTS>::MAX_BLOCK_SIZE;
+	// a whole block is oversampled at once, so the oversamplers' buffers hold MAX_BLOCK_SIZE frames
+	using Oversampler = chowdsp::VariableOversampling<6, float, MAX_BLOCK_SIZE>;
+	Oversampler oversampler[NUM_CHANNELS]; 	// uses a 2*6=12th order Butterworth filter (or polyphase half-band)
+	using FilterType = Oversampler::FilterType;
+	FilterType antialiasingFilter = Oversampler::IIR_BUTTERWORTH;
 	int oversamplingIndex = 2; 	// default is 2^oversamplingIndex == x4 oversampling
+	// the ratio follows the input's level and frequency, up to oversamplingIndex
+	bool adaptiveOversampling = false;
+	// set by the context menu, the oversamplers are rebuilt at the start of the next processBlock() call
+	std::atomic<bool> oversamplingChanged{false};
+
+	BlockProcessor<NUM_INPUTS, NUM_OUTPUTS> block;
+
+	// frames between updates of the adaptive oversampling ratio, rounded up to whole blocks
+	static const int ADAPT_INTERVAL = 32;
+	int framesSinceAdapt = 0;
+
+	// tracks the level and mean frequency of a folder's input, for the adaptive oversampling bandwidth estimate
+	struct InputAnalyser {
+		float power = 0.f;
+		float slopePower = 0.f;
+		float peak = 0.f;
+		float previous = 0.f;
+
+		void process(float x, float smoothing, float peakDecay) {
+			const float slope = x - previous;
+			previous = x;
+			power += smoothing * (x * x - power);
+			slopePower += smoothing * (slope * slope - slopePower);
+			peak = std::max(std::abs(x), peak * peakDecay);
+		}
+
+		// the folders' harmonics (down to about -40 dB) reach to roughly 5 + 10 * the peak voltage times the
+		// input's mean frequency, which for a sine is acos(1 - slopePower / (2 * power)) radians per sample
+		float bandwidth(float sampleRate) const {
+			if (power < 1e-6f) {
+				return 0.f;
+			}
+			const float omega = std::acos(clamp(1.f - 0.5f * slopePower / power, -1.f, 1.f));
+			return (5.f + 10.f * peak) * omega * sampleRate / (2.f * M_PI);
+		}
+	};
+	InputAnalyser analyser[2]; 	// channels A and B
+
+	int getOversamplingRatio() {
+		return oversampler[0].getOversamplingRatio();
+	}
 
 	DCBlocker blockDCFilter;
 	bool blockDC = false;
@@ -86,102 +136,198 @@ struct ChoppingKinky : Module {
 		blockDCFilter.setFrequency(22.05 / sampleRate);
 
 		for (int channel_idx = 0; channel_idx < NUM_CHANNELS; channel_idx++) {
+			oversampler[channel_idx].setAdaptive(adaptiveOversampling);
 			oversampler[channel_idx].setOversamplingIndex(oversamplingIndex);
+			oversampler[channel_idx].setFilterType(antialiasingFilter);
 			oversampler[channel_idx].reset(sampleRate);
 		}
 	}
 
 	void process(const ProcessArgs& args) override {
+		block.process(this, args);
+	}
 
-		float gainA = params[FOLD_A_PARAM].getValue();
-		gainA += params[CV_A_PARAM].getValue() * inputs[CV_A_INPUT].getVoltage() / 10.f;
-		gainA += inputs[VCA_CV_A_INPUT].getVoltage() / 10.f;
-		gainA = std::max(gainA, 0.f);
-
-		// CV_B_INPUT is normalled to CV_A_INPUT (input with attenuverter)
-		float gainB = params[FOLD_B_PARAM].getValue();
-		gainB += params[CV_B_PARAM].getValue() * inputs[CV_B_INPUT].getNormalVoltage(inputs[CV_A_INPUT].getVoltage()) / 10.f;
-		gainB += inputs[VCA_CV_B_INPUT].getVoltage() / 10.f;
-		gainB = std::max(gainB, 0.f);
-
-		const float inA = inputs[IN_A_INPUT].getVoltageSum();
-		const float inB = inputs[IN_B_INPUT].getNormalVoltage(inputs[IN_A_INPUT].getVoltageSum());
+	void processBlock(const ProcessArgs& args, const int frames) {
 
-		// if the CHOPP gate is wired in, do chop logic
-		if (inputs[IN_GATE_INPUT].isConnected()) {
-			// TODO: check rescale?
-			trigger.process(rescale(inputs[IN_GATE_INPUT].getVoltageSum(), 0.1f, 2.f, 0.f, 1.f));
-			outputAToChopp = trigger.isHigh();
-		}
-		// else zero-crossing detector on input A switches between A and B
-		else {
-			if (previousA > 0 && inA < 0) {
-				outputAToChopp = false;
-			}
-			else if (previousA < 0 && inA > 0) {
-				outputAToChopp = true;
-			}
+		if (oversamplingChanged.exchange(false)) {
+			onSampleRateChange();
 		}
-		previousA = inA;
+
+		// params and connections are only read once per block
+		const float foldA = params[FOLD_A_PARAM].getValue();
+		const float cvA = params[CV_A_PARAM].getValue();
+		const float foldB = params[FOLD_B_PARAM].getValue();
+		const float cvB = params[CV_B_PARAM].getValue();
+		const bool gateConnected = block.isConnected(IN_GATE_INPUT);
 
 		const bool choppIsRequired = outputs[OUT_CHOPP_OUTPUT].isConnected();
 		const bool aIsRequired = outputs[OUT_A_OUTPUT].isConnected() || choppIsRequired;
 		const bool bIsRequired = outputs[OUT_B_OUTPUT].isConnected() || choppIsRequired;
 
-		if (aIsRequired) {
-			oversampler[CHANNEL_A].upsample(inA * gainA);
+		OversampledBlock oversampledBlock;
+		oversampledBlock.module = this;
+		oversampledBlock.frames = frames;
+		oversampledBlock.isRequired[CHANNEL_A] = aIsRequired;
+		oversampledBlock.isRequired[CHANNEL_B] = bIsRequired;
+		oversampledBlock.isRequired[CHANNEL_CHOPP] = choppIsRequired;
+
+		for (int frame = 0; frame < frames; ++frame) {
+			const float cvAVoltage = block.getVoltage(CV_A_INPUT, frame);
+
+			float gainA = foldA;
+			gainA += cvA * cvAVoltage / 10.f;
+			gainA += block.getVoltage(VCA_CV_A_INPUT, frame) / 10.f;
+			gainA = std::max(gainA, 0.f);
+
+			// CV_B_INPUT is normalled to CV_A_INPUT (input with attenuverter)
+			float gainB = foldB;
+			gainB += cvB * block.getNormalVoltage(CV_B_INPUT, frame, cvAVoltage) / 10.f;
+			gainB += block.getVoltage(VCA_CV_B_INPUT, frame) / 10.f;
+			gainB = std::max(gainB, 0.f);
+
+			const float inA = block.getVoltageSum(IN_A_INPUT, frame);
+			const float inB = block.getNormalVoltage(IN_B_INPUT, frame, inA);
+
+			// if the CHOPP gate is wired in, do chop logic
+			if (gateConnected) {
+				// TODO: check rescale?
+				trigger.process(rescale(block.getVoltageSum(IN_GATE_INPUT, frame), 0.1f, 2.f, 0.f, 1.f));
+				outputAToChopp = trigger.isHigh();
+			}
+			// else zero-crossing detector on input A switches between A and B
+			else {
+				if (previousA > 0 && inA < 0) {
+					outputAToChopp = false;
+				}
+				else if (previousA < 0 && inA > 0) {
+					outputAToChopp = true;
+				}
+			}
+			previousA = inA;
+
+			oversampledBlock.in[CHANNEL_A][frame] = inA * gainA;
+			oversampledBlock.in[CHANNEL_B][frame] = inB * gainB;
+			oversampledBlock.in[CHANNEL_CHOPP][frame] = outputAToChopp ? 1.f : 0.f;
 		}
-		if (bIsRequired) {
-			oversampler[CHANNEL_B].upsample(inB * gainB);
+
+		// all channels share the same oversampling settings
+		oversampler[0].dispatch(oversampledBlock);
+
+		if (adaptiveOversampling) {
+			adaptOversampling(args, oversampledBlock);
 		}
-		if (choppIsRequired) {
-			oversampler[CHANNEL_CHOPP].upsample(outputAToChopp ? 1.f : 0.f);
+
+		for (int frame = 0; frame < frames; ++frame) {
+			float outChopp = oversampledBlock.out[CHANNEL_CHOPP][frame];
+			if (blockDC) {
+				outChopp = blockDCFilter.process(outChopp);
+			}
+
+			block.setVoltage(OUT_A_OUTPUT, frame, oversampledBlock.out[CHANNEL_A][frame]);
+			block.setVoltage(OUT_B_OUTPUT, frame, oversampledBlock.out[CHANNEL_B][frame]);
+			block.setVoltage(OUT_CHOPP_OUTPUT, frame, outChopp);
 		}
 
-		float* osBufferA = oversampler[CHANNEL_A].getOSBuffer();
-		float* osBufferB = oversampler[CHANNEL_B].getOSBuffer();
-		float* osBufferChopp = oversampler[CHANNEL_CHOPP].getOSBuffer();
+		if (gateConnected) {
+			lights[LED_A_LIGHT].setSmoothBrightness((float) outputAToChopp, args.sampleTime * frames);
+			lights[LED_B_LIGHT].setSmoothBrightness((float)(!outputAToChopp), args.sampleTime * frames);
+		}
+		else {
+			lights[LED_A_LIGHT].setBrightness(0.f);
+			lights[LED_B_LIGHT].setBrightness(0.f);
+		}
+	}
 
-		for (int i = 0; i < oversampler[0].getOversamplingRatio(); i++) {
-			if (aIsRequired) {
-				//osBufferA[i] = wavefolderAResponse(osBufferA[i]);
-				osBufferA[i] = wavefolderAResponseCached(osBufferA[i]);
+	// a block through the oversampled wavefolders, with the oversampling ratio and filters fixed at compile time
+	struct OversampledBlock {
+		ChoppingKinky* module;
+		int frames;
+		float in[NUM_CHANNELS][MAX_BLOCK_SIZE];
+		bool isRequired[NUM_CHANNELS];
+		float out[NUM_CHANNELS][MAX_BLOCK_SIZE];
+
+		template <int ratio, Oversampler::FilterType type>
+		void run() {
+			auto& osA = module->oversampler[CHANNEL_A].get<ratio, type>();
+			auto& osB = module->oversampler[CHANNEL_B].get<ratio, type>();
+			auto& osChopp = module->oversampler[CHANNEL_CHOPP].get<ratio, type>();
+			const int osFrames = frames * ratio;
+
+			// each stage runs over the whole oversampled block before the next
+			if (isRequired[CHANNEL_A]) {
+				osA.upsampleBlock(in[CHANNEL_A], frames);
+				for (int i = 0; i < osFrames; i++) {
+					//osA.osBuffer[i] = wavefolderAResponse(osA.osBuffer[i]);
+					osA.osBuffer[i] = module->wavefolderAResponseCached(osA.osBuffer[i]);
+				}
 			}
-			if (bIsRequired) {
-				//osBufferB[i] = wavefolderBResponse(osBufferB[i]);
-				osBufferB[i] = wavefolderBResponseCached(osBufferB[i]);
+			if (isRequired[CHANNEL_B]) {
+				osB.upsampleBlock(in[CHANNEL_B], frames);
+				for (int i = 0; i < osFrames; i++) {
+					//osB.osBuffer[i] = wavefolderBResponse(osB.osBuffer[i]);
+					osB.osBuffer[i] = module->wavefolderBResponseCached(osB.osBuffer[i]);
+				}
 			}
-			if (choppIsRequired) {
-				osBufferChopp[i] = osBufferChopp[i] * osBufferA[i] + (1.f - osBufferChopp[i]) * osBufferB[i];
+			if (isRequired[CHANNEL_CHOPP]) {
+				osChopp.upsampleBlock(in[CHANNEL_CHOPP], frames);
+				for (int i = 0; i < osFrames; i++) {
+					osChopp.osBuffer[i] = osChopp.osBuffer[i] * osA.osBuffer[i] + (1.f - osChopp.osBuffer[i]) * osB.osBuffer[i];
+				}
 			}
+
+			downsample(osA, CHANNEL_A);
+			downsample(osB, CHANNEL_B);
+			downsample(osChopp, CHANNEL_CHOPP);
 		}
 
-		float outA = aIsRequired ? oversampler[CHANNEL_A].downsample() : 0.f;
-		float outB = bIsRequired ? oversampler[CHANNEL_B].downsample() : 0.f;
-		float outChopp = choppIsRequired ? oversampler[CHANNEL_CHOPP].downsample() : 0.f;
+		template <class TOversampling>
+		void downsample(TOversampling& os, int channel) {
+			if (isRequired[channel]) {
+				os.downsampleBlock(out[channel], frames);
+			}
+			else {
+				std::fill(out[channel], &out[channel][frames], 0.f);
+			}
+		}
+	};
 
-		if (blockDC) {
-			outChopp = blockDCFilter.process(outChopp);
+	void adaptOversampling(const ProcessArgs& args, const OversampledBlock& oversampledBlock) {
+		const int frames = oversampledBlock.frames;
+		for (int frame = 0; frame < frames; ++frame) {
+			// ~10 ms smoothing for the mean frequency, ~100 ms release for the peak level
+			analyser[CHANNEL_A].process(oversampledBlock.in[CHANNEL_A][frame], 100.f * args.sampleTime, 1.f - 10.f * args.sampleTime);
+			analyser[CHANNEL_B].process(oversampledBlock.in[CHANNEL_B][frame], 100.f * args.sampleTime, 1.f - 10.f * args.sampleTime);
 		}
 
-		outputs[OUT_A_OUTPUT].setVoltage(outA);
-		outputs[OUT_B_OUTPUT].setVoltage(outB);
-		outputs[OUT_CHOPP_OUTPUT].setVoltage(outChopp);
+		framesSinceAdapt += frames;
+		if (framesSinceAdapt < ADAPT_INTERVAL) {
+			return;
+		}
 
-		if (inputs[IN_GATE_INPUT].isConnected()) {
-			lights[LED_A_LIGHT].setSmoothBrightness((float) outputAToChopp, args.sampleTime);
-			lights[LED_B_LIGHT].setSmoothBrightness((float)(!outputAToChopp), args.sampleTime);
+		float bandwidth = 0.f;
+		if (oversampledBlock.isRequired[CHANNEL_A]) {
+			bandwidth = std::max(bandwidth, analyser[CHANNEL_A].bandwidth(args.sampleRate));
 		}
-		else {
-			lights[LED_A_LIGHT].setBrightness(0.f);
-			lights[LED_B_LIGHT].setBrightness(0.f);
+		if (oversampledBlock.isRequired[CHANNEL_B]) {
+			bandwidth = std::max(bandwidth, analyser[CHANNEL_B].bandwidth(args.sampleRate));
 		}
+		// CHOPP multiplies them with the upsampled gate, whose edges reach up to the base rate Nyquist frequency
+		if (oversampledBlock.isRequired[CHANNEL_CHOPP]) {
+			bandwidth += 0.5f * args.sampleRate;
+		}
+
+		// given the same bandwidth every channel makes the same choice, so they stay on the same ratio
+		for (int channel_idx = 0; channel_idx < NUM_CHANNELS; channel_idx++) {
+			oversampler[channel_idx].adapt(bandwidth, framesSinceAdapt, oversampledBlock.in[channel_idx][frames - 1],
+			                               oversampledBlock.out[channel_idx][frames - 1]);
+		}
+		framesSinceAdapt = 0;
 	}
 
 	float wavefolderAResponseCached(float x) {
 		if (x >= 0) {
 			float j = rescale(clamp(x, 0.f, 10.f), 0.f, 10.f, 0, WAVESHAPE_CACHE_SIZE - 1);
-			return interpolateLinear(waveshapeA, j);
+			return interpolateLinear(waveshapers->a, j);
 		}
 		else {
 			return -wavefolderAResponseCached(-x);
@@ -191,11 +337,11 @@ struct ChoppingKinky : Module {
 	float wavefolderBResponseCached(float x) {
 		if (x >= 0) {
 			float j = rescale(clamp(x, 0.f, 10.f), 0.f, 10.f, 0, WAVESHAPE_CACHE_SIZE - 1);
-			return interpolateLinear(waveshapeBPositive, j);
+			return interpolateLinear(waveshapers->bPositive, j);
 		}
 		else {
 			float j = rescale(clamp(-x, 0.f, 10.f), 0.f, 10.f, 0, WAVESHAPE_CACHE_SIZE - 1);
-			return interpolateLinear(waveshapeBNegative, j);
+			return interpolateLinear(waveshapers->bNegative, j);
 		}
 	}
 
@@ -273,20 +419,25 @@ struct ChoppingKinky : Module {
 	}
 
 	// functional form for waveshapers uses a lot of transcendental functions, so we cache
-	// the response in a LUT
+	// the response in a LUT (shared by all instances)
 	void cacheWaveshaperResponses() {
-		for (int i = 0; i < WAVESHAPE_CACHE_SIZE; ++i) {
-			float x = rescale(i, 0, WAVESHAPE_CACHE_SIZE - 1, 0.0, 10.f);
-			waveshapeA[i] = wavefolderAResponse(x);
-			waveshapeBPositive[i] = wavefolderBResponse(+x);
-			waveshapeBNegative[i] = wavefolderBResponse(-x);
-		}
+		waveshapers = SharedTable<WaveshaperTables>::get("ChoppingKinky waveshapers", 0.f, [](WaveshaperTables & tables) {
+			for (int i = 0; i < WAVESHAPE_CACHE_SIZE; ++i) {
+				float x = rescale(i, 0, WAVESHAPE_CACHE_SIZE - 1, 0.0, 10.f);
+				tables.a[i] = wavefolderAResponse(x);
+				tables.bPositive[i] = wavefolderBResponse(+x);
+				tables.bNegative[i] = wavefolderBResponse(-x);
+			}
+		});
 	}
 
 	json_t* dataToJson() override {
 		json_t* rootJ = json_object();
 		json_object_set_new(rootJ, "filterDC", json_boolean(blockDC));
-		json_object_set_new(rootJ, "oversamplingIndex", json_integer(oversampler[0].getOversamplingIndex()));
+		json_object_set_new(rootJ, "oversamplingIndex", json_integer(oversamplingIndex));
+		json_object_set_new(rootJ, "antialiasingFilter", json_integer(antialiasingFilter));
+		json_object_set_new(rootJ, "adaptiveOversampling", json_boolean(adaptiveOversampling));
+		json_object_set_new(rootJ, "blockSize", json_integer(block.getBlockSize()));
 		return rootJ;
 	}
 
@@ -301,6 +452,23 @@ struct ChoppingKinky : Module {
 			oversamplingIndex = json_integer_value(oversamplingIndexJ);
 			onSampleRateChange();
 		}
+
+		json_t* antialiasingFilterJ = json_object_get(rootJ, "antialiasingFilter");
+		if (antialiasingFilterJ) {
+			antialiasingFilter = (FilterType) clamp((int) json_integer_value(antialiasingFilterJ), 0, Oversampler::NUM_FILTER_TYPES - 1);
+			onSampleRateChange();
+		}
+
+		json_t* adaptiveOversamplingJ = json_object_get(rootJ, "adaptiveOversampling");
+		if (adaptiveOversamplingJ) {
+			adaptiveOversampling = json_boolean_value(adaptiveOversamplingJ);
+			onSampleRateChange();
+		}
+
+		json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+		if (blockSizeJ) {
+			block.setBlockSize(json_integer_value(blockSizeJ));
+		}
 	}
 };
 
@@ -352,11 +520,34 @@ struct ChoppingKinkyWidget : ModuleWidget {
 		},
 		[ = ](int mode) {
 			module->oversamplingIndex = mode;
-			module->onSampleRateChange();
+			module->oversamplingChanged = true;
+		}
+		                                     ));
+
+		menu->addChild(createIndexSubmenuItem("Anti-aliasing filter",
+		{"Butterworth (IIR)", "Half-band (polyphase)", "Chebyshev II (IIR)", "Elliptic (IIR)", "Linear phase (FIR)"},
+		[ = ]() {
+			return module->antialiasingFilter;
+		},
+		[ = ](int type) {
+			module->antialiasingFilter = (ChoppingKinky::FilterType) type;
+			module->oversamplingChanged = true;
 		}
 		                                     ));
+
+		menu->addChild(createBoolMenuItem("Adaptive oversampling", "up to the ratio above",
+		[ = ]() {
+			return module->adaptiveOversampling;
+		},
+		[ = ](bool adaptive) {
+			module->adaptiveOversampling = adaptive;
+			module->oversamplingChanged = true;
+		}
+		                                 ));
+
+		menu->addChild(createBlockSizeMenuItem(&module->block));
 	}
 };
 
 
-Model* modelChoppingKinky = createModel<ChoppingKinky, ChoppingKinkyWidget>("ChoppingKinky");
\ No newline at end of file
+Model* modelChoppingKinky = createModelWithTelemetry<ChoppingKinky, ChoppingKinkyWidget>("ChoppingKinky");
\ No newline at end of file
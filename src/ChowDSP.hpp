@@ -1,5 +1,10 @@
 #pragma once
 #include <rack.hpp>
+#include "FastMath.hpp"
+#include "FilterDesign.hpp"
+#include "Denormals.hpp"
+#include <new>
+#include <type_traits>
 
 
 namespace chowdsp {
@@ -28,6 +33,12 @@ struct IIRFilter {
 		std::fill(z, &z[ORDER], 0.0f);
 	}
 
+	/** Sets state that has decayed below DENORMAL_SNAP_THRESHOLD to zero (see Denormals.hpp) */
+	void flushDenormals() noexcept {
+		for (int i = 1; i < ORDER; i++)
+			z[i] = snapToZero(z[i]);
+	}
+
 	void setCoefficients(const T* b, const T* a) {
 		for (int i = 0; i < ORDER; i++) {
 			this->b[i] = b[i];
@@ -37,6 +48,24 @@ struct IIRFilter {
 		}
 	}
 
+	/** Sets the state the filter settles to under a constant input x, so that it continues from x without a
+	 transient, and returns the matching (constant) output */
+	T prime(T x) noexcept {
+		T sumB = b[0];
+		T sumA = 1.0f;
+		for (int i = 1; i < ORDER; i++) {
+			sumB += b[i];
+			sumA += a[i];
+		}
+		const T y = x * sumB / sumA;
+
+		z[ORDER - 1] = x * b[ORDER - 1] - y * a[ORDER - 1];
+		for (int i = ORDER - 2; i >= 1; --i)
+			z[i] = z[i + 1] + x * b[i] - y * a[i];
+
+		return y;
+	}
+
 	template <int N = ORDER>
 	inline typename std::enable_if <N == 2, T>::type process(T x) noexcept {
 		T y = z[1] + x * b[0];
@@ -219,54 +248,325 @@ typedef TBiquadFilter<> BiquadFilter;
 
 
 /**
-    High-order filter to be used for anti-aliasing or anti-imaging.
-    The template parameter N should be 1/2 the desired filter order.
+    A bank of LANES independent IIRFilters of the same order, e.g. one per polyphonic voice, with the coefficients and
+    state stored as structure-of-arrays (one array of LANES values per coefficient). Filtering a frame is then a
+    straight loop over the lanes, which process() runs with the widest instruction set available at runtime: 8 lanes
+    per instruction with AVX2, 16 with AVX-512, or 4 (as simd::float_4) otherwise.
 
-    Currently uses an 2*N-th order Butterworth filter.
-    source: https://github.com/jatinchowdhury18/ChowDSP-VCV/blob/master/src/shared/AAFilter.hpp
+    Samples are interleaved by frame, x[frame * LANES + lane], so a bank of 16 voices takes a block of polyphonic
+    voltages as it is laid out in BlockProcessor, or 4 float_4 per frame.
 */
-template<int N, typename T>
-class AAFilter {
-public:
-	AAFilter() = default;
+template <int ORDER, int LANES = 16>
+struct IIRFilterBank {
+	/** transfer function numerator coefficients: b_0, b_1, etc.*/
+	float b[ORDER][LANES] = {};
 
-	/** Calculate Q values for a Butterworth filter of a given order */
-	static std::vector<float> calculateButterQs(int order) {
-		const int lim = int (order / 2);
-		std::vector<float> Qs;
+	/** transfer function denominator coefficients: a_0, a_1, etc.*/
+	float a[ORDER][LANES] = {};
 
-		for (int k = 1; k <= lim; ++k) {
-			auto b = -2.0f * std::cos((2.0f * k + order - 1) * 3.14159 / (2.0f * order));
-			Qs.push_back(1.0f / b);
+	/** filter state */
+	float z[ORDER][LANES] = {};
+
+	void reset() {
+		std::fill(&z[0][0], &z[0][0] + ORDER * LANES, 0.0f);
+	}
+
+	/** Sets state that has decayed below DENORMAL_SNAP_THRESHOLD to zero, processCascade() calls this every
+	 DenormalSnapTimer::INTERVAL frames */
+	void flushDenormals() {
+		for (int i = 1; i < ORDER; i++)
+			for (int lane = 0; lane < LANES; lane++)
+				z[i][lane] = snapToZero(z[i][lane]);
+	}
+
+	/** Sets the coefficients of every lane, e.g. from a TBiquadFilter<float> `f` with setCoefficients(f.b, f.a) */
+	void setCoefficients(const float* b, const float* a) {
+		for (int lane = 0; lane < LANES; lane++) {
+			setCoefficients(lane, b, a);
 		}
+	}
 
-		std::reverse(Qs.begin(), Qs.end());
-		return Qs;
+	void setCoefficients(int lane, const float* b, const float* a) {
+		for (int i = 0; i < ORDER; i++) {
+			this->b[i][lane] = b[i];
+		}
+		for (int i = 1; i < ORDER; i++) {
+			this->a[i][lane] = a[i];
+		}
 	}
 
+	/** Filters a block of frames in place. Only the first numLanes lanes of each frame are read and written. */
+	void process(float* x, int frames, int numLanes = LANES) {
+		IIRFilterBank* sections[1] = {this};
+		processCascade(sections, 1, x, frames, numLanes);
+	}
+
+	/** Filters a block of frames in place through a series of banks, one bank at a time */
+	static void processCascade(IIRFilterBank* const* sections, int numSections, float* x, int frames, int numLanes = LANES) {
+		runCascade(sections, numSections, x, frames, numLanes);
+
+		for (int s = 0; s < numSections; s++)
+			if (sections[s]->snapTimer.process(frames))
+				sections[s]->flushDenormals();
+	}
+
+private:
+	DenormalSnapTimer snapTimer;
+
+	static void runCascade(IIRFilterBank* const* sections, int numSections, float* x, int frames, int numLanes) {
+#if defined(__x86_64__) || defined(__i386__)
+		switch (fastmath::detectIsa()) {
+			case fastmath::ISA_AVX512: cascadeAvx512(sections, numSections, x, frames, numLanes); return;
+			case fastmath::ISA_AVX2: cascadeAvx2(sections, numSections, x, frames, numLanes); return;
+			default: break;
+		}
+#endif
+		cascade(sections, numSections, x, frames, numLanes);
+	}
+
+	// transposed direct form II, as IIRFilter::process(), for every lane of every frame. Always inlined, so that it is
+	// compiled (and vectorised) for the target of each cascade*() it is called from rather than for the baseline ISA.
+	__attribute__((always_inline))
+	static inline void filter(IIRFilterBank* __restrict f, float* __restrict x, int frames, int numLanes) {
+		for (int frame = 0; frame < frames; frame++, x += LANES) {
+			for (int lane = 0; lane < numLanes; lane++) {
+				const float in = x[lane];
+				const float y = f->z[1][lane] + in * f->b[0][lane];
+				for (int i = 1; i < ORDER - 1; i++)
+					f->z[i][lane] = f->z[i + 1][lane] + in * f->b[i][lane] - y * f->a[i][lane];
+				f->z[ORDER - 1][lane] = in * f->b[ORDER - 1][lane] - y * f->a[ORDER - 1][lane];
+				x[lane] = y;
+			}
+		}
+	}
+
+	static void cascade(IIRFilterBank* const* sections, int numSections, float* x, int frames, int numLanes) {
+		for (int s = 0; s < numSections; s++)
+			filter(sections[s], x, frames, numLanes);
+	}
+
+#if defined(__x86_64__) || defined(__i386__)
+	// same loops as cascade(), the compiler widens them to 8 or 16 lanes for these targets
+	__attribute__((target("avx2,fma")))
+	static void cascadeAvx2(IIRFilterBank* const* sections, int numSections, float* x, int frames, int numLanes) {
+		for (int s = 0; s < numSections; s++)
+			filter(sections[s], x, frames, numLanes);
+	}
+
+	__attribute__((target("avx512f")))
+	static void cascadeAvx512(IIRFilterBank* const* sections, int numSections, float* x, int frames, int numLanes) {
+		for (int s = 0; s < numSections; s++)
+			filter(sections[s], x, frames, numLanes);
+	}
+#endif
+};
+
+
+/**
+    Runs a block of mono samples in place through N biquads in series, as a pipelined cascade.
+
+    Taking each sample through every biquad in turn, each biquad has to wait for the previous one's output. Here
+    biquad k sits in SIMD lane k % 4 of float_4 k / 4 and, at each step, works on sample n - k while biquad k + 1
+    works on sample n - k - 1, so the biquads of a step are independent. A block of M samples takes M + N - 1 steps,
+    and the lanes only update their state while they hold one of the block's samples, so the output and final state
+    are the same as the serial cascade's. The fill and drain steps make it slower than the serial cascade for short
+    blocks (see `befaco-benchmark --aa-filter`).
+*/
+template <int N>
+inline void processPipelinedCascade(TBiquadFilter<float>* filters, float* x, int frames) noexcept {
+	using simd::float_4;
+	static const int NV = (N + 3) / 4;
+
+	// gather the biquads into lanes, the padding lanes have zero coefficients and state. Built with inserts rather
+	// than through a float array, as loading a float_4 straight after storing its lanes one by one stalls.
+	enum Field { B0, B1, B2, A1, A2, Z1, Z2 };
+	auto lane = [filters](int k, Field field) -> float {
+		if (k >= N)
+			return 0.f;
+		switch (field) {
+			case B0: return filters[k].b[0];
+			case B1: return filters[k].b[1];
+			case B2: return filters[k].b[2];
+			case A1: return filters[k].a[1];
+			case A2: return filters[k].a[2];
+			case Z1: return filters[k].z[1];
+			default: return filters[k].z[2];
+		}
+	};
+	auto gather = [&lane](int v, Field field) -> float_4 {
+		return float_4(lane(4 * v, field), lane(4 * v + 1, field), lane(4 * v + 2, field), lane(4 * v + 3, field));
+	};
+	float_4 b0[NV], b1[NV], b2[NV], a1[NV], a2[NV], z1[NV], z2[NV], in[NV];
+	for (int v = 0; v < NV; v++) {
+		b0[v] = gather(v, B0);
+		b1[v] = gather(v, B1);
+		b2[v] = gather(v, B2);
+		a1[v] = gather(v, A1);
+		a2[v] = gather(v, A2);
+		z1[v] = gather(v, Z1);
+		z2[v] = gather(v, Z2);
+		in[v] = 0.f;
+	}
+
+	for (int t = 0; t < frames + N - 1; t++) {
+		// biquad 0 takes the next sample, the others what the previous biquad output at the last step
+		in[0] = _mm_move_ss(in[0].v, _mm_set_ss(t < frames ? x[t] : 0.f));
+
+		float_4 y[NV];
+		if (t >= N - 1 && t < frames) {
+			// every lane holds a sample
+			for (int v = 0; v < NV; v++) {
+				y[v] = z1[v] + in[v] * b0[v];
+				z1[v] = z2[v] + in[v] * b1[v] - y[v] * a1[v];
+				z2[v] = in[v] * b2[v] - y[v] * a2[v];
+			}
+		}
+		else {
+			// filling or draining, biquad k holds sample t - k only if that is within the block
+			for (int v = 0; v < NV; v++) {
+				y[v] = z1[v] + in[v] * b0[v];
+				const float_4 k = float_4(4 * v, 4 * v + 1, 4 * v + 2, 4 * v + 3);
+				const float_4 active = (k <= float_4(t)) & (k > float_4(t - frames));
+				z1[v] = simd::ifelse(active, z2[v] + in[v] * b1[v] - y[v] * a1[v], z1[v]);
+				z2[v] = simd::ifelse(active, in[v] * b2[v] - y[v] * a2[v], z2[v]);
+			}
+		}
+
+		if (t >= N - 1) {
+			const __m128 last = y[NV - 1].v;
+			x[t - (N - 1)] = _mm_cvtss_f32(_mm_shuffle_ps(last, last, _MM_SHUFFLE(0, 0, 0, (N - 1) % 4)));
+		}
+
+		// shift each output one lane up, to the next biquad: in = [carry[3], y[0], y[1], y[2]]
+		for (int v = NV - 1; v >= 0; v--) {
+			const __m128 carry = (v > 0) ? y[v - 1].v : y[v].v;
+			in[v] = _mm_move_ss(_mm_shuffle_ps(y[v].v, y[v].v, _MM_SHUFFLE(2, 1, 0, 0)), _mm_shuffle_ps(carry, carry, _MM_SHUFFLE(3, 3, 3, 3)));
+		}
+	}
+
+	for (int k = 0; k < N; k++) {
+		filters[k].z[1] = z1[k / 4][k % 4];
+		filters[k].z[2] = z2[k / 4][k % 4];
+	}
+}
+
+
+constexpr int log2Ratio(int ratio) {
+	return ratio > 1 ? 1 + log2Ratio(ratio / 2) : 0;
+}
+
+/** The most Butterworth sections the other designs can stand in for: their stopband is 60 dB down, which a
+ Butterworth cascade of 7 or more sections passes at 2x */
+static const int MAX_REDUCED_AA_FILTER_SECTIONS = 6;
+
+/** Number of biquad sections a design needs to match the stopband of a Butterworth cascade of
+ `butterworthSections` sections (at most MAX_REDUCED_AA_FILTER_SECTIONS for the other designs), from 0.6 * the base
+ sample rate up, at every ratio from 2x to 16x. Taken from the worst-case stopband gain of each design in
+ AAFilterTable; the tightest cases are 16x for the elliptic filters and 4x for the Chebyshev II ones:
+
+    sections          1      2      3      4      5      6
+    16x Butterworth  -7.0  -12.3  -18.2  -24.1  -30.2  -36.2  dB
+        elliptic     -0.7   -9.9  -39.4  -59.9                dB
+    4x  Butterworth  -7.5  -13.6  -20.1  -26.7  -33.4  -40.1  dB
+        Chebyshev II -7.5  -14.5  -26.4  -54.7  -60.0         dB
+*/
+constexpr int aaFilterSections(AAFilterDesign design, int butterworthSections) {
+	return design == ELLIPTIC ? (butterworthSections <= 1 ? 2 : 3)
+	       : design == CHEBYSHEV_II ? (butterworthSections <= 4 ? butterworthSections : 4) : butterworthSections;
+}
+
+/**
+    High-order filter to be used for anti-aliasing or anti-imaging.
+    The template parameter N is the number of biquad sections, 1/2 the filter order.
+
+    Uses a 2*N-th order Butterworth, Chebyshev II or elliptic lowpass (see AAFilterDesign), cut off at 0.85 * the
+    base rate Nyquist frequency, with the coefficients taken from AAFilterTable.
+    source (modified): https://github.com/jatinchowdhury18/ChowDSP-VCV/blob/master/src/shared/AAFilter.hpp
+*/
+template<int N, typename T, AAFilterDesign design = BUTTERWORTH>
+class AAFilter {
+	static_assert(N >= 1 && N <= AAFilterTable::MAX_SECTIONS, "AAFilterTable only holds designs of 1 to MAX_SECTIONS sections");
+
+public:
+	AAFilter() = default;
+
 	/**
 	 * Resets the filter to process at a new sample rate.
 	 *
 	 * @param sampleRate: The base (i.e. pre-oversampling) sample rate of the audio being processed
 	 * @param osRatio: The oversampling ratio at which the filter is being used
 	 */
-	void reset(float sampleRate, int osRatio) {
-		float fc = 0.85f * (sampleRate / 2.0f);
-		auto Qs = calculateButterQs(2 * N);
-
-		for (int i = 0; i < N; ++i)
-			filters[i].setParameters(TBiquadFilter<T>::Type::LOWPASS, fc / (osRatio * sampleRate), Qs[i], 1.0f);
+	void reset(float /*sampleRate*/, int osRatio) {
+		// relative to the oversampled rate the cutoff only depends on the ratio
+		const BiquadCoefficients* sections = AAFilterTable::get(design, log2Ratio(osRatio), N);
+
+		for (int i = 0; i < N; ++i) {
+			for (int k = 0; k < 3; ++k) {
+				filters[i].b[k] = sections[i].b[k];
+				filters[i].a[k] = sections[i].a[k];
+			}
+		}
 	}
 
 	inline T process(T x) noexcept {
 		for (int i = 0; i < N; ++i)
 			x = filters[i].process(x);
 
+		if (snapTimer.process())
+			flushDenormals();
+
 		return x;
 	}
 
+	/** Sets every section's state that has decayed below DENORMAL_SNAP_THRESHOLD to zero, process() and
+	 processBlock() call this every DenormalSnapTimer::INTERVAL samples */
+	void flushDenormals() noexcept {
+		for (int i = 0; i < N; ++i)
+			filters[i].flushDenormals();
+	}
+
+	/** Sets every section to its steady state under a constant input x, see IIRFilter::prime() */
+	T prime(T x) noexcept {
+		for (int i = 0; i < N; ++i)
+			x = filters[i].prime(x);
+
+		return x;
+	}
+
+	/** Shortest block and lowest filter order for which processBlock() runs the biquads as a pipelined cascade,
+	 below these the serial cascade is faster */
+	static const int MIN_PIPELINED_FRAMES = 16;
+	static const int MIN_PIPELINED_ORDER = 12;
+
+	/** Filters a block in place, the same as process() on each sample. Mono blocks run through
+	 processPipelinedCascade() if the block and filter order are large enough. */
+	inline void processBlock(T* x, int frames) noexcept {
+		processBlock(filters, x, frames);
+
+		if (snapTimer.process(frames))
+			flushDenormals();
+	}
+
 private:
+	template <typename U>
+	static inline void processBlock(TBiquadFilter<U>* filters, U* x, int frames) noexcept {
+		for (int n = 0; n < frames; ++n)
+			for (int i = 0; i < N; ++i)
+				x[n] = filters[i].process(x[n]);
+	}
+
+	static inline void processBlock(TBiquadFilter<float>* filters, float* x, int frames) noexcept {
+		if (2 * N >= MIN_PIPELINED_ORDER && frames >= MIN_PIPELINED_FRAMES) {
+			processPipelinedCascade<N>(filters, x, frames);
+			return;
+		}
+		for (int n = 0; n < frames; ++n)
+			for (int i = 0; i < N; ++i)
+				x[n] = filters[i].process(x[n]);
+	}
+
 	TBiquadFilter<T> filters[N];
+	DenormalSnapTimer snapTimer;
 };
 
 
@@ -287,13 +587,45 @@ public:
 	/** Upsample a single input sample and update the oversampled buffer */
 	virtual void upsample(T) noexcept = 0;
 
-	/** Output a downsampled output sample from the current oversampled buffer */
+	/** Output a downsampled output sample from the current oversampled buffer. An implementation may run its
+	 anti-aliasing filter over the buffer in place (Oversampling does), so the buffer's contents are unspecified
+	 afterwards: read anything you need from it before calling this. */
 	virtual T downsample() noexcept = 0;
 
-	/** Returns a pointer to the oversampled buffer */
+	/** Returns a pointer to the oversampled buffer. It holds the upsampled samples after upsample() or
+	 upsampleBlock(), for the caller to process in place, and is unspecified after downsample() or downsampleBlock(). */
 	virtual T* getOSBuffer() noexcept = 0;
+
+	/** Upsample `frames` input samples (at most the oversampler's MAX_BLOCK_FRAMES) into the first frames * ratio
+	 samples of the oversampled buffer, the same as calling upsample() on each */
+	virtual void upsampleBlock(const T* in, int frames) noexcept = 0;
+
+	/** Downsample the first frames * ratio samples of the oversampled buffer into `frames` output samples, the
+	 same as calling downsample() on each group of ratio samples, so those samples are unspecified afterwards too */
+	virtual void downsampleBlock(T* out, int frames) noexcept = 0;
+
+	/** Sets the filters to the state they would have reached after a constant input `lastInput` was upsampled
+	 and a constant `lastOutput` downsampled, so an oversampler swapped in mid-signal carries on from the signal
+	 instead of ringing up from silence. */
+	virtual void prime(T /*lastInput*/, T /*lastOutput*/) noexcept = 0;
 };
 
+/**
+    Shared body of the oversamplers' processBlock(): runs `frames` base rate samples through upsampleBlock(),
+    `process(osBlock, osFrames)` and downsampleBlock(), the oversampler's MAX_BLOCK_FRAMES frames at a time. process()
+    works on the oversampled samples in place, osFrames of them starting at osBlock.
+*/
+template <int ratio, typename T, class TOversampling, typename TProcess>
+inline void processOversampledBlock(TOversampling& os, const T* in, T* out, int frames, TProcess& process) noexcept {
+	static const int MAX_BLOCK_FRAMES = TOversampling::MAX_BLOCK_FRAMES;
+	for (int start = 0; start < frames; start += MAX_BLOCK_FRAMES) {
+		const int blockFrames = (frames - start < MAX_BLOCK_FRAMES) ? frames - start : MAX_BLOCK_FRAMES;
+		os.upsampleBlock(&in[start], blockFrames);
+		process(os.osBuffer, blockFrames * ratio);
+		os.downsampleBlock(&out[start], blockFrames);
+	}
+}
+
 
 /**
     Class to implement an oversampled process.
@@ -306,99 +638,606 @@ public:
         oversample.osBuffer[k] = processSample(oversample.osBuffer[k]);
     float y = oversample.downsample();
     @endcode
+
+    or, for a block of base rate samples, with a functor (e.g. a lambda) over the whole oversampled block:
+    @code
+    oversample.processBlock(in, out, frames, [](float* osBlock, int osFrames) {
+        for (int k = 0; k < osFrames; k++)
+            osBlock[k] = processSample(osBlock[k]);
+    });
+    @endcode
+
+    The filters run over osBuffer in place, so its contents are not meaningful after downsample().
+
+    `design` selects the lowpass (see AAFilterDesign). filtN is the number of sections of the Butterworth
+    version, the other designs get at least its stopband from the number of sections aaFilterSections() gives:
+    fewer from 3 (elliptic) or 5 (Chebyshev II) sections up, and filtN can be at most
+    MAX_REDUCED_AA_FILTER_SECTIONS for them.
+
+    osBuffer holds maxBlockFrames base rate frames, the most upsampleBlock() and downsampleBlock() take. It defaults
+    to one, enough for upsample()/downsample(), so only code using the block API pays for a larger buffer; longer
+    processBlock() calls are split into blocks of that size.
 */
-template<int ratio, int filtN = 4, typename T = float>
-class Oversampling : public BaseOversampling<T> {
+template<int ratio, int filtN = 4, typename T = float, AAFilterDesign design = BUTTERWORTH, int maxBlockFrames = 1>
+class Oversampling final : public BaseOversampling<T> {
 public:
+	static const int MAX_BLOCK_FRAMES = maxBlockFrames;
+
 	Oversampling() = default;
 	virtual ~Oversampling() {}
 
 	void reset(float baseSampleRate) override {
 		aaFilter.reset(baseSampleRate, ratio);
 		aiFilter.reset(baseSampleRate, ratio);
-		std::fill(osBuffer, &osBuffer[ratio], 0.0f);
+		std::fill(osBuffer, &osBuffer[OS_BUFFER_SIZE], 0.0f);
 	}
 
 	inline void upsample(T x) noexcept override {
 		osBuffer[0] = ratio * x;
 		std::fill(&osBuffer[1], &osBuffer[ratio], 0.0f);
 
-		for (int k = 0; k < ratio; k++)
-			osBuffer[k] = aiFilter.process(osBuffer[k]);
+		aiFilter.processBlock(osBuffer, ratio);
 	}
 
 	inline T downsample() noexcept override {
-		T y = 0.0f;
-		for (int k = 0; k < ratio; k++)
-			y = aaFilter.process(osBuffer[k]);
+		aaFilter.processBlock(osBuffer, ratio);
+		return osBuffer[ratio - 1];
+	}
 
-		return y;
+	inline void upsampleBlock(const T* in, int frames) noexcept override {
+		std::fill(osBuffer, &osBuffer[frames * ratio], 0.0f);
+		for (int n = 0; n < frames; n++)
+			osBuffer[n * ratio] = ratio * in[n];
+
+		// one pass over the whole block, long enough for the pipelined cascade to pay off
+		aiFilter.processBlock(osBuffer, frames * ratio);
+	}
+
+	inline void downsampleBlock(T* out, int frames) noexcept override {
+		aaFilter.processBlock(osBuffer, frames * ratio);
+		for (int n = 0; n < frames; n++)
+			out[n] = osBuffer[n * ratio + ratio - 1];
+	}
+
+	/** Upsamples in[0 .. frames), runs `process(osBlock, osFrames)` over the oversampled samples in place and
+	 downsamples them into out[0 .. frames), see processOversampledBlock() */
+	template <typename TProcess>
+	inline void processBlock(const T* in, T* out, int frames, TProcess&& process) noexcept {
+		processOversampledBlock<ratio>(*this, in, out, frames, process);
 	}
 
 	inline T* getOSBuffer() noexcept override {
 		return osBuffer;
 	}
 
-	T osBuffer[ratio];
+	void prime(T lastInput, T lastOutput) noexcept override {
+		// the zero-stuffed input averages to lastInput, which the anti-imaging filter passes at unity gain
+		aiFilter.prime(lastInput);
+		aaFilter.prime(lastOutput);
+		// but isn't constant, so let the sections pick up its ripple at the image frequencies as well
+		for (int i = 0; i < PRIME_FRAMES; ++i)
+			upsample(lastInput);
+	}
+
+	static const int OS_BUFFER_SIZE = ratio * MAX_BLOCK_FRAMES;
+	T osBuffer[OS_BUFFER_SIZE];
 
 private:
-	AAFilter<filtN, T> aaFilter; // anti-aliasing filter
-	AAFilter<filtN, T> aiFilter; // anti-imaging filter
+	// base rate frames run through the anti-imaging filter by prime()
+	static const int PRIME_FRAMES = 8;
+
+	static_assert(design == BUTTERWORTH || filtN <= MAX_REDUCED_AA_FILTER_SECTIONS,
+	              "the Chebyshev II and elliptic designs can't match the stopband of more Butterworth sections");
+
+	// filtN is the number of Butterworth sections, see aaFilterSections() for the other designs
+	AAFilter<aaFilterSections(design, filtN), T, design> aaFilter; // anti-aliasing filter
+	AAFilter<aaFilterSections(design, filtN), T, design> aiFilter; // anti-imaging filter
 };
 
 typedef Oversampling<1, 4, simd::float_4> OversamplingSIMD;
 
 
+/**
+    Coefficients of the half-band filters used by PolyphaseOversampling, one design per 2x stage. Stage 0 converts
+    between the base rate and 2x, stage 1 between 2x and 4x, and so on. Each is an elliptic half-band design (Laurent
+    de Soras' HIIR designer) whose passband covers 0.45 * the base sample rate, so the later stages, which only
+    have to reject images of that band, get by with far fewer coefficients.
+*/
+template<int STAGE>
+struct HalfBandDesign;
+
+template<>
+struct HalfBandDesign<0> {
+	// transition 0.025, -86.7 dB stopband
+	static const int NUM_COEFS = 8;
+	static const float* coefs() {
+		static const float c[NUM_COEFS] = {0.051769653f, 0.187460274f, 0.362656131f, 0.535496750f,
+		                                   0.682535618f, 0.798410590f, 0.888716245f, 0.964007072f
+		                                  };
+		return c;
+	}
+};
+
+template<>
+struct HalfBandDesign<1> {
+	// transition 0.1375, -81.3 dB stopband
+	static const int NUM_COEFS = 4;
+	static const float* coefs() {
+		static const float c[NUM_COEFS] = {0.064475297f, 0.239360863f, 0.489354867f, 0.804128245f};
+		return c;
+	}
+};
+
+template<>
+struct HalfBandDesign<2> {
+	// transition 0.19375, -75.1 dB stopband
+	static const int NUM_COEFS = 3;
+	static const float* coefs() {
+		static const float c[NUM_COEFS] = {0.083194599f, 0.320335877f, 0.713479180f};
+		return c;
+	}
+};
+
+template<>
+struct HalfBandDesign<3> {
+	// transition 0.221875, -82.3 dB stopband
+	static const int NUM_COEFS = 3;
+	static const float* coefs() {
+		static const float c[NUM_COEFS] = {0.075951802f, 0.300908554f, 0.697817010f};
+		return c;
+	}
+};
+
+
+/**
+    Half-band lowpass built from two parallel chains of first order allpass sections (coefficients alternate between
+    the chains), running at the lower of its two sample rates. As a 2x upsampler each input sample produces two
+    outputs, as a 2x downsampler each pair of inputs produces one output. Either way each section runs once per
+    low-rate sample, so no work is spent filtering stuffed zeros or samples that are then thrown away.
+*/
+template<int STAGE, typename T = float>
+class HalfBandPolyphase {
+public:
+	static const int NUM_COEFS = HalfBandDesign<STAGE>::NUM_COEFS;
+
+	void reset() {
+		std::fill(x, &x[NUM_COEFS], 0.0f);
+		std::fill(y, &y[NUM_COEFS], 0.0f);
+	}
+
+	/** Steady state under a constant input v: allpass sections pass DC unchanged */
+	void prime(T v) {
+		std::fill(x, &x[NUM_COEFS], v);
+		std::fill(y, &y[NUM_COEFS], v);
+	}
+
+	/** One input sample in, two output samples out */
+	inline void upsample(T in, T* out) noexcept {
+		T spl[2] = {in, in};
+		processSections(spl);
+		out[0] = spl[0];
+		out[1] = spl[1];
+	}
+
+	/** Two input samples in, one output sample out */
+	inline T downsample(const T* in) noexcept {
+		T spl[2] = {in[1], in[0]};
+		processSections(spl);
+		return 0.5f * (spl[0] + spl[1]);
+	}
+
+private:
+	inline void processSections(T* spl) noexcept {
+		const float* a = HalfBandDesign<STAGE>::coefs();
+		for (int i = 0; i < NUM_COEFS; ++i) {
+			// (a + z^-1) / (1 + a z^-1) at the low rate
+			const T out = (spl[i & 1] - y[i]) * a[i] + x[i];
+			x[i] = spl[i & 1];
+			y[i] = out;
+			spl[i & 1] = out;
+		}
+	}
+
+	T x[NUM_COEFS] = {};
+	T y[NUM_COEFS] = {};
+};
+
+/** NUM_STAGES half-band stages in series, converting between the base rate and 2^NUM_STAGES times it */
+template<int NUM_STAGES, typename T = float>
+class HalfBandCascade {
+public:
+	static const int RATIO = 1 << NUM_STAGES;
+
+	void reset() {
+		inner.reset();
+		upStage.reset();
+		downStage.reset();
+	}
+
+	/** Steady state after upsampling a constant `in` and downsampling a constant `out` */
+	void prime(T in, T out) {
+		inner.prime(in, out);
+		upStage.prime(in);
+		downStage.prime(out);
+	}
+
+	/** One base rate sample in, RATIO samples out */
+	inline void upsample(T x, T* out) noexcept {
+		T half[RATIO / 2];
+		inner.upsample(x, half);
+		for (int k = 0; k < RATIO / 2; k++)
+			upStage.upsample(half[k], &out[2 * k]);
+	}
+
+	/** RATIO samples in, one base rate sample out */
+	inline T downsample(const T* in) noexcept {
+		T half[RATIO / 2];
+		for (int k = 0; k < RATIO / 2; k++)
+			half[k] = downStage.downsample(&in[2 * k]);
+		return inner.downsample(half);
+	}
+
+private:
+	// the outermost stage runs at the highest rate, so it uses the cheapest design
+	HalfBandCascade<NUM_STAGES - 1, T> inner;
+	HalfBandPolyphase<NUM_STAGES - 1, T> upStage;
+	HalfBandPolyphase<NUM_STAGES - 1, T> downStage;
+};
+
+template<typename T>
+class HalfBandCascade<0, T> {
+public:
+	void reset() {}
+
+	void prime(T /*in*/, T /*out*/) {}
+
+	inline void upsample(T x, T* out) noexcept {
+		out[0] = x;
+	}
+
+	inline T downsample(const T* in) noexcept {
+		return in[0];
+	}
+};
+
+/**
+    Drop-in alternative to Oversampling, using a cascade of polyphase half-band filters instead of running a
+    Butterworth cascade over every oversampled sample. Sharper (and steeper) anti-aliasing for less CPU, at the
+    cost of a different (still non-linear) phase response. ratio must be a power of two, up to 16. maxBlockFrames is
+    as for Oversampling.
+*/
+template<int ratio, typename T = float, int maxBlockFrames = 1>
+class PolyphaseOversampling final : public BaseOversampling<T> {
+public:
+	static const int MAX_BLOCK_FRAMES = maxBlockFrames;
+
+	PolyphaseOversampling() = default;
+	virtual ~PolyphaseOversampling() {}
+
+	void reset(float /*baseSampleRate*/) override {
+		// the designs are relative to the sample rate, so there is nothing to recompute
+		filters.reset();
+		std::fill(osBuffer, &osBuffer[OS_BUFFER_SIZE], 0.0f);
+	}
+
+	inline void upsample(T x) noexcept override {
+		filters.upsample(x, osBuffer);
+	}
+
+	inline T downsample() noexcept override {
+		return filters.downsample(osBuffer);
+	}
+
+	inline void upsampleBlock(const T* in, int frames) noexcept override {
+		for (int n = 0; n < frames; n++)
+			filters.upsample(in[n], &osBuffer[n * ratio]);
+	}
+
+	inline void downsampleBlock(T* out, int frames) noexcept override {
+		for (int n = 0; n < frames; n++)
+			out[n] = filters.downsample(&osBuffer[n * ratio]);
+	}
+
+	/** See Oversampling::processBlock() */
+	template <typename TProcess>
+	inline void processBlock(const T* in, T* out, int frames, TProcess&& process) noexcept {
+		processOversampledBlock<ratio>(*this, in, out, frames, process);
+	}
+
+	inline T* getOSBuffer() noexcept override {
+		return osBuffer;
+	}
+
+	void prime(T lastInput, T lastOutput) noexcept override {
+		filters.prime(lastInput, lastOutput);
+	}
+
+	static const int OS_BUFFER_SIZE = ratio * MAX_BLOCK_FRAMES;
+	T osBuffer[OS_BUFFER_SIZE];
+
+private:
+	static_assert((1 << log2Ratio(ratio)) == ratio && ratio <= 16, "ratio must be a power of two up to 16");
+	HalfBandCascade<log2Ratio(ratio), T> filters;
+};
+
+
+/**
+    Alternative to Oversampling with linear phase anti-aliasing and anti-imaging filters: the FIR lowpass of
+    FIRFilterTable, run as a polyphase filter so that the stuffed zeros and the samples thrown away by decimation cost
+    nothing. Upsampling and downsampling each delay the signal by (TAPS - 1) / 2 oversampled samples, just under
+    TAPS_PER_PHASE / 2 base rate samples, the same at every frequency and (nearly) the same at every ratio, 1
+    included. ratio must be a power of two, up to 16. maxBlockFrames is as for Oversampling.
+*/
+template<int ratio, typename T = float, int maxBlockFrames = 1>
+class FIROversampling final : public BaseOversampling<T> {
+public:
+	static const int MAX_BLOCK_FRAMES = maxBlockFrames;
+	static const int TAPS_PER_PHASE = FIRFilterTable::TAPS_PER_PHASE;
+	static const int TAPS = TAPS_PER_PHASE * ratio;
+
+	FIROversampling() = default;
+	virtual ~FIROversampling() {}
+
+	void reset(float /*baseSampleRate*/) override {
+		// the design is relative to the sample rate, so it is shared by every sample rate
+		taps = FIRFilterTable::get(log2Ratio(ratio));
+		polyphaseTaps = FIRFilterTable::getPolyphase(log2Ratio(ratio));
+		std::fill(inHistory, &inHistory[2 * TAPS_PER_PHASE], 0.0f);
+		std::fill(osHistory, &osHistory[2 * TAPS], 0.0f);
+		std::fill(osBuffer, &osBuffer[OS_BUFFER_SIZE], 0.0f);
+	}
+
+	inline void upsample(T x) noexcept override {
+		upsampleFrame(x, osBuffer);
+	}
+
+	inline T downsample() noexcept override {
+		return downsampleFrame(osBuffer);
+	}
+
+	inline void upsampleBlock(const T* in, int frames) noexcept override {
+		for (int n = 0; n < frames; n++)
+			upsampleFrame(in[n], &osBuffer[n * ratio]);
+	}
+
+	inline void downsampleBlock(T* out, int frames) noexcept override {
+		for (int n = 0; n < frames; n++)
+			out[n] = downsampleFrame(&osBuffer[n * ratio]);
+	}
+
+	/** See Oversampling::processBlock() */
+	template <typename TProcess>
+	inline void processBlock(const T* in, T* out, int frames, TProcess&& process) noexcept {
+		processOversampledBlock<ratio>(*this, in, out, frames, process);
+	}
+
+	inline T* getOSBuffer() noexcept override {
+		return osBuffer;
+	}
+
+	void prime(T lastInput, T lastOutput) noexcept override {
+		// an FIR filter's state is its input history, which for a constant signal is just that constant
+		std::fill(inHistory, &inHistory[2 * TAPS_PER_PHASE], lastInput);
+		std::fill(osHistory, &osHistory[2 * TAPS], lastOutput);
+	}
+
+	static const int OS_BUFFER_SIZE = ratio * MAX_BLOCK_FRAMES;
+	T osBuffer[OS_BUFFER_SIZE];
+
+private:
+	static_assert((1 << log2Ratio(ratio)) == ratio && ratio <= 16, "ratio must be a power of two up to 16");
+
+	// one base rate sample in, ratio samples out
+	inline void upsampleFrame(T x, T* out) noexcept {
+		inPos = (inPos == 0) ? TAPS_PER_PHASE - 1 : inPos - 1;
+		inHistory[inPos] = inHistory[inPos + TAPS_PER_PHASE] = x;
+
+		// output k of the frame only sees taps k, k + ratio, k + 2 ratio, ... as the rest meet stuffed zeros
+		const T* in = &inHistory[inPos];
+		for (int k = 0; k < ratio; k++) {
+			const float* phase = &polyphaseTaps[k * TAPS_PER_PHASE];
+			T y = 0.0f;
+			for (int j = 0; j < TAPS_PER_PHASE; j++)
+				y += phase[j] * in[j];
+			out[k] = ratio * y;
+		}
+	}
+
+	// ratio samples in, one base rate sample out
+	inline T downsampleFrame(const T* x) noexcept {
+		for (int k = 0; k < ratio; k++) {
+			osPos = (osPos == 0) ? TAPS - 1 : osPos - 1;
+			osHistory[osPos] = osHistory[osPos + TAPS] = x[k];
+		}
+
+		// only the output for the last sample of the frame is kept
+		const T* in = &osHistory[osPos];
+		T y = 0.0f;
+		for (int i = 0; i < TAPS; i++)
+			y += taps[i] * in[i];
+		return y;
+	}
+
+	const float* taps = FIRFilterTable::get(log2Ratio(ratio));
+	const float* polyphaseTaps = FIRFilterTable::getPolyphase(log2Ratio(ratio));
+	// newest first from inHistory[inPos] (and osHistory[osPos]), each sample stored twice so that a whole window
+	// is contiguous wherever the position is
+	T inHistory[2 * TAPS_PER_PHASE] = {};
+	T osHistory[2 * TAPS] = {};
+	int inPos = 0;
+	int osPos = 0;
+};
+
+
 /**
     Class to implement an oversampled process, with variable
     oversampling factor. To use, create an object, set the oversampling
-    factor using `setOversamplingindex()` and prepare using `reset()`.
-
-    Then use the following code to process samples:
+    factor using `setOversamplingIndex()` and prepare using `reset()`.
+    The anti-aliasing filters are the Butterworth, Chebyshev II or
+    elliptic cascades of Oversampling, the half-band filters of
+    PolyphaseOversampling or the linear phase FIR filters of
+    FIROversampling, see `setFilterType()`.
+
+    Only the oversampler for the current setting exists, built in place
+    (no heap allocation) when the setting changes. Processing code is
+    written once as a kernel templated on the ratio and filter type, and
+    `dispatch()` picks the instantiation with a single switch, so there
+    are no virtual calls or runtime ratios inside the kernel:
     @code
-    oversample.upsample(x);
-    float* osBuffer = oversample.getOSBuffer();
-    for(int k = 0; k < ratio; k++)
-        osBuffer[k] = processSample(osBuffer[k]);
-    float y = oversample.downsample();
+    struct Kernel {
+        MyModule* module;
+        template <int ratio, Oversampler::FilterType type>
+        void run() {
+            auto& os = module->oversampler.get<ratio, type>();
+            os.upsample(x);
+            for (int k = 0; k < ratio; k++)
+                os.osBuffer[k] = processSample(os.osBuffer[k]);
+            float y = os.downsample();
+        }
+    };
+    oversampler.dispatch(Kernel{this});
     @endcode
 
+    In adaptive mode (see `setAdaptive()`) the ratio follows an estimate of
+    the bandwidth the nonlinearity produces, passed to `adapt()` between
+    blocks, so cheap settings (low notes, little folding) don't pay for
+    the full oversampling ratio.
+
+    Code using the oversamplers' block API sets maxBlockFrames to the
+    longest block it passes (see Oversampling), the storage for the
+    oversampler in use grows with it.
+
 	source (modified): https://github.com/jatinchowdhury18/ChowDSP-VCV/blob/master/src/shared/VariableOversampling.hpp
 */
-template<int filtN = 4, typename T = float>
+template<int filtN = 4, typename T = float, int maxBlockFrames = 1>
 class VariableOversampling {
 public:
-	VariableOversampling() = default;
+	enum FilterType {
+		IIR_BUTTERWORTH,
+		POLYPHASE_HALF_BAND,
+		IIR_CHEBYSHEV_II,
+		IIR_ELLIPTIC,
+		FIR_LINEAR_PHASE,
+		NUM_FILTER_TYPES
+	};
+
+	/** The oversampler used for a given ratio and filter type */
+	template<int ratio, FilterType type>
+	using OversamplerType = typename std::conditional<type == POLYPHASE_HALF_BAND, PolyphaseOversampling<ratio, T, maxBlockFrames>,
+	      typename std::conditional<type == FIR_LINEAR_PHASE, FIROversampling<ratio, T, maxBlockFrames>,
+	      Oversampling<ratio, filtN, T, type == IIR_ELLIPTIC ? ELLIPTIC : type == IIR_CHEBYSHEV_II ? CHEBYSHEV_II : BUTTERWORTH,
+	      maxBlockFrames>
+	      >::type>::type;
+
+	VariableOversampling() {
+		create();
+	}
+
+	~VariableOversampling() {
+		active->~BaseOversampling<T>();
+	}
+
+	VariableOversampling(const VariableOversampling&) = delete;
+	VariableOversampling& operator=(const VariableOversampling&) = delete;
 
 	/** Prepare the oversampler to process audio at a given sample rate */
 	void reset(float sampleRate) {
-		for (auto* os : oss)
-			os->reset(sampleRate);
+		this->sampleRate = sampleRate;
+		holdFrames = (int)(HOLD_TIME * sampleRate);
+		active->reset(sampleRate);
+	}
+
+	/** Selects the anti-aliasing filter design, call reset() afterwards */
+	void setFilterType(FilterType newType) {
+		if (newType != filterType) {
+			active->~BaseOversampling<T>();
+			filterType = newType;
+			create();
+		}
+	}
+
+	FilterType getFilterType() const noexcept {
+		return filterType;
 	}
 
-	/** Sets the oversampling factor as 2^idx */
+	/** Sets the oversampling factor as 2^idx, call reset() afterwards. In adaptive mode this is the highest
+	 factor adapt() may choose, and the one it starts from. */
 	void setOversamplingIndex(int newIdx) {
-		osIdx = newIdx;
+		maxIdx = std::max(0, std::min(newIdx, NumOS - 1));
+		switchTo(maxIdx);
 	}
 
-	/** Returns the oversampling index */
+	/** Returns the oversampling index in use, in adaptive mode this may be below the one set */
 	int getOversamplingIndex() const noexcept {
 		return osIdx;
 	}
 
-	/** Upsample a single input sample and update the oversampled buffer */
-	inline void upsample(T x) noexcept {
-		oss[osIdx]->upsample(x);
+	/** Turns adaptive mode (see adapt()) on or off, call reset() afterwards */
+	void setAdaptive(bool newAdaptive) {
+		adaptive = newAdaptive;
+		switchTo(maxIdx);
 	}
 
-	/** Output a downsampled output sample from the current oversampled buffer */
-	inline T downsample() noexcept {
-		return oss[osIdx]->downsample();
+	bool isAdaptive() const noexcept {
+		return adaptive;
+	}
+
+	/** How long the bandwidth must stay low before adapt() lowers the ratio, in seconds */
+	static constexpr float HOLD_TIME = 0.2f;
+
+	/**
+	 * In adaptive mode, moves to the lowest oversampling index at which the nonlinearity doesn't alias into the
+	 * base rate passband (see requiredIndex()), but no higher than the one set with setOversamplingIndex(). The
+	 * ratio goes up as soon as the bandwidth needs it, and only comes down once it has stayed low for HOLD_TIME.
+	 *
+	 * Rather than crossfading between two ratios, which would mean running the caller's (stateful) processing
+	 * twice, the new oversampler is primed with the last base rate input and output (see
+	 * BaseOversampling::prime()), so its filters carry on from the signal instead of ringing up from silence.
+	 * The FIR filters' history is filled with those values, so with FIR_LINEAR_PHASE the output holds still for the
+	 * filters' latency after a switch. Call between frames, e.g. once per block.
+	 *
+	 * @param bandwidth: estimate of the highest frequency (Hz) with significant energy at the nonlinearity's output
+	 * @param frames: number of base rate frames since the last call
+	 * @return true if the oversampling ratio changed
+	 */
+	bool adapt(float bandwidth, int frames, T lastInput, T lastOutput) {
+		if (!adaptive) {
+			return false;
+		}
+
+		const int wantedIdx = std::min(requiredIndex(bandwidth, sampleRate), maxIdx);
+		if (wantedIdx >= osIdx) {
+			holdFrames = (int)(HOLD_TIME * sampleRate);
+			if (wantedIdx == osIdx) {
+				return false;
+			}
+		}
+		else {
+			holdFrames -= frames;
+			if (holdFrames > 0) {
+				return false;
+			}
+			holdFrames = (int)(HOLD_TIME * sampleRate);
+		}
+
+		switchTo(wantedIdx);
+		active->reset(sampleRate);
+		active->prime(lastInput, lastOutput);
+		return true;
 	}
 
-	/** Returns a pointer to the oversampled buffer */
-	inline T* getOSBuffer() noexcept {
-		return oss[osIdx]->getOSBuffer();
+	/** Lowest oversampling index at which a nonlinearity whose output reaches up to `bandwidth` Hz doesn't alias
+	 into the passband at base sample rate `sampleRate` */
+	static int requiredIndex(float bandwidth, float sampleRate) {
+		for (int idx = 0; idx < NumOS - 1; ++idx) {
+			const float osRate = (1 << idx) * sampleRate;
+			// either nothing reaches the oversampled Nyquist frequency, or everything that does folds back far
+			// enough above the base rate Nyquist frequency for the anti-aliasing filter to remove it
+			if (bandwidth <= 0.5f * osRate || osRate - bandwidth >= 0.6f * sampleRate) {
+				return idx;
+			}
+		}
+		return NumOS - 1;
 	}
 
 	/** Returns the current oversampling factor */
@@ -406,20 +1245,76 @@ public:
 		return 1 << osIdx;
 	}
 
+	/** The active oversampler, ratio and type must match the current setting (see dispatch()) */
+	template<int ratio, FilterType type>
+	inline OversamplerType<ratio, type>& get() noexcept {
+		return *static_cast<OversamplerType<ratio, type>*>(active);
+	}
+
+	/** Calls `kernel.template run<ratio, type>()` with the current oversampling ratio and filter type */
+	template<typename TKernel>
+	inline void dispatch(TKernel&& kernel) const {
+		switch (filterType) {
+			case POLYPHASE_HALF_BAND: dispatchRatio<POLYPHASE_HALF_BAND>(kernel); break;
+			case IIR_CHEBYSHEV_II: dispatchRatio<IIR_CHEBYSHEV_II>(kernel); break;
+			case IIR_ELLIPTIC: dispatchRatio<IIR_ELLIPTIC>(kernel); break;
+			case FIR_LINEAR_PHASE: dispatchRatio<FIR_LINEAR_PHASE>(kernel); break;
+			default: dispatchRatio<IIR_BUTTERWORTH>(kernel); break;
+		}
+	}
+
 
 private:
 	enum {
 		NumOS = 5, // number of oversampling options
 	};
 
-	int osIdx = 0;
+	template<FilterType type, typename TKernel>
+	inline void dispatchRatio(TKernel& kernel) const {
+		switch (osIdx) {
+			case 0: kernel.template run < 1 << 0, type > (); break;
+			case 1: kernel.template run < 1 << 1, type > (); break;
+			case 2: kernel.template run < 1 << 2, type > (); break;
+			case 3: kernel.template run < 1 << 3, type > (); break;
+			default: kernel.template run < 1 << 4, type > (); break;
+		}
+	}
+
+	struct Create {
+		VariableOversampling* self;
 
-	Oversampling < 1 << 0, filtN, T > os0; // 1x
-	Oversampling < 1 << 1, filtN, T > os1; // 2x
-	Oversampling < 1 << 2, filtN, T > os2; // 4x
-	Oversampling < 1 << 3, filtN, T > os3; // 8x
-	Oversampling < 1 << 4, filtN, T > os4; // 16x
-	BaseOversampling<T>* oss[NumOS] = { &os0, &os1, &os2, &os3, &os4 };
+		template<int ratio, FilterType type>
+		void run() {
+			self->active = new (&self->storage) OversamplerType<ratio, type>();
+		}
+	};
+
+	void create() {
+		dispatch(Create{this});
+	}
+
+	void switchTo(int newIdx) {
+		if (newIdx != osIdx) {
+			active->~BaseOversampling<T>();
+			osIdx = newIdx;
+			create();
+		}
+	}
+
+	int osIdx = 0;
+	int maxIdx = 0;
+	FilterType filterType = IIR_BUTTERWORTH;
+
+	bool adaptive = false;
+	float sampleRate = 44100.f;
+	// base rate frames left before adapt() may lower the ratio
+	int holdFrames = 0;
+
+	BaseOversampling<T>* active = nullptr;
+	// the 16x oversamplers have the largest buffers and filter cascades, so have room for any of the others
+	typename std::aligned_union<0, OversamplerType < 1 << 4, IIR_BUTTERWORTH >,
+	         OversamplerType < 1 << 4, POLYPHASE_HALF_BAND >,
+	         OversamplerType < 1 << 4, FIR_LINEAR_PHASE >>::type storage;
 };
 
 } // namespace chowdsp
@@ -0,0 +1,94 @@
+#pragma once
+#include <rack.hpp>
+#include <atomic>
+#include <cmath>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+/** Denormal protection.
+
+ IIR filter state decays towards zero once a filter's input goes silent. Left alone it ends up in the denormal
+ range (below ~1.2e-38), where x86 CPUs take up to ~100x longer per operation, so a quiet patch can suddenly cost
+ far more CPU minutes after it went quiet. There are two layers of protection:
+
+ - FlushDenormals switches a thread to flush-to-zero and denormals-are-zero (FZ on ARM64). TelemetryModule calls
+   it from every process(), but it only touches the control register the first time on each thread, so it costs a
+   thread-local load and a branch per call. Rack's engine threads already run in that mode, hosts and tools that
+   don't (e.g. the benchmark) are covered too.
+ - The filter templates (chowdsp::AAFilter and IIRFilterBank, DCBlockerT and Noise Plethora's state variable
+   filters) set their state to zero once it decays below DENORMAL_SNAP_THRESHOLD, checked every
+   DenormalSnapTimer::INTERVAL samples, so they are safe whatever the floating point mode. */
+
+/** Filter state below this magnitude is set to zero: far below anything audible, and far enough above the denormal
+ range that slowly decaying state is caught before it gets there */
+static constexpr float DENORMAL_SNAP_THRESHOLD = 1e-30f;
+
+inline float snapToZero(float x) {
+	return (std::fabs(x) < DENORMAL_SNAP_THRESHOLD) ? 0.f : x;
+}
+
+inline simd::float_4 snapToZero(simd::float_4 x) {
+	return simd::ifelse(simd::fabs(x) < DENORMAL_SNAP_THRESHOLD, simd::float_4::zero(), x);
+}
+
+/** Says when a filter's state is due to be snapped to zero, so the per-sample cost is one add and a predictable
+ branch. State decaying slowly enough to linger in the denormal range is caught well before it gets there, and
+ state decaying quickly passes through it in a handful of samples. */
+struct DenormalSnapTimer {
+	static const int INTERVAL = 256;
+
+	/** Counts `frames` samples, returns true once every INTERVAL samples */
+	bool process(int frames = 1) {
+		samples += frames;
+		if (samples < INTERVAL) {
+			return false;
+		}
+		samples = 0;
+		return true;
+	}
+
+private:
+	int samples = 0;
+};
+
+/** Flush-to-zero and denormals-are-zero for the calling thread. Like Rack's engine, the mode is left set for the
+ rest of the thread's life rather than restored. */
+struct FlushDenormals {
+	/** Can be cleared to measure the cost of denormals (see `befaco-benchmark --denormals`) */
+	static std::atomic<bool> enabled;
+
+	/** Sets the mode the first time it is called on a thread while enabled, later calls return straight away */
+	static void onThisThread() {
+		static thread_local bool done = false;
+		if (done || !enabled.load(std::memory_order_relaxed)) {
+			return;
+		}
+		done = true;
+		set(true);
+	}
+
+	/** Sets or clears the mode on the calling thread now */
+	static void set(bool flushToZero) {
+#if defined(__x86_64__) || defined(__i386__)
+		const unsigned int mxcsr = _mm_getcsr();
+		_mm_setcsr(flushToZero ? (mxcsr | FTZ_DAZ) : (mxcsr & ~FTZ_DAZ));
+#elif defined(__aarch64__)
+		uint64_t fpcr;
+		__asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+		__asm__ __volatile__("msr fpcr, %0" : : "r"(flushToZero ? (fpcr | FPCR_FZ) : (fpcr & ~FPCR_FZ)));
+#else
+		(void) flushToZero;
+#endif
+	}
+
+private:
+#if defined(__x86_64__) || defined(__i386__)
+	// MXCSR flush-to-zero (bit 15) and denormals-are-zero (bit 6)
+	static const unsigned int FTZ_DAZ = 0x8040;
+#elif defined(__aarch64__)
+	// FPCR flush-to-zero, which on ARM64 covers denormal inputs as well
+	static const uint64_t FPCR_FZ = 1ull << 24;
+#endif
+};
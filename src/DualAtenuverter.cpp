@@ -121,4 +121,4 @@ struct DualAtenuverterWidget : ModuleWidget {
 };
 
 
-Model* modelDualAtenuverter = createModel<DualAtenuverter, DualAtenuverterWidget>("DualAtenuverter");
\ No newline at end of file
+Model* modelDualAtenuverter = createModelWithTelemetry<DualAtenuverter, DualAtenuverterWidget>("DualAtenuverter");
\ No newline at end of file
@@ -36,6 +36,8 @@ struct EvenVCO : Module {
 	bool halfPhase[PORT_MAX_CHANNELS] = {};
 	bool removePulseDC = true;
 
+	BlockProcessor<NUM_INPUTS, NUM_OUTPUTS> block;
+
 	dsp::MinBlepGenerator<16, 32> triSquareMinBlep[PORT_MAX_CHANNELS];
 	dsp::MinBlepGenerator<16, 32> doubleSawMinBlep[PORT_MAX_CHANNELS];
 	dsp::MinBlepGenerator<16, 32> sawMinBlep[PORT_MAX_CHANNELS];
@@ -62,153 +64,168 @@ struct EvenVCO : Module {
 	}
 
 	void process(const ProcessArgs& args) override {
+		block.process(this, args);
+	}
+
+	void processBlock(const ProcessArgs& args, const int frames) {
 
-		int channels_pitch1 = inputs[PITCH1_INPUT].getChannels();
-		int channels_pitch2 = inputs[PITCH2_INPUT].getChannels();
+		// params, connections and polyphony are only read once per block
+		int channels_pitch1 = block.getChannels(PITCH1_INPUT);
+		int channels_pitch2 = block.getChannels(PITCH2_INPUT);
 
 		int channels = 1;
 		channels = std::max(channels, channels_pitch1);
 		channels = std::max(channels, channels_pitch2);
 
 		float pitch_0 = 1.f + std::round(params[OCTAVE_PARAM].getValue()) + params[TUNE_PARAM].getValue() / 12.f;
+		const float pwParam = params[PWM_PARAM].getValue();
 
-		// Compute frequency, pitch is 1V/oct
-		float_4 pitch[4] = {};
-		for (int c = 0; c < channels; c += 4)
-			pitch[c / 4] = pitch_0;
+		const bool pitch1Connected = block.isConnected(PITCH1_INPUT);
+		const bool pitch2Connected = block.isConnected(PITCH2_INPUT);
+		const bool fmConnected = block.isConnected(FM_INPUT);
+		const bool pwmConnected = block.isConnected(PWM_INPUT);
 
-		if (inputs[PITCH1_INPUT].isConnected()) {
+		for (int frame = 0; frame < frames; ++frame) {
+			// Compute frequency, pitch is 1V/oct
+			float_4 pitch[4] = {};
 			for (int c = 0; c < channels; c += 4)
-				pitch[c / 4] += inputs[PITCH1_INPUT].getPolyVoltageSimd<float_4>(c);
-		}
+				pitch[c / 4] = pitch_0;
 
-		if (inputs[PITCH2_INPUT].isConnected()) {
-			for (int c = 0; c < channels; c += 4)
-				pitch[c / 4] += inputs[PITCH2_INPUT].getPolyVoltageSimd<float_4>(c);
-		}
+			if (pitch1Connected) {
+				for (int c = 0; c < channels; c += 4)
+					pitch[c / 4] += block.getPolyVoltageSimd<float_4>(PITCH1_INPUT, frame, c);
+			}
 
-		if (inputs[FM_INPUT].isConnected()) {
-			for (int c = 0; c < channels; c += 4)
-				pitch[c / 4] += inputs[FM_INPUT].getPolyVoltageSimd<float_4>(c) / 4.f;
-		}
+			if (pitch2Connected) {
+				for (int c = 0; c < channels; c += 4)
+					pitch[c / 4] += block.getPolyVoltageSimd<float_4>(PITCH2_INPUT, frame, c);
+			}
 
-		float_4 freq[4] = {};
-		for (int c = 0; c < channels; c += 4) {
-			freq[c / 4] = dsp::FREQ_C4 * simd::pow(2.f, pitch[c / 4]);
-			freq[c / 4] = clamp(freq[c / 4], 0.f, 20000.f);
-		}
+			if (fmConnected) {
+				for (int c = 0; c < channels; c += 4)
+					pitch[c / 4] += block.getPolyVoltageSimd<float_4>(FM_INPUT, frame, c) / 4.f;
+			}
 
-		// Pulse width
-		float_4 pw[4] = {};
-		for (int c = 0; c < channels; c += 4)
-			pw[c / 4] = params[PWM_PARAM].getValue();
+			// all voices at once, so 16 channels run as one 16 lane (AVX-512) or two 8 lane (AVX2) blocks
+			float_4 freq[4] = {};
+			exp2_fast(fastmath::asFloats(pitch), fastmath::asFloats(freq), channels);
+			for (int c = 0; c < channels; c += 4) {
+				freq[c / 4] = clamp(dsp::FREQ_C4 * freq[c / 4], 0.f, 20000.f);
+			}
 
-		if (inputs[PWM_INPUT].isConnected()) {
+			// Pulse width
+			float_4 pw[4] = {};
 			for (int c = 0; c < channels; c += 4)
-				pw[c / 4] += inputs[PWM_INPUT].getPolyVoltageSimd<float_4>(c) / 5.f;
-		}
-
-		float_4 deltaPhase[4] = {};
-		float_4 oldPhase[4] = {};
-		for (int c = 0; c < channels; c += 4) {
-			pw[c / 4] = rescale(clamp(pw[c / 4], -1.0f, 1.0f), -1.0f, 1.0f, 0.05f, 1.0f - 0.05f);
+				pw[c / 4] = pwParam;
 
-			// Advance phase
-			deltaPhase[c / 4] = clamp(freq[c / 4] * args.sampleTime, 1e-6f, 0.5f);
-			oldPhase[c / 4] = phase[c / 4];
-			phase[c / 4] += deltaPhase[c / 4];
-		}
+			if (pwmConnected) {
+				for (int c = 0; c < channels; c += 4)
+					pw[c / 4] += block.getPolyVoltageSimd<float_4>(PWM_INPUT, frame, c) / 5.f;
+			}
 
-		// the next block can't be done with SIMD instructions, but should at least be completed with
-		// blocks of 4 (otherwise popping artfifacts are generated from invalid phase/oldPhase/deltaPhase)
-		const int channelsRoundedUpNearestFour = (1 + (channels - 1) / 4) * 4;
-		for (int c = 0; c < channelsRoundedUpNearestFour; c++) {
+			float_4 deltaPhase[4] = {};
+			float_4 oldPhase[4] = {};
+			for (int c = 0; c < channels; c += 4) {
+				pw[c / 4] = rescale(clamp(pw[c / 4], -1.0f, 1.0f), -1.0f, 1.0f, 0.05f, 1.0f - 0.05f);
 
-			if (oldPhase[c / 4].s[c % 4] < 0.5 && phase[c / 4].s[c % 4] >= 0.5) {
-				float crossing = -(phase[c / 4].s[c % 4] - 0.5) / deltaPhase[c / 4].s[c % 4];
-				triSquareMinBlep[c].insertDiscontinuity(crossing, 2.f);
-				doubleSawMinBlep[c].insertDiscontinuity(crossing, -2.f);
+				// Advance phase
+				deltaPhase[c / 4] = clamp(freq[c / 4] * args.sampleTime, 1e-6f, 0.5f);
+				oldPhase[c / 4] = phase[c / 4];
+				phase[c / 4] += deltaPhase[c / 4];
 			}
 
-			if (!halfPhase[c] && phase[c / 4].s[c % 4] >= pw[c / 4].s[c % 4]) {
-				float crossing  = -(phase[c / 4].s[c % 4] - pw[c / 4].s[c % 4]) / deltaPhase[c / 4].s[c % 4];
-				squareMinBlep[c].insertDiscontinuity(crossing, 2.f);
-				halfPhase[c] = true;
+			// the next block can't be done with SIMD instructions, but should at least be completed with
+			// blocks of 4 (otherwise popping artfifacts are generated from invalid phase/oldPhase/deltaPhase)
+			const int channelsRoundedUpNearestFour = (1 + (channels - 1) / 4) * 4;
+			for (int c = 0; c < channelsRoundedUpNearestFour; c++) {
+
+				if (oldPhase[c / 4].s[c % 4] < 0.5 && phase[c / 4].s[c % 4] >= 0.5) {
+					float crossing = -(phase[c / 4].s[c % 4] - 0.5) / deltaPhase[c / 4].s[c % 4];
+					triSquareMinBlep[c].insertDiscontinuity(crossing, 2.f);
+					doubleSawMinBlep[c].insertDiscontinuity(crossing, -2.f);
+				}
+
+				if (!halfPhase[c] && phase[c / 4].s[c % 4] >= pw[c / 4].s[c % 4]) {
+					float crossing  = -(phase[c / 4].s[c % 4] - pw[c / 4].s[c % 4]) / deltaPhase[c / 4].s[c % 4];
+					squareMinBlep[c].insertDiscontinuity(crossing, 2.f);
+					halfPhase[c] = true;
+				}
+
+				// Reset phase if at end of cycle
+				if (phase[c / 4].s[c % 4] >= 1.f) {
+					phase[c / 4].s[c % 4] -= 1.f;
+					float crossing = -phase[c / 4].s[c % 4] / deltaPhase[c / 4].s[c % 4];
+					triSquareMinBlep[c].insertDiscontinuity(crossing, -2.f);
+					doubleSawMinBlep[c].insertDiscontinuity(crossing, -2.f);
+					squareMinBlep[c].insertDiscontinuity(crossing, -2.f);
+					sawMinBlep[c].insertDiscontinuity(crossing, -2.f);
+					halfPhase[c] = false;
+				}
 			}
 
-			// Reset phase if at end of cycle
-			if (phase[c / 4].s[c % 4] >= 1.f) {
-				phase[c / 4].s[c % 4] -= 1.f;
-				float crossing = -phase[c / 4].s[c % 4] / deltaPhase[c / 4].s[c % 4];
-				triSquareMinBlep[c].insertDiscontinuity(crossing, -2.f);
-				doubleSawMinBlep[c].insertDiscontinuity(crossing, -2.f);
-				squareMinBlep[c].insertDiscontinuity(crossing, -2.f);
-				sawMinBlep[c].insertDiscontinuity(crossing, -2.f);
-				halfPhase[c] = false;
+			float_4 triSquareMinBlepOut[4] = {};
+			float_4 doubleSawMinBlepOut[4] = {};
+			float_4 sawMinBlepOut[4] = {};
+			float_4 squareMinBlepOut[4] = {};
+
+			float_4 triSquare[4] = {};
+			float_4 sine[4] = {};
+			cos2pi_fast(fastmath::asFloats(phase), fastmath::asFloats(sine), channels);
+			float_4 doubleSaw[4] = {};
+
+			float_4 even[4] = {};
+			float_4 saw[4] = {};
+			float_4 square[4] = {};
+			float_4 triOut[4] = {};
+
+			for (int c = 0; c < channelsRoundedUpNearestFour; c++) {
+				triSquareMinBlepOut[c / 4].s[c % 4] = triSquareMinBlep[c].process();
+				doubleSawMinBlepOut[c / 4].s[c % 4] = doubleSawMinBlep[c].process();
+				sawMinBlepOut[c / 4].s[c % 4] = sawMinBlep[c].process();
+				squareMinBlepOut[c / 4].s[c % 4] = squareMinBlep[c].process();
 			}
-		}
 
-		float_4 triSquareMinBlepOut[4] = {};
-		float_4 doubleSawMinBlepOut[4] = {};
-		float_4 sawMinBlepOut[4] = {};
-		float_4 squareMinBlepOut[4] = {};
-
-		float_4 triSquare[4] = {};
-		float_4 sine[4] = {};
-		float_4 doubleSaw[4] = {};
-
-		float_4 even[4] = {};
-		float_4 saw[4] = {};
-		float_4 square[4] = {};
-		float_4 triOut[4] = {};
-
-		for (int c = 0; c < channelsRoundedUpNearestFour; c++) {
-			triSquareMinBlepOut[c / 4].s[c % 4] = triSquareMinBlep[c].process();
-			doubleSawMinBlepOut[c / 4].s[c % 4] = doubleSawMinBlep[c].process();
-			sawMinBlepOut[c / 4].s[c % 4] = sawMinBlep[c].process();
-			squareMinBlepOut[c / 4].s[c % 4] = squareMinBlep[c].process();
-		}
-
-		for (int c = 0; c < channels; c += 4) {
+			for (int c = 0; c < channels; c += 4) {
 
-			triSquare[c / 4] = simd::ifelse((phase[c / 4] < 0.5f), -1.f, +1.f);
-			triSquare[c / 4] += triSquareMinBlepOut[c / 4];
+				triSquare[c / 4] = simd::ifelse((phase[c / 4] < 0.5f), -1.f, +1.f);
+				triSquare[c / 4] += triSquareMinBlepOut[c / 4];
 
-			// Integrate square for triangle
+				// Integrate square for triangle
 
-			tri[c / 4] += (4.f * triSquare[c / 4]) * (freq[c / 4] * args.sampleTime);
-			tri[c / 4] *= (1.f - 40.f * args.sampleTime);
-			triOut[c / 4] = 5.f * tri[c / 4];
+				tri[c / 4] += (4.f * triSquare[c / 4]) * (freq[c / 4] * args.sampleTime);
+				tri[c / 4] *= (1.f - 40.f * args.sampleTime);
+				triOut[c / 4] = 5.f * tri[c / 4];
 
-			sine[c / 4] = 5.f * simd::cos(2 * M_PI * phase[c / 4]);
+				sine[c / 4] *= 5.f;
 
-			// minBlep adds a small amount of DC that becomes significant at higher frequencies,
-			// this subtracts DC based on empirical observvations about the scaling relationship
-			const float sawCorrect = -5.7;
-			const float_4 sawDCComp = deltaPhase[c / 4] * sawCorrect;
+				// minBlep adds a small amount of DC that becomes significant at higher frequencies,
+				// this subtracts DC based on empirical observvations about the scaling relationship
+				const float sawCorrect = -5.7;
+				const float_4 sawDCComp = deltaPhase[c / 4] * sawCorrect;
 
-			doubleSaw[c / 4] = simd::ifelse((phase[c / 4] < 0.5), (-1.f + 4.f * phase[c / 4]), (-1.f + 4.f * (phase[c / 4] - 0.5f)));
-			doubleSaw[c / 4] += doubleSawMinBlepOut[c / 4];
-			doubleSaw[c / 4] += 2.f * sawDCComp;
-			doubleSaw[c / 4] *= 5.f;
+				doubleSaw[c / 4] = simd::ifelse((phase[c / 4] < 0.5), (-1.f + 4.f * phase[c / 4]), (-1.f + 4.f * (phase[c / 4] - 0.5f)));
+				doubleSaw[c / 4] += doubleSawMinBlepOut[c / 4];
+				doubleSaw[c / 4] += 2.f * sawDCComp;
+				doubleSaw[c / 4] *= 5.f;
 
-			even[c / 4] = 0.55 * (doubleSaw[c / 4] + 1.27 * sine[c / 4]);
-			saw[c / 4] = -1.f + 2.f * phase[c / 4];
-			saw[c / 4] += sawMinBlepOut[c / 4];
-			saw[c / 4] += sawDCComp;
-			saw[c / 4] *= 5.f;
+				even[c / 4] = 0.55 * (doubleSaw[c / 4] + 1.27 * sine[c / 4]);
+				saw[c / 4] = -1.f + 2.f * phase[c / 4];
+				saw[c / 4] += sawMinBlepOut[c / 4];
+				saw[c / 4] += sawDCComp;
+				saw[c / 4] *= 5.f;
 
-			square[c / 4] = simd::ifelse((phase[c / 4] < pw[c / 4]),  -1.f, +1.f);
-			square[c / 4] += squareMinBlepOut[c / 4];
-			square[c / 4] += removePulseDC * 2.f * (pw[c / 4] - 0.5f);
-			square[c / 4] *= 5.f;
+				square[c / 4] = simd::ifelse((phase[c / 4] < pw[c / 4]),  -1.f, +1.f);
+				square[c / 4] += squareMinBlepOut[c / 4];
+				square[c / 4] += removePulseDC * 2.f * (pw[c / 4] - 0.5f);
+				square[c / 4] *= 5.f;
 
-			// Set outputs
-			outputs[TRI_OUTPUT].setVoltageSimd(triOut[c / 4], c);
-			outputs[SINE_OUTPUT].setVoltageSimd(sine[c / 4], c);
-			outputs[EVEN_OUTPUT].setVoltageSimd(even[c / 4], c);
-			outputs[SAW_OUTPUT].setVoltageSimd(saw[c / 4], c);
-			outputs[SQUARE_OUTPUT].setVoltageSimd(square[c / 4], c);
+				// Set outputs
+				block.setVoltageSimd(TRI_OUTPUT, frame, triOut[c / 4], c);
+				block.setVoltageSimd(SINE_OUTPUT, frame, sine[c / 4], c);
+				block.setVoltageSimd(EVEN_OUTPUT, frame, even[c / 4], c);
+				block.setVoltageSimd(SAW_OUTPUT, frame, saw[c / 4], c);
+				block.setVoltageSimd(SQUARE_OUTPUT, frame, square[c / 4], c);
+			}
 		}
 
 		// Outputs
@@ -223,6 +240,7 @@ struct EvenVCO : Module {
 	json_t* dataToJson() override {
 		json_t* rootJ = json_object();
 		json_object_set_new(rootJ, "removePulseDC", json_boolean(removePulseDC));
+		json_object_set_new(rootJ, "blockSize", json_integer(block.getBlockSize()));
 		return rootJ;
 	}
 
@@ -231,6 +249,11 @@ struct EvenVCO : Module {
 		if (pulseDCJ) {
 			removePulseDC = json_boolean_value(pulseDCJ);
 		}
+
+		json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+		if (blockSizeJ) {
+			block.setBlockSize(json_integer_value(blockSizeJ));
+		}
 	}
 };
 
@@ -273,8 +296,9 @@ struct EvenVCOWidget : ModuleWidget {
 			menu->addChild(createBoolPtrMenuItem("Remove DC from pulse", "", &module->removePulseDC));
 			}
 		));
+		menu->addChild(createBlockSizeMenuItem(&module->block));
 	}
 };
 
 
-Model* modelEvenVCO = createModel<EvenVCO, EvenVCOWidget>("EvenVCO");
+Model* modelEvenVCO = createModelWithTelemetry<EvenVCO, EvenVCOWidget>("EvenVCO");
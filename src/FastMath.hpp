@@ -0,0 +1,190 @@
+#pragma once
+#include <rack.hpp>
+#include <cstring>
+
+
+/** Fast approximations for the transcendental functions in the modules' hot paths.
+
+ Each kernel is templated on T and runs on float or simd::float_4. Each also has a block overload that takes
+ contiguous float arrays, e.g. sin2pi_pade_05_5_4(in, out, n). On x86 the block overload picks an AVX2 (8 lane)
+ or AVX-512 (16 lane) build of the same loop at runtime, falling back to the SSE build. A bank of 16 voices stored
+ as simd::float_4[4] is contiguous, so it can be passed as one block of 16 floats (see asFloats()).
+
+ Error bounds are the worst case over the stated input range, measured in float32 against double precision. */
+
+/** sin(2 pi x) for x in [0, 1], max absolute error 4.1e-3 (at the ends of the range, 1.4e-3 within [0.05, 0.95]). */
+template <typename T>
+T sin2pi_pade_05_5_4(T x) {
+	x -= 0.5f;
+	const T x2 = x * x;
+	return x * (T(-6.283185307) + x2 * (T(33.19863968) - T(32.44191367) * x2))
+	       / (T(1.) + x2 * (T(1.296008659) + T(0.7028072946) * x2));
+}
+
+/** cos(2 pi x) for any x, max absolute error 2.0e-7. Accurate enough to replace simd::cos on an oscillator's
+ sine output, unlike sin2pi_pade_05_5_4(). */
+template <typename T>
+T cos2pi_fast(T x) {
+	// fold to x in [-0.5, 0.5), then cos(2 pi x) = sin(t) with t = 2 pi (0.25 - |x|) in [-pi/2, pi/2]
+	x -= simd::floor(x + 0.5f);
+	const T t = T(2. * M_PI) * (T(0.25f) - simd::fabs(x));
+	const T t2 = t * t;
+	// Taylor series of sin(t) to the t^11 term
+	return t * (T(1.) + t2 * (T(-1. / 6.) + t2 * (T(1. / 120.) + t2 * (T(-1. / 5040.) + t2 * (T(1. / 362880.)
+	            + t2 * T(-1. / 39916800.))))));
+}
+
+/** tanh(x), max absolute error 6.2e-4 for |x| < 1 and 6.8e-3 for |x| < 3. Not monotonic beyond |x| ~ 3.38,
+ and tends to 0 as |x| grows, so callers must keep the argument in range. */
+template <typename T>
+T tanh_pade(T x) {
+	const T x2 = x * x;
+	const T q = T(12.) + x2;
+	return T(12.) * x * q / (T(36.) * x2 + q * q);
+}
+
+/** dsp::exponentialBipolar(80, x) for x in [-1, 1], max absolute error 2.0e-2 (at x = +-1, where the gain is ~1). */
+template <typename T>
+T exponentialBipolar80Pade_5_4(T x) {
+	const T x2 = x * x;
+	return x * (T(0.109568) + x2 * (T(0.281588) + T(0.133841) * x2))
+	       / (T(1.) - x2 * (T(0.630374) - T(0.166271) * x2));
+}
+
+namespace fastmath {
+
+// clamp() through std::min and std::max rather than std::fmin and std::fmax, whose NaN handling stops the compiler
+// vectorising the block loops
+inline float clampRange(float x, float lo, float hi) {
+	return std::min(std::max(x, lo), hi);
+}
+
+inline simd::float_4 clampRange(simd::float_4 x, float lo, float hi) {
+	return simd::clamp(x, lo, hi);
+}
+
+// 2^floor(x) built directly from the exponent bits, x is already clamped to the normal range
+inline float exp2Floor(float x, float* xf) {
+	const float xi = std::floor(x);
+	*xf = x - xi;
+	const int32_t bits = ((int32_t) xi + 127) << 23;
+	float y;
+	std::memcpy(&y, &bits, sizeof(y));
+	return y;
+}
+
+inline simd::float_4 exp2Floor(simd::float_4 x, simd::float_4* xf) {
+	const simd::float_4 xi = simd::floor(x);
+	*xf = x - xi;
+	return simd::float_4::cast((simd::int32_4(xi) + 127) << 23);
+}
+
+} // namespace fastmath
+
+/** 2^x for x in [-126, 126] (clamped outside), max relative error 8.1e-7. Replaces
+ std::pow(2, x) and simd::pow(2, x) in pitch and gain calculations. */
+template <typename T>
+T exp2_fast(T x) {
+	T xf;
+	const T yi = fastmath::exp2Floor(fastmath::clampRange(x, -126.f, 126.f), &xf);
+	// minimax polynomial for 2^xf on [0, 1)
+	const T yf = T(1.) + xf * (T(0.69315169353961) + xf * (T(0.2401595990753167) + xf * (T(0.055817908652)
+	             + xf * (T(0.008991698010) + xf * T(0.001879100722)))));
+	return yi * yf;
+}
+
+/** 10^(dB / 20), i.e. decibels to a linear gain, with the same error as exp2_fast() */
+template <typename T>
+T dbToGain_fast(T dB) {
+	return exp2_fast<T>(T(0.16609640474f) * dB);
+}
+
+namespace fastmath {
+
+template <float (*Kernel)(float)>
+void map(const float* in, float* out, int n) {
+	for (int i = 0; i < n; ++i) {
+		out[i] = Kernel(in[i]);
+	}
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// same loop as map(), the compiler widens it to 8 or 16 lanes for these targets
+template <float (*Kernel)(float)>
+__attribute__((target("avx2,fma"))) void mapAvx2(const float* in, float* out, int n) {
+	for (int i = 0; i < n; ++i) {
+		out[i] = Kernel(in[i]);
+	}
+}
+
+template <float (*Kernel)(float)>
+__attribute__((target("avx512f"))) void mapAvx512(const float* in, float* out, int n) {
+	for (int i = 0; i < n; ++i) {
+		out[i] = Kernel(in[i]);
+	}
+}
+
+enum Isa {
+	ISA_SSE,
+	ISA_AVX2,
+	ISA_AVX512
+};
+
+inline Isa detectIsa() {
+	static const Isa isa = []() {
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx512f")) {
+			return ISA_AVX512;
+		}
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+			return ISA_AVX2;
+		}
+		return ISA_SSE;
+	}();
+	return isa;
+}
+#endif
+
+/** Runs Kernel over a block with the widest instruction set available */
+template <float (*Kernel)(float)>
+void dispatch(const float* in, float* out, int n) {
+#if defined(__x86_64__) || defined(__i386__)
+	switch (detectIsa()) {
+		case ISA_AVX512: mapAvx512<Kernel>(in, out, n); return;
+		case ISA_AVX2: mapAvx2<Kernel>(in, out, n); return;
+		default: break;
+	}
+#endif
+	map<Kernel>(in, out, n);
+}
+
+/** View an array of simd::float_4 as contiguous floats, for the block overloads */
+inline float* asFloats(simd::float_4* x) {
+	return &x[0].s[0];
+}
+
+inline const float* asFloats(const simd::float_4* x) {
+	return &x[0].s[0];
+}
+
+} // namespace fastmath
+
+inline void sin2pi_pade_05_5_4(const float* in, float* out, int n) {
+	fastmath::dispatch<sin2pi_pade_05_5_4<float>>(in, out, n);
+}
+
+inline void cos2pi_fast(const float* in, float* out, int n) {
+	fastmath::dispatch<cos2pi_fast<float>>(in, out, n);
+}
+
+inline void tanh_pade(const float* in, float* out, int n) {
+	fastmath::dispatch<tanh_pade<float>>(in, out, n);
+}
+
+inline void exponentialBipolar80Pade_5_4(const float* in, float* out, int n) {
+	fastmath::dispatch<exponentialBipolar80Pade_5_4<float>>(in, out, n);
+}
+
+inline void exp2_fast(const float* in, float* out, int n) {
+	fastmath::dispatch<exp2_fast<float>>(in, out, n);
+}
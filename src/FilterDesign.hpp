@@ -0,0 +1,262 @@
+#pragma once
+#include <complex>
+#include <cmath>
+#include <cassert>
+
+
+namespace chowdsp {
+
+/** Lowpass designs for the IIR anti-aliasing filters (AAFilter). All are even order, one biquad per pole pair.
+
+ - Butterworth: maximally flat, -3 dB at the cutoff, the slowest roll-off of the three
+ - Chebyshev II: flat passband (-3 dB at the cutoff) with a 60 dB equiripple stopband, so it gets there in fewer
+   sections than a Butterworth filter
+ - Elliptic: 0.1 dB of passband ripple up to the cutoff and a 60 dB equiripple stopband, the steepest roll-off
+   for a given order, so it needs the fewest sections */
+enum AAFilterDesign {
+	BUTTERWORTH,
+	CHEBYSHEV_II,
+	ELLIPTIC,
+	NUM_AA_FILTER_DESIGNS
+};
+
+/** Coefficients of one biquad section, b0, b1, b2 and 1, a1, a2 */
+struct BiquadCoefficients {
+	float b[3];
+	float a[3];
+};
+
+namespace filterdesign {
+
+typedef std::complex<double> Complex;
+
+static const double STOPBAND_DB = 60.;
+static const double ELLIPTIC_RIPPLE_DB = 0.1;
+
+// Jacobi elliptic functions through the descending Landen transformation, after S. J. Orfanidis, "Lecture Notes on
+// Elliptic Filter Design" (2006). Arguments are normalised to the quarter period, i.e. cde(u, k) = cd(u K(k), k).
+static const int LANDEN_STEPS = 8;
+
+inline void landen(double k, double* v) {
+	for (int i = 0; i < LANDEN_STEPS; i++) {
+		const double kp = std::sqrt(1. - k * k);
+		k = (k / (1. + kp)) * (k / (1. + kp));
+		v[i] = k;
+	}
+}
+
+inline Complex cde(Complex u, double k) {
+	double v[LANDEN_STEPS];
+	landen(k, v);
+	Complex w = std::cos(u * (M_PI / 2.));
+	for (int i = LANDEN_STEPS - 1; i >= 0; i--) {
+		w = (1. + v[i]) * w / (1. + v[i] * w * w);
+	}
+	return w;
+}
+
+inline Complex sne(Complex u, double k) {
+	double v[LANDEN_STEPS];
+	landen(k, v);
+	Complex w = std::sin(u * (M_PI / 2.));
+	for (int i = LANDEN_STEPS - 1; i >= 0; i--) {
+		w = (1. + v[i]) * w / (1. + v[i] * w * w);
+	}
+	return w;
+}
+
+// inverse of sne() in u, through the ascending Landen transformation
+inline Complex asne(Complex w, double k) {
+	double v[LANDEN_STEPS];
+	landen(k, v);
+	double vPrev = k;
+	for (int i = 0; i < LANDEN_STEPS; i++) {
+		w = w / (1. + std::sqrt(1. - w * w * vPrev * vPrev)) * 2. / (1. + v[i]);
+		vPrev = v[i];
+	}
+	return std::asin(w) * (2. / M_PI);
+}
+
+// elliptic modulus k of an order `order` filter with discrimination k1, from the degree equation
+inline double ellipticModulus(int order, double k1) {
+	const double k1p = std::sqrt(1. - k1 * k1);
+	double kp = std::pow(k1p, order);
+	for (int i = 1; i <= order / 2; i++) {
+		kp *= std::pow(sne((2. * i - 1.) / order, k1p).real(), 4);
+	}
+	return std::sqrt(1. - kp * kp);
+}
+
+/** Analog prototype of section i (of order / 2), with the cutoff at 1 rad/s: a pole in the upper left half plane,
+ whose conjugate is the section's other pole, and a zero on the imaginary axis (0 for none) */
+inline void analogSection(AAFilterDesign design, int order, int i, Complex* pole, double* zero) {
+	// angle of the i-th pole of the Butterworth and Chebyshev prototypes
+	const double theta = M_PI * (2. * i + 1.) / (2. * order);
+
+	switch (design) {
+		case CHEBYSHEV_II: {
+			const double eps = 1. / std::sqrt(std::pow(10., STOPBAND_DB / 10.) - 1.);
+			const double mu = std::asinh(1. / eps) / order;
+			// stopband edge at 1 for the textbook prototype, scaled so that the -3 dB point is at 1 instead
+			const double scale = std::cosh(std::acosh(1. / eps) / order);
+			*pole = scale / Complex(-std::sinh(mu) * std::sin(theta), std::cosh(mu) * std::cos(theta));
+			*zero = scale / std::cos(theta);
+		} break;
+
+		case ELLIPTIC: {
+			const double ep = std::sqrt(std::pow(10., ELLIPTIC_RIPPLE_DB / 10.) - 1.);
+			const double es = std::sqrt(std::pow(10., STOPBAND_DB / 10.) - 1.);
+			const double k = ellipticModulus(order, ep / es);
+			const double u = (2. * i + 1.) / order;
+			const double v0 = (asne(Complex(0., 1. / ep), ep / es) / Complex(0., order)).real();
+			*pole = Complex(0., 1.) * cde(Complex(u, -v0), k);
+			*zero = 1. / (k * cde(u, k).real());
+		} break;
+
+		default: {
+			*pole = Complex(-std::sin(theta), std::cos(theta));
+			*zero = 0.;
+		} break;
+	}
+}
+
+/** Digital lowpass of `numSections` biquads with the given design, cutoff at normalised frequency `fc` (cycles per
+ sample), through the bilinear transform. Each section has unity gain at DC. */
+inline void designLowpass(AAFilterDesign design, int numSections, double fc, BiquadCoefficients* sections) {
+	// prewarped, so that the prototype's cutoff lands on fc
+	const double K = std::tan(M_PI * fc);
+	const int order = 2 * numSections;
+
+	for (int i = 0; i < numSections; i++) {
+		// the pole pairs closest to the imaginary axis (highest Q) last, as in AAFilter's Butterworth cascade
+		Complex pole;
+		double zero;
+		analogSection(design, order, numSections - 1 - i, &pole, &zero);
+
+		// H(s) = g (s^2 + zero^2) / (s^2 - 2 Re(pole) s + |pole|^2) with s = u / K, u = (1 - z^-1) / (1 + z^-1)
+		const double d2 = 1. / (K * K), d1 = -2. * pole.real() / K, d0 = std::norm(pole);
+		double n2 = 0., n0 = d0;
+		if (zero > 0.) {
+			// the elliptic and Chebyshev II zeros: unity gain at DC
+			n2 = d0 / (zero * zero) / (K * K);
+		}
+
+		const double norm = 1. / (d2 + d1 + d0);
+		sections[i].b[0] = (n2 + n0) * norm;
+		sections[i].b[1] = 2. * (n0 - n2) * norm;
+		sections[i].b[2] = (n2 + n0) * norm;
+		sections[i].a[0] = 1.f;
+		sections[i].a[1] = 2. * (d0 - d2) * norm;
+		sections[i].a[2] = (d2 - d1 + d0) * norm;
+	}
+}
+
+// modified Bessel function of the first kind, order 0, for the Kaiser window
+inline double besselI0(double x) {
+	double sum = 1., term = 1.;
+	for (int k = 1; k < 32; k++) {
+		term *= (x / (2. * k)) * (x / (2. * k));
+		sum += term;
+	}
+	return sum;
+}
+
+/** Linear phase lowpass of `numTaps` taps: a sinc cut off at normalised frequency `fc` (-6 dB), under a Kaiser
+ window of shape `beta`. Unity gain at DC. */
+inline void designWindowedSinc(int numTaps, double fc, double beta, float* taps) {
+	const double centre = 0.5 * (numTaps - 1);
+	double sum = 0.;
+	for (int n = 0; n < numTaps; n++) {
+		const double t = n - centre;
+		const double sinc = (t == 0.) ? 2. * fc : std::sin(2. * M_PI * fc * t) / (M_PI * t);
+		const double r = t / centre;
+		taps[n] = sinc * besselI0(beta * std::sqrt(1. - r * r)) / besselI0(beta);
+		sum += taps[n];
+	}
+	for (int n = 0; n < numTaps; n++) {
+		taps[n] /= sum;
+	}
+}
+
+} // namespace filterdesign
+
+/**
+    Coefficients of every anti-aliasing filter the oversamplers can use, designed once and shared by all of them.
+    The filters' cutoff is a fixed fraction of the base rate Nyquist frequency, so relative to the oversampled rate
+    a design only depends on the ratio and not on the sample rate: one table covers every sample rate, and
+    AAFilter::reset() (which runs on the audio thread) only copies coefficients out of it.
+*/
+struct AAFilterTable {
+	static const int NUM_RATIOS = 5; // 1x to 16x
+	static const int MAX_SECTIONS = 8;
+
+	/** Biquad sections of a design at oversampling ratio 2^ratioIndex, cutoff at 0.85 * the base rate Nyquist
+	 frequency */
+	static const BiquadCoefficients* get(AAFilterDesign design, int ratioIndex, int numSections) {
+		assert(design >= 0 && design < NUM_AA_FILTER_DESIGNS);
+		assert(ratioIndex >= 0 && ratioIndex < NUM_RATIOS);
+		assert(numSections >= 1 && numSections <= MAX_SECTIONS);
+		static const AAFilterTable table;
+		return table.coefficients[design][ratioIndex][numSections - 1];
+	}
+
+private:
+	AAFilterTable() {
+		for (int design = 0; design < NUM_AA_FILTER_DESIGNS; design++) {
+			for (int ratioIndex = 0; ratioIndex < NUM_RATIOS; ratioIndex++) {
+				for (int numSections = 1; numSections <= MAX_SECTIONS; numSections++) {
+					filterdesign::designLowpass((AAFilterDesign) design, numSections, 0.85 * 0.5 / (1 << ratioIndex),
+					                            coefficients[design][ratioIndex][numSections - 1]);
+				}
+			}
+		}
+	}
+
+	BiquadCoefficients coefficients[NUM_AA_FILTER_DESIGNS][NUM_RATIOS][MAX_SECTIONS][MAX_SECTIONS];
+};
+
+/**
+    Taps of the linear phase lowpass used by FIROversampling, one per oversampling ratio, designed once. TAPS_PER_PHASE
+    taps per phase of the polyphase decomposition (so TAPS_PER_PHASE * ratio in all), cut off at the base rate
+    Nyquist frequency: flat to 0.41 * the base sample rate, 60 dB down at 0.59 * it and 80 dB from 0.65 * it.
+*/
+struct FIRFilterTable {
+	static const int NUM_RATIOS = 5; // 1x to 16x
+	static const int TAPS_PER_PHASE = 24;
+
+	/** The TAPS_PER_PHASE * 2^ratioIndex taps for oversampling ratio 2^ratioIndex */
+	static const float* get(int ratioIndex) {
+		return instance().taps[ratioIndex];
+	}
+
+	/** The same taps sorted by phase: the TAPS_PER_PHASE taps of phase k (taps k, k + ratio, k + 2 * ratio, ...)
+	 start at index k * TAPS_PER_PHASE */
+	static const float* getPolyphase(int ratioIndex) {
+		return instance().polyphaseTaps[ratioIndex];
+	}
+
+private:
+	FIRFilterTable() {
+		for (int ratioIndex = 0; ratioIndex < NUM_RATIOS; ratioIndex++) {
+			const int ratio = 1 << ratioIndex;
+			filterdesign::designWindowedSinc(TAPS_PER_PHASE * ratio, 0.5 / ratio, KAISER_BETA, taps[ratioIndex]);
+			for (int k = 0; k < ratio; k++) {
+				for (int j = 0; j < TAPS_PER_PHASE; j++) {
+					polyphaseTaps[ratioIndex][k * TAPS_PER_PHASE + j] = taps[ratioIndex][k + j * ratio];
+				}
+			}
+		}
+	}
+
+	static const FIRFilterTable& instance() {
+		static const FIRFilterTable table;
+		return table;
+	}
+
+	static constexpr double KAISER_BETA = 7.;
+
+	float taps[NUM_RATIOS][TAPS_PER_PHASE << (NUM_RATIOS - 1)];
+	float polyphaseTaps[NUM_RATIOS][TAPS_PER_PHASE << (NUM_RATIOS - 1)];
+};
+
+} // namespace chowdsp
@@ -9,7 +9,8 @@ static float gainFunction(float x, float shape) {
 		return crossfade(lin, log, shape);
 	}
 	else {
-		float exp = std::pow(x, 4);
+		float x2 = x * x;
+		float exp = x2 * x2;
 		return crossfade(lin, exp, -shape);
 	}
 }
@@ -34,10 +35,11 @@ struct HexmixVCA : Module {
 	};
 
 	const static int numRows = 6;
-	dsp::ClockDivider cvDivider;
-	float outputLevels[numRows] = {};
+	ControlRate<NUM_PARAMS> controlRate;
+	ControlRateValue<float> outputLevels[numRows];
 	float shapes[numRows] = {};
 	bool finalRowIsMix = true;
+	BlockProcessor<NUM_INPUTS, NUM_OUTPUTS> block;
 
 	HexmixVCA() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -53,84 +55,95 @@ struct HexmixVCA : Module {
 
 			configBypass(IN_INPUT + i, OUT_OUTPUT + i);
 		}
-		cvDivider.setDivision(16);
-
-		for (int row = 0; row < numRows; ++row) {
-			outputLevels[row] = 1.f;
-		}
+		controlRate.setDivision(16);
 	}
 
 	void process(const ProcessArgs& args) override {
-		float_4 mix[4] = {};
-		int maxChannels = 1;
+		block.process(this, args);
+	}
+
+	void processBlock(const ProcessArgs& args, const int frames) {
 
-		// only calculate gains/shapes every 16 samples
-		if (cvDivider.process()) {
+		// only calculate gains/shapes every 16 samples (so at most once per block), levels are ramped in between
+		bool updateGains = false;
+		for (int frame = 0; frame < frames; ++frame) {
+			updateGains |= controlRate.process();
+		}
+		if (updateGains) {
 			for (int row = 0; row < numRows; ++row) {
 				shapes[row] = params[SHAPE_PARAM + row].getValue();
-				outputLevels[row] = params[VOL_PARAM + row].getValue();
+
+				const float level = params[VOL_PARAM + row].getValue();
+				if (controlRate.changed(VOL_PARAM + row, level)) {
+					outputLevels[row].setTarget(level, controlRate.getDivision());
+				}
 			}
 		}
 
+		// connections and polyphony only change between blocks
+		int channels[numRows];
+		bool inputIsConnected[numRows], outputIsConnected[numRows];
+		int maxChannels = 1;
 		for (int row = 0; row < numRows; ++row) {
 			bool finalRow = (row == numRows - 1);
-			int channels = 1;
-			float_4 in[4] = {};
-			bool inputIsConnected = inputs[IN_INPUT + row].isConnected();
-			if (inputIsConnected) {
-				channels = inputs[row].getChannels();
-
-				// if we're in "mixer" mode, an input only counts towards the main output polyphony count if it's
-				// not taken out of the mix (i.e. patched in). the final row should count towards polyphony calc.
-				if (finalRowIsMix && (finalRow || !outputs[OUT_OUTPUT + row].isConnected())) {
-					maxChannels = std::max(maxChannels, channels);
-				}
+			inputIsConnected[row] = block.isConnected(IN_INPUT + row);
+			outputIsConnected[row] = outputs[OUT_OUTPUT + row].isConnected();
+			channels[row] = inputIsConnected[row] ? block.getChannels(IN_INPUT + row) : 1;
+
+			// if we're in "mixer" mode, an input only counts towards the main output polyphony count if it's
+			// not taken out of the mix (i.e. patched in). the final row should count towards polyphony calc.
+			if (inputIsConnected[row] && finalRowIsMix && (finalRow || !outputIsConnected[row])) {
+				maxChannels = std::max(maxChannels, channels[row]);
+			}
+
+			if (outputIsConnected[row]) {
+				outputs[OUT_OUTPUT + row].setChannels((finalRow && finalRowIsMix) ? maxChannels : channels[row]);
+			}
+		}
 
-				float cvGain = clamp(inputs[CV_INPUT + row].getNormalVoltage(10.f) / 10.f, 0.f, 1.f);
-				float gain = gainFunction(cvGain, shapes[row]) * outputLevels[row];
+		const bool mixIsOutput = finalRowIsMix && outputIsConnected[numRows - 1];
+		float_4 mix[decltype(block)::MAX_BLOCK_SIZE][4];
+		if (mixIsOutput) {
+			std::memset(mix, 0, frames * sizeof(mix[0]));
+		}
+
+		// each row runs over the whole block, either into its own output or into the mix
+		for (int row = 0; row < numRows; ++row) {
+			bool finalRow = (row == numRows - 1);
+			// if output is connected, we don't add to mix (but the last channel must always go into mix)
+			const bool toOutput = outputIsConnected[row] && !(finalRow && finalRowIsMix);
+			const bool toMix = mixIsOutput && (finalRow || !outputIsConnected[row]);
 
-				for (int c = 0; c < channels; c += 4) {
-					in[c / 4] = inputs[row].getVoltageSimd<float_4>(c) * gain;
+			if (!inputIsConnected[row]) {
+				for (int frame = 0; toOutput && frame < frames; ++frame) {
+					block.setVoltageSimd(OUT_OUTPUT + row, frame, float_4::zero(), 0);
 				}
+				continue;
 			}
+			if (!toOutput && !toMix) {
+				continue;
+			}
+
+			for (int frame = 0; frame < frames; ++frame) {
+				float cvGain = clamp(block.getNormalVoltage(CV_INPUT + row, frame, 10.f) / 10.f, 0.f, 1.f);
+				float gain = gainFunction(cvGain, shapes[row]) * outputLevels[row].process();
 
-			if (!finalRow) {
-				if (outputs[OUT_OUTPUT + row].isConnected()) {
-					// if output is connected, we don't add to mix
-					outputs[OUT_OUTPUT + row].setChannels(channels);
-					for (int c = 0; c < channels; c += 4) {
-						outputs[OUT_OUTPUT + row].setVoltageSimd(in[c / 4], c);
+				for (int c = 0; c < channels[row]; c += 4) {
+					const float_4 in = block.getVoltageSimd<float_4>(IN_INPUT + row, frame, c) * gain;
+					if (toOutput) {
+						block.setVoltageSimd(OUT_OUTPUT + row, frame, in, c);
 					}
-				}
-				else if (finalRowIsMix) {
-					// else add to mix (if setting enabled)
-					for (int c = 0; c < channels; c += 4) {
-						mix[c / 4] += in[c / 4];
+					else {
+						mix[frame][c / 4] += in;
 					}
 				}
 			}
-			// final row
-			else {
-				if (outputs[OUT_OUTPUT + row].isConnected()) {
-					if (finalRowIsMix) {
-						outputs[OUT_OUTPUT + row].setChannels(maxChannels);
-
-						// last channel must always go into mix
-						for (int c = 0; c < channels; c += 4) {
-							mix[c / 4] += in[c / 4];
-						}
-
-						for (int c = 0; c < maxChannels; c += 4) {
-							outputs[OUT_OUTPUT + row].setVoltageSimd(mix[c / 4], c);
-						}
-					}
-					else {
-						// same as other rows
-						outputs[OUT_OUTPUT + row].setChannels(channels);
-						for (int c = 0; c < channels; c += 4) {
-							outputs[OUT_OUTPUT + row].setVoltageSimd(in[c / 4], c);
-						}
-					}
+		}
+
+		if (mixIsOutput) {
+			for (int frame = 0; frame < frames; ++frame) {
+				for (int c = 0; c < maxChannels; c += 4) {
+					block.setVoltageSimd(OUT_OUTPUT + numRows - 1, frame, mix[frame][c / 4], c);
 				}
 			}
 		}
@@ -141,11 +154,17 @@ struct HexmixVCA : Module {
 		if (modeJ) {
 			finalRowIsMix = json_boolean_value(modeJ);
 		}
+
+		json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+		if (blockSizeJ) {
+			block.setBlockSize(json_integer_value(blockSizeJ));
+		}
 	}
 
 	json_t* dataToJson() override {
 		json_t* rootJ = json_object();
 		json_object_set_new(rootJ, "finalRowIsMix", json_boolean(finalRowIsMix));
+		json_object_set_new(rootJ, "blockSize", json_integer(block.getBlockSize()));
 		return rootJ;
 	}
 };
@@ -203,8 +222,9 @@ struct HexmixVCAWidget : ModuleWidget {
 
 		menu->addChild(new MenuSeparator());
 		menu->addChild(createBoolPtrMenuItem("Final row is mix", "", &module->finalRowIsMix));
+		menu->addChild(createBlockSizeMenuItem(&module->block));
 	}
 };
 
 
-Model* modelHexmixVCA = createModel<HexmixVCA, HexmixVCAWidget>("HexmixVCA");
\ No newline at end of file
+Model* modelHexmixVCA = createModelWithTelemetry<HexmixVCA, HexmixVCAWidget>("HexmixVCA");
\ No newline at end of file
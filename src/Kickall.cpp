@@ -44,7 +44,23 @@ struct Kickall : Module {
 	dsp::BooleanTrigger buttonTrigger;
 
 	static const int UPSAMPLE = 8;
-	chowdsp::Oversampling<UPSAMPLE> oversampler;
+	static const int MAX_BLOCK_SIZE = BlockProcessor<NUM_INPUTS, NUM_OUTPUTS>::MAX_BLOCK_SIZE;
+	// a whole block is oversampled at once, so the oversamplers' buffers hold MAX_BLOCK_SIZE frames
+	chowdsp::Oversampling<UPSAMPLE, 4, float, chowdsp::BUTTERWORTH, MAX_BLOCK_SIZE> iirOversampler;
+	chowdsp::PolyphaseOversampling<UPSAMPLE, float, MAX_BLOCK_SIZE> polyphaseOversampler;
+	// 0: Butterworth (IIR), 1: half-band (polyphase)
+	int antialiasingFilter = 0;
+	chowdsp::BaseOversampling<float>* oversampler = &iirOversampler;
+	// set by the context menu, the oversampler is switched at the start of the next process() call
+	std::atomic<bool> oversamplingChanged{false};
+	IdleDetector idleDetector;
+	// the oversampler isn't run while idle, so its filters hold the waveform from before and are cleared on waking
+	bool oversamplerStale = false;
+	BlockProcessor<NUM_INPUTS, NUM_OUTPUTS> block;
+
+	int getOversamplingRatio() {
+		return UPSAMPLE;
+	}
 
 	Kickall() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -76,54 +92,124 @@ struct Kickall : Module {
 	}
 
 	void onSampleRateChange() override {
-		oversampler.reset(APP->engine->getSampleRate());
+		iirOversampler.reset(APP->engine->getSampleRate());
+		polyphaseOversampler.reset(APP->engine->getSampleRate());
+		oversampler = (antialiasingFilter == 1) ? (chowdsp::BaseOversampling<float>*) &polyphaseOversampler : &iirOversampler;
 	}
 
 	void process(const ProcessArgs& args) override {
-		// TODO: check values
-		const bool risingEdgeGate = gateTrigger.process(inputs[TRIGG_INPUT].getVoltage() / 2.0f, 0.1, 2.0);
-		const bool buttonTriggered = buttonTrigger.process(params[TRIGG_BUTTON_PARAM].getValue());
-		// can be triggered by either rising edge on trigger in, or a button press
-		if (risingEdgeGate || buttonTriggered) {
-			volume.trigger();
-			pitch.trigger();
+		if (oversamplingChanged.exchange(false)) {
+			onSampleRateChange();
 		}
+		block.process(this, args);
+	}
 
-		const float vcaGain = clamp(inputs[VOLUME_INPUT].getNormalVoltage(10.f) / 10.f, 0.f, 1.0f);
-
-		// pitch envelope
-		const float bend = bendRange * std::pow(params[BEND_PARAM].getValue(), 3.0);
+	void processBlock(const ProcessArgs& args, const int frames) {
+		// params are only read once per block
+		const bool buttonTriggered = buttonTrigger.process(params[TRIGG_BUTTON_PARAM].getValue());
+		const float bendParam = params[BEND_PARAM].getValue();
+		const float bend = bendRange * bendParam * bendParam * bendParam;
 		pitch.decayTime = rescale(params[TIME_PARAM].getValue(), 0.f, 1.0f, minPitchDecay, maxPitchDecay);
-		pitch.process(args.sampleTime);
+		const float volumeDecay = minVolumeDecay * exp2_fast(params[DECAY_PARAM].getValue() * std::log2(maxVolumeDecay / minVolumeDecay));
+		const float tune = params[TUNE_PARAM].getValue();
+		const float shapeParam = params[SHAPE_PARAM].getValue();
 
-		// volume envelope
-		const float volumeDecay = minVolumeDecay * std::pow(2.f, params[DECAY_PARAM].getValue() * std::log2(maxVolumeDecay / minVolumeDecay));
-		volume.decayTime = clamp(volumeDecay + inputs[DECAY_INPUT].getVoltage() * 0.1f, 0.01, 10.0);
-		volume.process(args.sampleTime);
+		// oversampled phases of the whole block, and per frame waveshaping and output gain
+		float phases[MAX_BLOCK_SIZE * UPSAMPLE];
+		float shapeA[MAX_BLOCK_SIZE], shapeB[MAX_BLOCK_SIZE];
+		float gain[MAX_BLOCK_SIZE];
+		bool anyActive = false;
 
-		float freq = params[TUNE_PARAM].getValue();
-		freq *= std::pow(2.f, inputs[TUNE_INPUT].getVoltage());
+		for (int frame = 0; frame < frames; ++frame) {
+			// TODO: check values
+			const bool risingEdgeGate = gateTrigger.process(block.getVoltage(TRIGG_INPUT, frame) / 2.0f, 0.1, 2.0);
+			// can be triggered by either rising edge on trigger in, or a button press
+			if (risingEdgeGate || (buttonTriggered && frame == 0)) {
+				volume.trigger();
+				pitch.trigger();
+			}
 
-		const float kickFrequency = std::max(10.0f, freq + bend * pitch.env);
-		const float phaseInc = clamp(args.sampleTime * kickFrequency / UPSAMPLE, 1e-6, 0.35f);
+			const float vcaGain = clamp(block.getNormalVoltage(VOLUME_INPUT, frame, 10.f) / 10.f, 0.f, 1.0f);
 
-		const float shape = clamp(inputs[SHAPE_INPUT].getVoltage() / 10.f + params[SHAPE_PARAM].getValue(), 0.0f, 1.0f) * 0.99f;
-		const float shapeB = (1.0f - shape) / (1.0f + shape);
-		const float shapeA = (4.0f * shape) / ((1.0f - shape) * (1.0f + shape));
+			// pitch envelope
+			pitch.process(args.sampleTime);
 
-		float* inputBuf = oversampler.getOSBuffer();
-		for (int i = 0; i < UPSAMPLE; ++i) {
-			phase += phaseInc;
-			phase -= std::floor(phase);
+			// volume envelope
+			volume.decayTime = clamp(volumeDecay + block.getVoltage(DECAY_INPUT, frame) * 0.1f, 0.01, 10.0);
+			volume.process(args.sampleTime);
 
-			inputBuf[i] = sin2pi_pade_05_5_4(phase);
-			inputBuf[i] = inputBuf[i] * (shapeA + shapeB) / ((std::abs(inputBuf[i]) * shapeA) + shapeB);
-		}
+			const float freq = tune * exp2_fast(block.getVoltage(TUNE_INPUT, frame));
+			const float kickFrequency = std::max(10.0f, freq + bend * pitch.env);
+			const float phaseInc = clamp(args.sampleTime * kickFrequency / UPSAMPLE, 1e-6, 0.35f);
 
-		const float out = volume.env * oversampler.downsample() * 5.0f * vcaGain;
-		outputs[OUT_OUTPUT].setVoltage(out);
+			for (int i = 0; i < UPSAMPLE; ++i) {
+				phase += phaseInc;
+				phase -= std::floor(phase);
+				phases[frame * UPSAMPLE + i] = phase;
+			}
+
+			// between hits both envelopes are off and the output is silent, only the phase is kept running
+			const bool idle = idleDetector.process(volume.stage != ADEnvelope::STAGE_OFF || pitch.stage != ADEnvelope::STAGE_OFF);
+			anyActive |= !idle;
+			gain[frame] = idle ? 0.f : volume.env * 5.0f * vcaGain;
+
+			const float shape = clamp(block.getVoltage(SHAPE_INPUT, frame) / 10.f + shapeParam, 0.0f, 1.0f) * 0.99f;
+			shapeB[frame] = (1.0f - shape) / (1.0f + shape);
+			shapeA[frame] = (4.0f * shape) / ((1.0f - shape) * (1.0f + shape));
+		}
 
 		lights[ENV_LIGHT].setBrightness(volume.env);
+
+		if (!anyActive) {
+			for (int frame = 0; frame < frames; ++frame) {
+				block.setVoltage(OUT_OUTPUT, frame, 0.f);
+			}
+			oversamplerStale = true;
+			return;
+		}
+		if (oversamplerStale) {
+			// rather than replaying the end of the last hit into this one
+			oversampler->prime(0.f, 0.f);
+			oversamplerStale = false;
+		}
+
+		// the whole oversampled block goes through the sine kernel at once, and each frame's 8 samples are shaped
+		// in a loop the compiler can vectorise
+		float* osBuffer = oversampler->getOSBuffer();
+		sin2pi_pade_05_5_4(phases, osBuffer, frames * UPSAMPLE);
+		for (int frame = 0; frame < frames; ++frame) {
+			const float a = shapeA[frame], b = shapeB[frame];
+			float* x = &osBuffer[frame * UPSAMPLE];
+			for (int i = 0; i < UPSAMPLE; ++i) {
+				x[i] = x[i] * (a + b) / ((std::abs(x[i]) * a) + b);
+			}
+		}
+
+		float out[MAX_BLOCK_SIZE];
+		oversampler->downsampleBlock(out, frames);
+		for (int frame = 0; frame < frames; ++frame) {
+			block.setVoltage(OUT_OUTPUT, frame, gain[frame] * out[frame]);
+		}
+	}
+
+	json_t* dataToJson() override {
+		json_t* rootJ = json_object();
+		json_object_set_new(rootJ, "antialiasingFilter", json_integer(antialiasingFilter));
+		json_object_set_new(rootJ, "blockSize", json_integer(block.getBlockSize()));
+		return rootJ;
+	}
+
+	void dataFromJson(json_t* rootJ) override {
+		json_t* antialiasingFilterJ = json_object_get(rootJ, "antialiasingFilter");
+		if (antialiasingFilterJ) {
+			antialiasingFilter = clamp((int) json_integer_value(antialiasingFilterJ), 0, 1);
+			onSampleRateChange();
+		}
+
+		json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+		if (blockSizeJ) {
+			block.setBlockSize(json_integer_value(blockSizeJ));
+		}
 	}
 };
 
@@ -153,7 +239,25 @@ struct KickallWidget : ModuleWidget {
 
 		addChild(createLightCentered<SmallLight<RedLight>>(mm2px(Vec(15.535, 34.943)), module, Kickall::ENV_LIGHT));
 	}
+
+	void appendContextMenu(Menu* menu) override {
+		Kickall* module = dynamic_cast<Kickall*>(this->module);
+		assert(module);
+
+		menu->addChild(new MenuSeparator());
+		menu->addChild(createIndexSubmenuItem("Anti-aliasing filter",
+		{"Butterworth (IIR)", "Half-band (polyphase)"},
+		[ = ]() {
+			return module->antialiasingFilter;
+		},
+		[ = ](int type) {
+			module->antialiasingFilter = type;
+			module->oversamplingChanged = true;
+		}
+		                                     ));
+		menu->addChild(createBlockSizeMenuItem(&module->block));
+	}
 };
 
 
-Model* modelKickall = createModel<Kickall, KickallWidget>("Kickall");
+Model* modelKickall = createModelWithTelemetry<Kickall, KickallWidget>("Kickall");
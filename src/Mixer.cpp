@@ -130,4 +130,4 @@ struct MixerWidget : ModuleWidget {
 };
 
 
-Model* modelMixer = createModel<Mixer, MixerWidget>("Mixer");
+Model* modelMixer = createModelWithTelemetry<Mixer, MixerWidget>("Mixer");
@@ -286,4 +286,4 @@ struct MorphaderWidget : ModuleWidget {
 };
 
 
-Model* modelMorphader = createModel<Morphader, MorphaderWidget>("Morphader");
\ No newline at end of file
+Model* modelMorphader = createModelWithTelemetry<Morphader, MorphaderWidget>("Morphader");
\ No newline at end of file
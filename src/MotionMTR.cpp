@@ -49,13 +49,21 @@ struct MotionMTR : Module {
 		{ -19, 11}, { -18, 12}, { -16, 13}, { -14, 14},  { -12, 15},  { -10, 16}, { -8, 17}, { -6, 18}, { -4, 19}, { -2, 20}
 	};
 
-	dsp::VuMeter2 vuBar[3];
+	// what the LED rings need, published by the audio thread at display rate and turned into colours by MotionMTRWidget
+	struct DisplayState {
+		LightDisplayType mode[3] = {CV_ATT, CV_ATT, CV_ATT};
+		float signal[3] = {};
+		// peak |signal| and engine time since the last snapshot the widget consumed
+		float peak[3] = {};
+		float elapsed = 0.f;
+	};
+	UISnapshot<DisplayState> display;
 
 	const int updateLEDRate = 16;
 	dsp::ClockDivider sliderUpdate;
 
-	bool startingUp = true;
-	dsp::Timer startupTimer;
+	// set on reset, picked up by the widget to replay the startup animation
+	std::atomic<bool> startupRequested{true};
 
 	bool break10VNormalForAudioMode = true;
 
@@ -91,20 +99,12 @@ struct MotionMTR : Module {
 			configLight(LIGHT_3 + i * 3, string::f("%g to %g dB", lut[i - 1].dbValue, lut[i].dbValue));
 		}
 
-		for (int i = 0; i < 3; ++i) {
-			vuBar[i].mode = dsp::VuMeter2::PEAK;
-			vuBar[i].lambda = 10.f * updateLEDRate;
-		}
-
-		// only poll EQ sliders every 16 samples
-		sliderUpdate.setDivision(updateLEDRate);
-		// timer for startup animation
-		startupTimer.reset();
+		// hand the LED state over to the UI every 32 x 16 samples
+		sliderUpdate.setDivision(32 * updateLEDRate);
 	}
 
 	void onReset(const ResetEvent& e) override {
-		startingUp = true;
-		startupTimer.reset();
+		startupRequested = true;
 		Module::onReset(e);
 	}
 
@@ -129,15 +129,26 @@ struct MotionMTR : Module {
 			out3 += out2;
 		}
 
-		// special light pattern when starting up :)
-		if (startingUp) {
-			processStartup(args);
-		}
-		// otherwise (periodically) update LEDS according to value
-		else if (sliderUpdate.process()) {
-			lightsForSignal(mode1, LIGHT_1, out1, args, 0);
-			lightsForSignal(mode2, LIGHT_2, out2, args, 1);
-			lightsForSignal(mode3, LIGHT_3, out3, args, 2);
+		DisplayState& state = display.back();
+		state.peak[0] = std::max(state.peak[0], std::abs(out1));
+		state.peak[1] = std::max(state.peak[1], std::abs(out2));
+		state.peak[2] = std::max(state.peak[2], std::abs(out3));
+		state.elapsed += args.sampleTime;
+
+		if (sliderUpdate.process()) {
+			state.mode[0] = mode1;
+			state.mode[1] = mode2;
+			state.mode[2] = mode3;
+			state.signal[0] = out1;
+			state.signal[1] = out2;
+			state.signal[2] = out3;
+
+			// if the widget hasn't taken the last snapshot, we get it back and keep accumulating into it
+			if (display.publish()) {
+				DisplayState& next = display.back();
+				std::fill(next.peak, next.peak + 3, 0.f);
+				next.elapsed = 0.f;
+			}
 		}
 
 		outputs[OUT1_OUTPUT].setVoltage(out1);
@@ -145,119 +156,6 @@ struct MotionMTR : Module {
 		outputs[OUT3_OUTPUT].setVoltage(out3);
 	}
 
-	void processStartup(const ProcessArgs& args) {
-		float time = startupTimer.process(args.sampleTime);
-		const float ringTime = 0.4;
-
-		if (time < ringTime) {
-			int light = floor(NUM_LIGHTS_PER_DIAL * time / ringTime);
-			setLightHSBSmooth(LIGHT_1 + 3 * light, args, 360 * time / ringTime, 1., 1.);
-		}
-		else if (time < 2 * ringTime) {
-			time -= ringTime;
-			int light = floor(NUM_LIGHTS_PER_DIAL * time / ringTime);
-			setLightHSBSmooth(LIGHT_2 + 3 * light, args, 360 * time / ringTime, 1., 1.);
-		}
-		else if (time < 3 * ringTime) {
-			time -= 2 * ringTime;
-			int light = floor(NUM_LIGHTS_PER_DIAL * time / ringTime);
-			setLightHSBSmooth(LIGHT_3 + 3 * light, args, 360 * time / ringTime, 1., 1.);
-		}
-		else {
-			startingUp = false;
-		}
-	}
-
-	void setLightRGB(int lightId, float R, float G, float B) {
-		lights[lightId + 0].setBrightness(R);
-		lights[lightId + 1].setBrightness(G);
-		lights[lightId + 2].setBrightness(B);
-	}
-
-	void setLightRGBSmooth(int lightId, const ProcessArgs& args, float R, float G, float B) {
-		// inverse time constant for LED smoothing
-		const float lambda = 10.f * updateLEDRate;
-		lights[lightId + 0].setBrightnessSmooth(R, args.sampleTime, lambda);
-		lights[lightId + 1].setBrightnessSmooth(G, args.sampleTime, lambda);
-		lights[lightId + 2].setBrightnessSmooth(B, args.sampleTime, lambda);
-	}
-
-	// hue: 0 - 360
-	void setLightHSBSmooth(int lightId, const ProcessArgs& args, float H, float S, float V) {
-
-		float C = S * V;
-		float X = C * (1 - std::abs(std::fmod(H / 60.0, 2) - 1));
-		float m = V - C;
-		float r, g, b;
-		if (H >= 0 && H < 60) {
-			r = C, g = X, b = 0;
-		}
-		else if (H >= 60 && H < 120) {
-			r = X, g = C, b = 0;
-		}
-		else if (H >= 120 && H < 180) {
-			r = 0, g = C, b = X;
-		}
-		else if (H >= 180 && H < 240) {
-			r = 0, g = X, b = C;
-		}
-		else if (H >= 240 && H < 300) {
-			r = X, g = 0, b = C;
-		}
-		else {
-			r = C, g = 0, b = X;
-		}
-
-		float R = (r + m);
-		float G = (g + m);
-		float B = (b + m);
-
-		setLightRGBSmooth(lightId, args, R, G, B);
-	}
-
-	void lightsForSignal(LightDisplayType type, const LightId lightId, float signal, const ProcessArgs& args, const int channel) {
-
-		if (type == AUDIO) {
-			setLightRGB(lightId, 0.f, 1.0f, 0.f);
-
-			vuBar[channel].process(args.sampleTime * updateLEDRate, signal / 10.f);
-
-			for (int i = 1; i < NUM_LIGHTS_PER_DIAL; i++) {
-				const float value = vuBar[channel].getBrightness(lut[i - 1].dbValue, lut[i].dbValue);
-				if (i < 15) {
-					// green
-					setLightRGB(lightId + 3 * i, 0.f, value, 0.f);
-				}
-				else if (i < NUM_LIGHTS_PER_DIAL - 1) {
-					// yellow
-					setLightRGB(lightId + 3 * i, value, 0.65 * value, 0.f);
-				}
-				else {
-					// red
-					setLightRGB(lightId + 3 * i, value, 0.f, 0.f);
-				}
-			}
-		}
-		else {
-			setLightRGBSmooth(lightId, args, 0.82f, 0.0f, 0.82f);
-
-			if (signal >= 0) {
-				for (int i = 1; i < NUM_LIGHTS_PER_DIAL; ++i) {
-					float value = (signal > (10 * (i + 1.) / (NUM_LIGHTS_PER_DIAL + 1)));
-					// purple
-					setLightRGBSmooth(lightId + 3 * i, args, 0.82f * value, 0.0f, 0.82f * value);
-				}
-			}
-			else {
-				for (int i = 1; i < NUM_LIGHTS_PER_DIAL; ++i) {
-					float value = (signal < (-10 * (NUM_LIGHTS_PER_DIAL - i + 1.) / (NUM_LIGHTS_PER_DIAL + 1.)));
-					// orange
-					setLightRGBSmooth(lightId + 3 * i, args, value, 0.4f * value, 0.f);
-				}
-			}
-		}
-	}
-
 	json_t* dataToJson() override {
 		json_t* rootJ = json_object();
 		json_object_set_new(rootJ, "break10VNormalForAudioMode", json_boolean(break10VNormalForAudioMode));
@@ -301,8 +199,16 @@ struct CKSSThreeDragable : app::SvgSlider {
 
 
 struct MotionMTRWidget : ModuleWidget {
+	// LED ring state, all of it on the UI thread
+	dsp::VuMeter2 vuBar[3];
+	bool startingUp = false;
+	float startupTime = 0.f;
+
 	MotionMTRWidget(MotionMTR* module) {
 		setModule(module);
+		for (int i = 0; i < 3; ++i) {
+			vuBar[i].mode = dsp::VuMeter2::PEAK;
+		}
 		setPanel(createPanel(asset::plugin(pluginInstance, "res/panels/MotionMTR.svg")));
 
 		addChild(createWidget<Knurlie>(Vec(RACK_GRID_WIDTH, 0)));
@@ -346,6 +252,150 @@ struct MotionMTRWidget : ModuleWidget {
 		}
 	}
 
+	void step() override {
+		MotionMTR* module = dynamic_cast<MotionMTR*>(this->module);
+		if (module && module->display.consume()) {
+			const MotionMTR::DisplayState& state = module->display.front();
+
+			if (module->startupRequested.exchange(false)) {
+				startingUp = true;
+				startupTime = 0.f;
+			}
+
+			// special light pattern when starting up :)
+			if (startingUp) {
+				processStartup(module, state.elapsed);
+			}
+			// otherwise update LEDS according to value
+			else {
+				const MotionMTR::LightId lightIds[3] = {MotionMTR::LIGHT_1, MotionMTR::LIGHT_2, MotionMTR::LIGHT_3};
+				for (int channel = 0; channel < 3; ++channel) {
+					lightsForSignal(module, state, lightIds[channel], channel);
+				}
+			}
+		}
+		ModuleWidget::step();
+	}
+
+	void processStartup(MotionMTR* module, float deltaTime) {
+		const float ringTime = 0.4;
+		const int numLights = 3 * MotionMTR::NUM_LIGHTS_PER_DIAL;
+
+		// light every LED the animation has passed since the last frame, each with its own hue
+		const int firstLight = std::floor(MotionMTR::NUM_LIGHTS_PER_DIAL * startupTime / ringTime);
+		startupTime += deltaTime;
+		const int lastLight = std::min<int>(std::floor(MotionMTR::NUM_LIGHTS_PER_DIAL * startupTime / ringTime), numLights - 1);
+
+		for (int i = firstLight; i <= lastLight; ++i) {
+			const int light = i % MotionMTR::NUM_LIGHTS_PER_DIAL;
+			setLightHSB(module, MotionMTR::LIGHT_1 + 3 * i, 360.f * light / MotionMTR::NUM_LIGHTS_PER_DIAL, 1., 1.);
+		}
+
+		if (startupTime >= 3 * ringTime) {
+			startingUp = false;
+		}
+	}
+
+	static void setLightRGB(MotionMTR* module, int lightId, float R, float G, float B) {
+		module->lights[lightId + 0].setBrightness(R);
+		module->lights[lightId + 1].setBrightness(G);
+		module->lights[lightId + 2].setBrightness(B);
+	}
+
+	static void setLightRGBSmooth(MotionMTR* module, int lightId, float deltaTime, float R, float G, float B) {
+		// inverse time constant for LED smoothing
+		const float lambda = 10.f;
+		// deltaTime is a whole UI frame, so use the exact decay rather than Light::setBrightnessSmooth()'s linear step
+		const float decay = std::exp(-lambda * deltaTime);
+		const float rgb[3] = {R, G, B};
+		for (int i = 0; i < 3; ++i) {
+			Light& light = module->lights[lightId + i];
+			const float value = light.getBrightness();
+			// fade out, but illuminate immediately
+			light.setBrightness(rgb[i] < value ? rgb[i] + (value - rgb[i]) * decay : rgb[i]);
+		}
+	}
+
+	// hue: 0 - 360
+	static void setLightHSB(MotionMTR* module, int lightId, float H, float S, float V) {
+
+		float C = S * V;
+		float X = C * (1 - std::abs(std::fmod(H / 60.0, 2) - 1));
+		float m = V - C;
+		float r, g, b;
+		if (H >= 0 && H < 60) {
+			r = C, g = X, b = 0;
+		}
+		else if (H >= 60 && H < 120) {
+			r = X, g = C, b = 0;
+		}
+		else if (H >= 120 && H < 180) {
+			r = 0, g = C, b = X;
+		}
+		else if (H >= 180 && H < 240) {
+			r = 0, g = X, b = C;
+		}
+		else if (H >= 240 && H < 300) {
+			r = X, g = 0, b = C;
+		}
+		else {
+			r = C, g = 0, b = X;
+		}
+
+		float R = (r + m);
+		float G = (g + m);
+		float B = (b + m);
+
+		setLightRGB(module, lightId, R, G, B);
+	}
+
+	void lightsForSignal(MotionMTR* module, const MotionMTR::DisplayState& state, const MotionMTR::LightId lightId, const int channel) {
+
+		if (state.mode[channel] == MotionMTR::AUDIO) {
+			setLightRGB(module, lightId, 0.f, 1.0f, 0.f);
+
+			// peak meter over the snapshot: jump to a new peak, otherwise decay (exactly, as elapsed spans many samples)
+			const float lambda = 160.f;
+			const float peak = state.peak[channel] / 10.f;
+			float& v = vuBar[channel].v;
+			v = (peak >= v) ? peak : peak + (v - peak) * std::exp(-lambda * state.elapsed);
+
+			for (int i = 1; i < MotionMTR::NUM_LIGHTS_PER_DIAL; i++) {
+				const float value = vuBar[channel].getBrightness(module->lut[i - 1].dbValue, module->lut[i].dbValue);
+				if (i < 15) {
+					// green
+					setLightRGB(module, lightId + 3 * i, 0.f, value, 0.f);
+				}
+				else if (i < MotionMTR::NUM_LIGHTS_PER_DIAL - 1) {
+					// yellow
+					setLightRGB(module, lightId + 3 * i, value, 0.65 * value, 0.f);
+				}
+				else {
+					// red
+					setLightRGB(module, lightId + 3 * i, value, 0.f, 0.f);
+				}
+			}
+		}
+		else {
+			const float signal = state.signal[channel];
+			setLightRGBSmooth(module, lightId, state.elapsed, 0.82f, 0.0f, 0.82f);
+
+			if (signal >= 0) {
+				for (int i = 1; i < MotionMTR::NUM_LIGHTS_PER_DIAL; ++i) {
+					float value = (signal > (10 * (i + 1.) / (MotionMTR::NUM_LIGHTS_PER_DIAL + 1)));
+					// purple
+					setLightRGBSmooth(module, lightId + 3 * i, state.elapsed, 0.82f * value, 0.0f, 0.82f * value);
+				}
+			}
+			else {
+				for (int i = 1; i < MotionMTR::NUM_LIGHTS_PER_DIAL; ++i) {
+					float value = (signal < (-10 * (MotionMTR::NUM_LIGHTS_PER_DIAL - i + 1.) / (MotionMTR::NUM_LIGHTS_PER_DIAL + 1.)));
+					// orange
+					setLightRGBSmooth(module, lightId + 3 * i, state.elapsed, value, 0.4f * value, 0.f);
+				}
+			}
+		}
+	}
 
 	void appendContextMenu(Menu* menu) override {
 		MotionMTR* module = dynamic_cast<MotionMTR*>(this->module);
@@ -363,4 +413,4 @@ struct MotionMTRWidget : ModuleWidget {
 };
 
 
-Model* modelMotionMTR = createModel<MotionMTR, MotionMTRWidget>("MotionMTR");
\ No newline at end of file
+Model* modelMotionMTR = createModelWithTelemetry<MotionMTR, MotionMTRWidget>("MotionMTR");
\ No newline at end of file
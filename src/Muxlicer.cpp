@@ -184,6 +184,16 @@ inline std::string getClockOptionString(const int clockOption) {
 	return (clockOption < 0) ? ("x 1/" + std::to_string(-clockOption)) : ("x " + std::to_string(clockOption));
 }
 
+// state Muxlicer passes to a chain of Mex expanders on its right, one hop per sample
+struct MuxlicerExpanderMessage {
+	// false once any link between Muxlicer and this Mex is broken, in which case the rest is stale
+	bool hasHost = false;
+	bool playing = false;
+	int addressIndex = 0;
+	bool isAllGatesOutHigh = false;
+	bool isOutputClockHigh = false;
+};
+
 struct Muxlicer : Module {
 	enum ParamIds {
 		PLAY_PARAM,
@@ -602,6 +612,15 @@ struct Muxlicer : Module {
 		// end of cycle trigger trigger
 		outputs[EOC_OUTPUT].setVoltage(endOfCyclePulse.process(args.sampleTime) ? 10.f : 0.f);
 
+		if (rightExpander.module && rightExpander.module->model == modelMex) {
+			MuxlicerExpanderMessage* message = (MuxlicerExpanderMessage*) rightExpander.module->leftExpander.producerMessage;
+			message->hasHost = true;
+			message->playing = playState != STATE_STOPPED;
+			message->addressIndex = addressIndex;
+			message->isAllGatesOutHigh = isAllGatesOutHigh;
+			message->isOutputClockHigh = isOutputClockHigh;
+			rightExpander.module->leftExpander.messageFlipRequested = true;
+		}
 	}
 
 	void processPlayResetLogic() {
@@ -1041,7 +1060,7 @@ struct MuxlicerWidget : ModuleWidget {
 };
 
 
-Model* modelMuxlicer = createModel<Muxlicer, MuxlicerWidget>("Muxlicer");
+Model* modelMuxlicer = createModelWithTelemetry<Muxlicer, MuxlicerWidget>("Muxlicer");
 
 
 // Mex
@@ -1072,45 +1091,45 @@ struct Mex : Module {
 	};
 
 	dsp::SchmittTrigger gateInTrigger;
+	// double buffer for the message from Muxlicer (or the Mex to our left), flipped by the engine
+	MuxlicerExpanderMessage leftMessages[2];
 
 	Mex() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+		leftExpander.producerMessage = &leftMessages[0];
+		leftExpander.consumerMessage = &leftMessages[1];
 
 		for (int i = 0; i < 8; ++i) {
 			configSwitch(STEP_PARAM + i, 0.f, 2.f, 0.f, string::f("Step %d", i + 1), {"Gate in/Clock Out", "Muted", "All Gates"});
 		}
 	}
 
-	Muxlicer* findHostModulePtr(Module* module) {
-		if (module) {
-			if (module->leftExpander.module) {
-				// if it's Muxlicer, we're done
-				if (module->leftExpander.module->model == modelMuxlicer) {
-					return reinterpret_cast<Muxlicer*>(module->leftExpander.module);
-				}
-				// if it's Mex, keep recursing
-				else if (module->leftExpander.module->model == modelMex) {
-					return findHostModulePtr(module->leftExpander.module);
-				}
-			}
-		}
-
-		return nullptr;
-	}
-
 	void process(const ProcessArgs& args) override {
 
 		for (int i = 0; i < 8; i++) {
 			lights[i].setBrightness(0.f);
 		}
 
-		Muxlicer const* mother = findHostModulePtr(this);
-
-		if (mother) {
+		// the last message stays in the buffer once the module to our left is removed, and a Mex to our left that has
+		// lost its own host sends one with hasHost cleared
+		const bool leftIsHost = leftExpander.module && (leftExpander.module->model == modelMuxlicer || leftExpander.module->model == modelMex);
+		static const MuxlicerExpanderMessage noHost;
+		const MuxlicerExpanderMessage* mother = leftIsHost ? (const MuxlicerExpanderMessage*) leftExpander.consumerMessage : &noHost;
+		const bool hasHost = mother->hasHost;
+
+		// pass the message on down the chain, including that there is no host, so that no Mex is left playing
+		if (rightExpander.module && rightExpander.module->model == modelMex) {
+			*(MuxlicerExpanderMessage*) rightExpander.module->leftExpander.producerMessage = hasHost ? *mother : noHost;
+			rightExpander.module->leftExpander.messageFlipRequested = true;
+		}
 
+		if (!hasHost) {
+			outputs[OUT_OUTPUT].setVoltage(0.f);
+		}
+		else {
 			float gate = 0.f;
 
-			if (mother->playState != Muxlicer::STATE_STOPPED) {
+			if (mother->playing) {
 				const int currentStep = clamp(mother->addressIndex, 0, 7);
 				StepState state = (StepState) params[STEP_PARAM + currentStep].getValue();
 				if (state == MUXLICER_MODE) {
@@ -1172,4 +1191,4 @@ struct MexWidget : ModuleWidget {
 };
 
 
-Model* modelMex = createModel<Mex, MexWidget>("Mex");
+Model* modelMex = createModelWithTelemetry<Mex, MexWidget>("Mex");
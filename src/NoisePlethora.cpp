@@ -1,6 +1,9 @@
 #include "plugin.hpp"
 #include "noise-plethora/plugins/NoisePlethoraPlugin.hpp"
 #include "noise-plethora/plugins/ProgramSelector.hpp"
+#include "noise-plethora/plugins/AlgorithmPool.hpp"
+
+using simd::float_4;
 
 enum FilterMode {
 	LOWPASS,
@@ -10,56 +13,83 @@ enum FilterMode {
 };
 
 
+// g = tan(pi * fc) for the state variable filter, in double precision on float as it has always been
+inline double prewarpedGain(float fc) {
+	return std::tan(M_PI * fc);
+}
+
+inline float_4 prewarpedGain(float_4 fc) {
+	return simd::tan(float(M_PI) * fc);
+}
+
+inline bool anyChanged(float x, float cached) {
+	return x != cached;
+}
+
+inline bool anyChanged(float_4 x, float_4 cached) {
+	return simd::movemask(x != cached);
+}
+
 // based on Chapter 4 of THE ART OF VA FILTER DESIGN and
 // Chap 12.4 of "Designing Audio Effect Plugins in C++" Will Pirkle
-class StateVariableFilter2ndOrder {
+// runs on float or on float_4, i.e. four filters with their own parameters (one per polyphonic channel)
+template <typename T>
+class StateVariableFilter2ndOrderT {
 public:
 
-	StateVariableFilter2ndOrder() {
+	StateVariableFilter2ndOrderT() {
 		setParameters(0.f, M_SQRT1_2);
 	}
 
-	void setParameters(float fc, float q) {
+	void setParameters(T fc, T q) {
 		// avoid repeated evaluations of tanh if not needed
-		if (fc != fcCached || q != qCached) {
+		if (anyChanged(fc, fcCached) || anyChanged(q, qCached)) {
 
 			fcCached = fc;
 			qCached = q;
 
-			const double g = std::tan(M_PI * fc);
-			const double R = 1.0f / (2 * q);
+			const auto g = prewarpedGain(fc);
+			const T R = 1.0f / (2.f * q);
 
-			alpha0 = 1.0 / (1.0 + 2.0 * R * g + g * g);
+			alpha0 = 1.f / (1.f + 2.f * R * g + g * g);
 			alpha = g;
-			rho = 2.0 * R + g;
+			rho = 2.f * R + g;
 		}
 	}
 
-	void process(float input) {
+	void process(T input) {
 		hp = (input - rho * mem1 - mem2) * alpha0;
 		bp = alpha * hp + mem1;
 		lp = alpha * bp + mem2;
 		mem1 = alpha * hp + bp;
 		mem2 = alpha * bp + lp;
+
+		if (snapTimer.process()) {
+			mem1 = snapToZero(mem1);
+			mem2 = snapToZero(mem2);
+		}
 	}
 
-	float output(FilterMode mode) {
+	T output(FilterMode mode) {
 		switch (mode) {
 			case LOWPASS: return lp;
 			case HIGHPASS: return hp;
 			case BANDPASS: return bp;
-			default: return 0.0;
+			default: return 0.f;
 		}
 	}
 
 private:
-	float alpha, alpha0, rho;
+	T alpha, alpha0, rho;
 
-	float fcCached = -1.f, qCached = -1.f;
+	T fcCached = -1.f, qCached = -1.f;
 
-	float hp = 0.0f, bp = 0.0f, lp = 0.0f, mem1 = 0.0f, mem2 = 0.0f;
+	T hp = 0.0f, bp = 0.0f, lp = 0.0f, mem1 = 0.0f, mem2 = 0.0f;
+	DenormalSnapTimer snapTimer;
 };
 
+typedef StateVariableFilter2ndOrderT<float> StateVariableFilter2ndOrder;
+
 class StateVariableFilter4thOrder {
 
 public:
@@ -160,19 +190,44 @@ struct NoisePlethora : Module {
 
 	// section A/B
 	bool bypassFilters = false;
-	std::shared_ptr<NoisePlethoraPlugin> algorithm[2]; 		// pointer to actual algorithm
-	std::string algorithmName[2];							// variable to cache which algorithm is active (after program CV applied)
+	// what a section plays on one channel, the algorithm itself lives on the heap
+	struct Voice {
+		std::unique_ptr<NoisePlethoraPlugin> algorithm; 	// pointer to actual algorithm
+		AlgorithmId algorithmId = ALGORITHM_NONE;			// variable to cache which algorithm is active (after program CV applied)
+		GraphEngine engine = HARDWARE_INT16;
+		float gain = 1.f;
+	};
+	// one voice per channel in polyphonic mode, otherwise only the first
+	Voice voices[2][PORT_MAX_CHANNELS];
+	int numVoices[2] = {1, 1};
+	bool polyphonic = false;
+	// builds algorithms off the audio thread, so program changes never allocate
+	AlgorithmPool algorithmPool;
+	bool preloadAlgorithms = false;
+	// the algorithms prepareAlgorithms() last built spares of
+	AlgorithmId preparedId[2] = {ALGORITHM_NONE, ALGORITHM_NONE};
+	GraphEngine preparedEngine = HARDWARE_INT16;
+	// implementation of the Teensy audio graphs, the int16 one reproduces the hardware exactly, the float one is cheaper
+	GraphEngine graphEngine = HARDWARE_INT16;
 
 	// filters for A/B
 	StateVariableFilter2ndOrder svfFilter[2];
 	bool blockDC = true;
 	DCBlocker blockDCFilter[3];
+	// and in polyphonic mode, four channels to a float_4
+	StateVariableFilter2ndOrderT<float_4> svfFilterPoly[2][4];
+	DCBlockerT<2, float_4> blockDCFilterPoly[2][4];
 
 	ProgramSelector programSelector; 		// tracks banks and programs for both sections A/B, including which is the "active" section
 	ProgramSelector programSelectorWithCV; 	// as above, but also with CV for program applied as an offset - works like Plaits Model CV input
 	// UI / UX for A/B
-	std::string textDisplayA = " ", textDisplayB = " ";
-	bool isDisplayActiveA = false, isDisplayActiveB = false;
+	struct DisplayState {
+		char text[2][4] = {{' '}, {' '}};
+		bool active[2] = {};
+	};
+	// written by the audio thread at display rate, read by NoisePlethoraLEDDisplay
+	UISnapshot<DisplayState> display;
+	dsp::ClockDivider displayDivider;
 	bool programButtonHeld = false;
 	bool programButtonDragged = false;
 	dsp::BooleanTrigger programHoldTrigger;
@@ -180,6 +235,7 @@ struct NoisePlethora : Module {
 
 	dsp::PulseGenerator updateParamsTimer;
 	const float updateTimeSecs = 0.0029f;
+	IdleDetector idleDetector;
 
 	// section C
 	AudioSynthNoiseWhiteFloat whiteNoiseSource;
@@ -189,6 +245,7 @@ struct NoisePlethora : Module {
 
 	NoisePlethora()  {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+		displayDivider.setDivision(512);
 		configParam(X_A_PARAM, 0.f, 1.f, 0.5f, "XA");
 		configParam(RES_A_PARAM, 0.f, 1.f, 0.f, "Resonance A");
 		configParam(CUTOFF_A_PARAM, 0.f, 1.f, 1.f, "Cutoff A");
@@ -231,17 +288,50 @@ struct NoisePlethora : Module {
 		getInputInfo(PROG_A_INPUT)->description = "CV sums with active program (0.5V increments)";
 		getInputInfo(PROG_B_INPUT)->description = "CV sums with active program (0.5V increments)";
 
-		setAlgorithm(SECTION_B, "radioOhNo");
-		setAlgorithm(SECTION_A, "radioOhNo");
+		setAlgorithm(SECTION_B, ALGORITHM_radioOhNo);
+		setAlgorithm(SECTION_A, ALGORITHM_radioOhNo);
+		prepareAlgorithms();
 		onSampleRateChange();
 	}
 
 	void onReset(const ResetEvent& e) override {
-		setAlgorithm(SECTION_B, "radioOhNo");
-		setAlgorithm(SECTION_A, "radioOhNo");
+		setAlgorithm(SECTION_B, ALGORITHM_radioOhNo);
+		setAlgorithm(SECTION_A, ALGORITHM_radioOhNo);
+		prepareAlgorithms();
 		Module::onReset(e);
 	}
 
+	// not on the audio thread: builds the selected algorithms now, so they start on the next process() call rather
+	// than when the pool's worker gets to them
+	void prepareAlgorithms() {
+		algorithmPool.setPreload(preloadAlgorithms, graphEngine);
+		const AlgorithmId idA = programSelector.getA().getCurrentProgramId();
+		const AlgorithmId idB = programSelector.getB().getCurrentProgramId();
+		// one spare for each channel patched now, channels patched later ask the pool when they need one
+		const int channelsA = getSectionChannels(PROG_A_INPUT, X_A_INPUT, Y_A_INPUT, CUTOFF_A_INPUT);
+		const int channelsB = getSectionChannels(PROG_B_INPUT, X_B_INPUT, Y_B_INPUT, CUTOFF_B_INPUT);
+		const int numSparesA = idA == idB ? channelsA + channelsB : channelsA;
+		const int numSparesB = idA == idB ? channelsA + channelsB : channelsB;
+		algorithmPool.prepare(idA, graphEngine, numSparesA);
+		algorithmPool.prepare(idB, graphEngine, numSparesB);
+
+		if (!preloadAlgorithms) {
+			// e.g. after polyphony is switched off or fewer channels are patched
+			algorithmPool.trim(idA, graphEngine, numSparesA);
+			algorithmPool.trim(idB, graphEngine, numSparesB);
+			// free what the channels didn't take of the algorithms deselected, keeping one in case program CV goes back
+			for (AlgorithmId previousId : preparedId) {
+				const bool stillSelected = (previousId == idA || previousId == idB) && preparedEngine == graphEngine;
+				if (!stillSelected) {
+					algorithmPool.trim(previousId, preparedEngine, 1);
+				}
+			}
+		}
+		preparedId[SECTION_A] = idA;
+		preparedId[SECTION_B] = idB;
+		preparedEngine = graphEngine;
+	}
+
 	void onSampleRateChange() override {
 		// set ~20Hz DC blocker
 		const float fc = 22.05f / APP->engine->getSampleRate();
@@ -249,12 +339,18 @@ struct NoisePlethora : Module {
 		blockDCFilter[SECTION_A].setFrequency(fc);
 		blockDCFilter[SECTION_B].setFrequency(fc);
 		blockDCFilter[SECTION_C].setFrequency(fc);
-
-		if (algorithm[SECTION_A]) {
-			algorithm[SECTION_A]->init();
+		for (int section : {SECTION_A, SECTION_B}) {
+			for (DCBlockerT<2, float_4>& filter : blockDCFilterPoly[section]) {
+				filter.setFrequency(fc);
+			}
 		}
-		if (algorithm[SECTION_B]) {
-			algorithm[SECTION_B]->init();
+
+		for (int section : {SECTION_A, SECTION_B}) {
+			for (Voice& voice : voices[section]) {
+				if (voice.algorithm) {
+					voice.algorithm->init();
+				}
+			}
 		}
 	}
 
@@ -267,6 +363,23 @@ struct NoisePlethora : Module {
 			updateParamsTimer.trigger(updateTimeSecs);
 		}
 
+		// with nothing patched to any output there is no audio to generate, but program CV still drives the display
+		bool anyOutputConnected = false;
+		for (int i = 0; i < NUM_OUTPUTS; i++) {
+			anyOutputConnected = anyOutputConnected || outputs[i].isConnected();
+		}
+		if (idleDetector.process(anyOutputConnected)) {
+			if (updateParams) {
+				processCVOffsets(SECTION_A, PROG_A_INPUT, X_A_INPUT, Y_A_INPUT, CUTOFF_A_INPUT);
+				processCVOffsets(SECTION_B, PROG_B_INPUT, X_B_INPUT, Y_B_INPUT, CUTOFF_B_INPUT);
+			}
+			if (displayDivider.process()) {
+				updateDataForLEDDisplay();
+			}
+			processProgramBankKnobLogic(args);
+			return;
+		}
+
 		// process A, B and C
 		processTopSection(SECTION_A, X_A_PARAM, Y_A_PARAM,
 		                  FILTER_TYPE_A_PARAM, CUTOFF_A_PARAM, CUTOFF_CV_A_PARAM, RES_A_PARAM,
@@ -277,40 +390,95 @@ struct NoisePlethora : Module {
 		processBottomSection(args);
 
 		// UI
-		updateDataForLEDDisplay();
+		if (displayDivider.process()) {
+			updateDataForLEDDisplay();
+		}
 		processProgramBankKnobLogic(args);
 	}
 
+	// in polyphonic mode, a section has as many voices as its most polyphonic CV input. Also called from the UI
+	// thread by prepareAlgorithms(), where a cable being patched at the same time only makes the count stale
+	int getSectionChannels(InputIds PROG_INPUT, InputIds X_INPUT, InputIds Y_INPUT, InputIds CUTOFF_INPUT) {
+		if (!polyphonic) {
+			return 1;
+		}
+		return std::max({1, inputs[PROG_INPUT].getChannels(), inputs[X_INPUT].getChannels(),
+		                 inputs[Y_INPUT].getChannels(), inputs[CUTOFF_INPUT].getChannels()});
+	}
+
 	// process CV for section, specifically: work out the offset relative to the current
-	// program and see if this is a new algorithm
-	void processCVOffsets(Section SECTION, InputIds PROG_INPUT) {
+	// program and see if this is a new algorithm, for each voice
+	void processCVOffsets(Section SECTION, InputIds PROG_INPUT, InputIds X_INPUT, InputIds Y_INPUT, InputIds CUTOFF_INPUT) {
 
-		const int offset = 2 * inputs[PROG_INPUT].getVoltage();
+		const int channels = getSectionChannels(PROG_INPUT, X_INPUT, Y_INPUT, CUTOFF_INPUT);
 
 		const int bank = programSelector.getSection(SECTION).getBank();
-		const int numProgramsForBank = getBankForIndex(bank).getSize();
-
+		Bank& currentBank = getBankForIndex(bank);
+		const int numProgramsForBank = currentBank.getSize();
 		const int programWithoutCV = programSelector.getSection(SECTION).getProgram();
-		const int programWithCV = unsigned_modulo(programWithoutCV + offset, numProgramsForBank);
 
-		// duplicate key settings to programSelectorWithCV (expect modified program)
-		programSelectorWithCV.setMode(programSelector.getMode());
-		programSelectorWithCV.getSection(SECTION).setBank(bank);
-		programSelectorWithCV.getSection(SECTION).setProgram(programWithCV);
+		for (int c = 0; c < channels; ++c) {
+			const int offset = 2 * inputs[PROG_INPUT].getPolyVoltage(c);
+			const int programWithCV = unsigned_modulo(programWithoutCV + offset, numProgramsForBank);
 
-		const std::string newAlgorithmName = programSelectorWithCV.getSection(SECTION).getCurrentProgramName();
+			// duplicate key settings to programSelectorWithCV (expect modified program), the display shows the first voice
+			if (c == 0) {
+				programSelectorWithCV.setMode(programSelector.getMode());
+				programSelectorWithCV.getSection(SECTION).setBank(bank);
+				programSelectorWithCV.getSection(SECTION).setProgram(programWithCV);
+			}
 
-		// this is just a caching check to avoid constantly re-initialisating the algorithms
-		if (newAlgorithmName != algorithmName[SECTION]) {
+			const AlgorithmId newAlgorithmId = currentBank.getProgramId(programWithCV);
+			Voice& voice = voices[SECTION][c];
 
-			algorithm[SECTION] = MyFactory::Instance()->Create(newAlgorithmName);
-			algorithmName[SECTION] = newAlgorithmName;
+			// this is just a caching check to avoid constantly re-initialisating the algorithms
+			if (newAlgorithmId != voice.algorithmId || graphEngine != voice.engine) {
 
-			if (algorithm[SECTION]) {
-				algorithm[SECTION]->init();
+				// the pool hands over an instance that is already initialised; if it has none ready yet, or can't take
+				// the current one back yet, the current algorithm carries on and we try again at the next update
+				std::unique_ptr<NoisePlethoraPlugin> newAlgorithm;
+				if (!voice.algorithm || algorithmPool.canRetire()) {
+					newAlgorithm = algorithmPool.take(newAlgorithmId, graphEngine);
+				}
+				if (newAlgorithm) {
+					staggerBlocks(*newAlgorithm, SECTION, c);
+
+					algorithmPool.retire(voice.algorithm);
+					voice.algorithm = std::move(newAlgorithm);
+					voice.algorithmId = newAlgorithmId;
+					voice.engine = graphEngine;
+					// each algorithm has a specific gain factor
+					voice.gain = currentBank.getProgramGain(programWithCV);
+				}
 			}
-			else {
-				DEBUG("WARNING: Failed to initialise %s in programSelector", newAlgorithmName.c_str());
+		}
+
+		// channels that are no longer patched hand their algorithms back, to be freed off the audio thread. If the
+		// pool can't take one yet, the voice keeps it (silent) and it goes back at a later update
+		for (int c = channels; c < PORT_MAX_CHANNELS; ++c) {
+			Voice& voice = voices[SECTION][c];
+			if (voice.algorithm && algorithmPool.retire(voice.algorithm)) {
+				voice.algorithmId = ALGORITHM_NONE;
+			}
+		}
+		numVoices[SECTION] = channels;
+	}
+
+	// spread the block boundaries of all voices of A and B evenly over a block, so that no two graphs render on the
+	// same sample: in mono, A and B end up half a block apart
+	void staggerBlocks(NoisePlethoraPlugin& newAlgorithm, int section, int channel) {
+		const int spacing = AUDIO_BLOCK_SAMPLES / (2 * PORT_MAX_CHANNELS);
+		const int slot = section * PORT_MAX_CHANNELS + channel;
+
+		// positions are relative to any voice already playing
+		for (int otherSection : {SECTION_A, SECTION_B}) {
+			for (int c = 0; c < numVoices[otherSection]; ++c) {
+				const int otherSlot = otherSection * PORT_MAX_CHANNELS + c;
+				const auto& otherAlgorithm = voices[otherSection][c].algorithm;
+				if (otherSlot != slot && otherAlgorithm) {
+					newAlgorithm.setBlockPosition(otherAlgorithm->getBlockPosition() + (slot - otherSlot) * spacing);
+					return;
+				}
 			}
 		}
 	}
@@ -323,65 +491,111 @@ struct NoisePlethora : Module {
 
 		// periodically work out how CV should modify the current sections algorithm
 		if (updateParams) {
-			processCVOffsets(SECTION, PROG_INPUT);
+			processCVOffsets(SECTION, PROG_INPUT, X_INPUT, Y_INPUT, CUTOFF_INPUT);
 		}
 
-		float out = 0.f;
-		if (algorithm[SECTION] && outputs[OUTPUT].isConnected()) {
-			float cvX = params[X_PARAM].getValue() + rescale(inputs[X_INPUT].getVoltage(), -10.f, +10.f, -1.f, 1.f);
-			float cvY = params[Y_PARAM].getValue() + rescale(inputs[Y_INPUT].getVoltage(), -10.f, +10.f, -1.f, 1.f);
+		const int channels = numVoices[SECTION];
+		outputs[OUTPUT].setChannels(channels);
+		if (!outputs[OUTPUT].isConnected()) {
+			return;
+		}
+
+		float_4 out[4] = {};
+		for (int c = 0; c < channels; ++c) {
+			Voice& voice = voices[SECTION][c];
+			if (!voice.algorithm) {
+				continue;
+			}
 
 			// update parameters of the algorithm
 			if (updateParams) {
-				algorithm[SECTION]->process(clamp(cvX, 0.f, 1.f), clamp(cvY, 0.f, 1.f));
+				float cvX = params[X_PARAM].getValue() + rescale(inputs[X_INPUT].getPolyVoltage(c), -10.f, +10.f, -1.f, 1.f);
+				float cvY = params[Y_PARAM].getValue() + rescale(inputs[Y_INPUT].getPolyVoltage(c), -10.f, +10.f, -1.f, 1.f);
+				voice.algorithm->process(clamp(cvX, 0.f, 1.f), clamp(cvY, 0.f, 1.f));
 			}
 			// process the audio graph
-			out = algorithm[SECTION]->processGraph();
-			// each algorithm has a specific gain factor
-			out = out * programSelectorWithCV.getSection(SECTION).getCurrentProgramGain();
+			out[c / 4].s[c % 4] = voice.algorithm->processGraph() * voice.gain;
+		}
+
+		const float q = M_SQRT1_2 + std::pow(params[RES_PARAM].getValue(), 2) * 10.f;
+		const FilterMode mode = typeMappingSVF[(int) params[FILTER_TYPE_PARAM].getValue()];
+		const float cutoffCVAmount = std::pow(params[CUTOFF_CV_PARAM].getValue(), 2);
+		const float pitchFromParam = rescale(params[CUTOFF_PARAM].getValue(), 0, 1, -5.5, +5.5);
+
+		// mono keeps the scalar filters, which are bit-for-bit what they have always been
+		if (!polyphonic) {
+			float mono = out[0].s[0];
+			if (voices[SECTION][0].algorithm) {
+				// if filters are active
+				if (!bypassFilters) {
+
+					// set parameters
+					const float freqCV = cutoffCVAmount * inputs[CUTOFF_INPUT].getVoltage();
+					const float pitch = pitchFromParam + freqCV;
+					const float cutoff = clamp(dsp::FREQ_C4 * std::pow(2.f, pitch), 1.f, 20000.);
+					const float cutoffNormalised = clamp(cutoff / args.sampleRate, 0.f, 0.49f);
+					svfFilter[SECTION].setParameters(cutoffNormalised, q);
+
+					// apply filter
+					svfFilter[SECTION].process(mono);
+					// and retrieve relevant output
+					mono = svfFilter[SECTION].output(mode);
+				}
 
-			// if filters are active
+				if (blockDC) {
+					// cascaded Biquad (4th order highpass at ~20Hz)
+					mono = blockDCFilter[SECTION].process(mono);
+				}
+			}
+			outputs[OUTPUT].setVoltage(Saturator<float>::process(mono) * 5.f);
+			return;
+		}
+
+		// polyphonic, four voices at a time
+		for (int c = 0; c < channels; c += 4) {
 			if (!bypassFilters) {
+				const float_4 freqCV = cutoffCVAmount * inputs[CUTOFF_INPUT].getPolyVoltageSimd<float_4>(c);
+				const float_4 cutoff = simd::clamp(dsp::FREQ_C4 * exp2_fast(pitchFromParam + freqCV), 1.f, 20000.f);
+				const float_4 cutoffNormalised = simd::clamp(cutoff / args.sampleRate, 0.f, 0.49f);
+				svfFilterPoly[SECTION][c / 4].setParameters(cutoffNormalised, q);
 
-				// set parameters
-				const float freqCV = std::pow(params[CUTOFF_CV_PARAM].getValue(), 2) * inputs[CUTOFF_INPUT].getVoltage();
-				const float pitch = rescale(params[CUTOFF_PARAM].getValue(), 0, 1, -5.5, +5.5) + freqCV;
-				const float cutoff = clamp(dsp::FREQ_C4 * std::pow(2.f, pitch), 1.f, 20000.);
-				const float cutoffNormalised = clamp(cutoff / args.sampleRate, 0.f, 0.49f);
-				const float q = M_SQRT1_2 + std::pow(params[RES_PARAM].getValue(), 2) * 10.f;
-				const FilterMode mode = typeMappingSVF[(int) params[FILTER_TYPE_PARAM].getValue()];
-				svfFilter[SECTION].setParameters(cutoffNormalised, q);
-
-				// apply filter
-				svfFilter[SECTION].process(out);
-				// and retrieve relevant output
-				out = svfFilter[SECTION].output(mode);
+				svfFilterPoly[SECTION][c / 4].process(out[c / 4]);
+				out[c / 4] = svfFilterPoly[SECTION][c / 4].output(mode);
 			}
 
 			if (blockDC) {
-				// cascaded Biquad (4th order highpass at ~20Hz)
-				out = blockDCFilter[SECTION].process(out);
+				out[c / 4] = blockDCFilterPoly[SECTION][c / 4].process(out[c / 4]);
 			}
-		}
 
-		outputs[OUTPUT].setVoltage(Saturator<float>::process(out) * 5.f);
+			outputs[OUTPUT].setVoltageSimd(Saturator<float_4>::process(out[c / 4]) * 5.f, c);
+		}
 	}
 
 	// process section C
 	void processBottomSection(const ProcessArgs& args) {
 
-		float gritCv = rescale(clamp(inputs[GRIT_INPUT].getVoltage(), -10.f, 10.f), -10.f, 10.f, -1.f, 1.f);
-		float gritAmount = clamp(params[GRIT_PARAM].getValue() + gritCv, 0.f, 1.f);
-		float gritFrequency = 0.1 + std::pow(gritAmount, 2) * 20000;
-		gritNoiseSource.setDensity(gritFrequency);
-		float gritNoise = gritNoiseSource.process(args.sampleTime);
+		// only generate the noise sources that reach an output
+		const bool filteredConnected = outputs[FILTERED_OUTPUT].isConnected();
+		const bool useWhiteNoise = params[SOURCE_C_PARAM].getValue();
+
+		float gritNoise = 0.f;
+		if (outputs[GRITTY_OUTPUT].isConnected() || (filteredConnected && !useWhiteNoise)) {
+			float gritCv = rescale(clamp(inputs[GRIT_INPUT].getVoltage(), -10.f, 10.f), -10.f, 10.f, -1.f, 1.f);
+			float gritAmount = clamp(params[GRIT_PARAM].getValue() + gritCv, 0.f, 1.f);
+			float gritFrequency = 0.1 + std::pow(gritAmount, 2) * 20000;
+			gritNoiseSource.setDensity(gritFrequency);
+			gritNoise = gritNoiseSource.process(args.sampleTime);
+		}
 		outputs[GRITTY_OUTPUT].setVoltage(gritNoise * 5.f);
 
-		float whiteNoise = whiteNoiseSource.process();
+		float whiteNoise = 0.f;
+		if (outputs[WHITE_OUTPUT].isConnected() || (filteredConnected && useWhiteNoise)) {
+			whiteNoise = whiteNoiseSource.process();
+		}
 		outputs[WHITE_OUTPUT].setVoltage(whiteNoise * 5.f);
 
 		float out = 0.f;
-		if (outputs[FILTERED_OUTPUT].isConnected() && !bypassFilters) {
+		if (filteredConnected && !bypassFilters) {
 
 			const float freqCV = std::pow(params[CUTOFF_CV_C_PARAM].getValue(), 2) * inputs[CUTOFF_C_INPUT].getVoltage();
 			const float pitch = rescale(params[CUTOFF_C_PARAM].getValue(), 0, 1, -5.f, +6.4f) + freqCV;
@@ -391,7 +605,7 @@ struct NoisePlethora : Module {
 			const FilterMode mode = typeMappingSVF[(int) params[FILTER_TYPE_C_PARAM].getValue()];
 			svfFilterC.setParameters(cutoffNormalised, Q);
 
-			float toFilter = params[SOURCE_C_PARAM].getValue() ? whiteNoise : gritNoise;
+			float toFilter = useWhiteNoise ? whiteNoise : gritNoise;
 			out = svfFilterC.process(toFilter, mode);
 
 			// assymetric saturator, to get those lovely even harmonics
@@ -403,30 +617,29 @@ struct NoisePlethora : Module {
 			}
 		}
 		else if (bypassFilters) {
-			out = params[SOURCE_C_PARAM].getValue() ? whiteNoise : gritNoise;
+			out = useWhiteNoise ? whiteNoise : gritNoise;
 		}
 
 		outputs[FILTERED_OUTPUT].setVoltage(out * 5.f);
 	}
 
-	// set which text NoisePlethoraWidget should display on the 7 segment display
+	// set which text NoisePlethoraWidget should display on the 7 segment display, and hand it over to the UI thread
 	void updateDataForLEDDisplay() {
+		DisplayState& state = display.back();
 
-		if (programKnobMode == PROGRAM_MODE) {
-			textDisplayA = std::to_string(programSelectorWithCV.getA().getProgram());
-		}
-		else if (programKnobMode == BANK_MODE) {
-			textDisplayA = 'A' + programSelectorWithCV.getA().getBank();
+		for (int section : {SECTION_A, SECTION_B}) {
+			ProgramSelection& current = programSelectorWithCV.getSection(section);
+			if (programKnobMode == PROGRAM_MODE) {
+				snprintf(state.text[section], sizeof(state.text[section]), "%d", current.getProgram());
+			}
+			else if (programKnobMode == BANK_MODE) {
+				state.text[section][0] = 'A' + current.getBank();
+				state.text[section][1] = '\0';
+			}
+			state.active[section] = (int) programSelectorWithCV.getMode() == section;
 		}
-		isDisplayActiveA = programSelectorWithCV.getMode() == SECTION_A;
 
-		if (programKnobMode == PROGRAM_MODE) {
-			textDisplayB = std::to_string(programSelectorWithCV.getB().getProgram());
-		}
-		else if (programKnobMode == BANK_MODE) {
-			textDisplayB = 'A' + programSelectorWithCV.getB().getBank();
-		}
-		isDisplayActiveB = programSelectorWithCV.getMode() == SECTION_B;
+		display.publish();
 	}
 
 	// handle convoluted logic for the multifunction Program knob
@@ -502,10 +715,10 @@ struct NoisePlethora : Module {
 	void setAlgorithmViaProgram(int newProgram) {
 
 		const int currentBank = programSelector.getCurrent().getBank();
-		const std::string algorithmName = getBankForIndex(currentBank).getProgramName(newProgram);
+		const AlgorithmId id = getBankForIndex(currentBank).getProgramId(newProgram);
 		const int section = programSelector.getMode();
 
-		setAlgorithm(section, algorithmName);
+		setAlgorithm(section, id);
 	}
 
 	void setAlgorithmViaBank(int newBank) {
@@ -513,34 +726,53 @@ struct NoisePlethora : Module {
 		const int currentProgram = programSelector.getCurrent().getProgram();
 		// the new bank may not have as many algorithms
 		const int currentProgramInNewBank = clamp(currentProgram, 0, getBankForIndex(newBank).getSize() - 1);
-		const std::string algorithmName = getBankForIndex(newBank).getProgramName(currentProgramInNewBank);
+		const AlgorithmId id = getBankForIndex(newBank).getProgramId(currentProgramInNewBank);
 		const int section = programSelector.getMode();
 
-		setAlgorithm(section, algorithmName);
+		setAlgorithm(section, id);
 	}
 
-	void setAlgorithm(int section, std::string algorithmName) {
+	void setAlgorithm(int section, AlgorithmId id) {
 
 		if (section > 1) {
 			return;
 		}
 
-		for (int bank = 0; bank < numBanks; ++bank) {
-			for (int program = 0; program < getBankForIndex(bank).getSize(); ++program) {
-				if (getBankForIndex(bank).getProgramName(program) == algorithmName) {
-					programSelector.setMode(section);
-					programSelector.getCurrent().setBank(bank);
-					programSelector.getCurrent().setProgram(program);
-
-					return;
-				}
-			}
+		const Bank::Location location = Bank::locate(id);
+		if (location.bank < 0) {
+			return;
 		}
+		programSelector.setMode(section);
+		programSelector.getCurrent().setBank(location.bank);
+		programSelector.getCurrent().setProgram(location.program);
+	}
 
-		DEBUG("WARNING: Didn't find %s in programSelector", algorithmName.c_str());
+	// algorithms are saved by name
+	void setAlgorithm(int section, const std::string& algorithmName) {
+		const AlgorithmId id = findAlgorithm(algorithmName);
+		if (id == ALGORITHM_NONE) {
+			DEBUG("WARNING: Didn't find %s in programSelector", algorithmName.c_str());
+			return;
+		}
+		setAlgorithm(section, id);
 	}
 
 	void dataFromJson(json_t* rootJ) override {
+		json_t* graphEngineJ = json_object_get(rootJ, "graphEngine");
+		if (graphEngineJ) {
+			graphEngine = (GraphEngine) clamp((int) json_integer_value(graphEngineJ), 0, NUM_GRAPH_ENGINES - 1);
+		}
+
+		json_t* preloadAlgorithmsJ = json_object_get(rootJ, "preloadAlgorithms");
+		if (preloadAlgorithmsJ) {
+			preloadAlgorithms = json_boolean_value(preloadAlgorithmsJ);
+		}
+
+		json_t* polyphonicJ = json_object_get(rootJ, "polyphonic");
+		if (polyphonicJ) {
+			polyphonic = json_boolean_value(polyphonicJ);
+		}
+
 		json_t* bankAJ = json_object_get(rootJ, "algorithmA");
 		if (bankAJ) {
 			setAlgorithm(SECTION_A, json_string_value(bankAJ));
@@ -560,16 +792,21 @@ struct NoisePlethora : Module {
 		if (blockDCJ) {
 			blockDC = json_boolean_value(blockDCJ);
 		}
+
+		prepareAlgorithms();
 	}
 
 	json_t* dataToJson() override {
 		json_t* rootJ = json_object();
 
-		json_object_set_new(rootJ, "algorithmA", json_string(programSelector.getA().getCurrentProgramName().c_str()));
-		json_object_set_new(rootJ, "algorithmB", json_string(programSelector.getB().getCurrentProgramName().c_str()));
+		json_object_set_new(rootJ, "algorithmA", json_string(getAlgorithmName(programSelector.getA().getCurrentProgramId())));
+		json_object_set_new(rootJ, "algorithmB", json_string(getAlgorithmName(programSelector.getB().getCurrentProgramId())));
 
 		json_object_set_new(rootJ, "bypassFilters", json_boolean(bypassFilters));
 		json_object_set_new(rootJ, "blockDC", json_boolean(blockDC));
+		json_object_set_new(rootJ, "graphEngine", json_integer(graphEngine));
+		json_object_set_new(rootJ, "preloadAlgorithms", json_boolean(preloadAlgorithms));
+		json_object_set_new(rootJ, "polyphonic", json_boolean(polyphonic));
 
 		return rootJ;
 	}
@@ -713,7 +950,7 @@ struct NoisePlethoraLEDDisplay : LightWidget {
 
 			std::string text = "A";  // fallback if module not yet defined
 			if (module) {
-				text = (section == NoisePlethora::SECTION_A) ? module->textDisplayA : module->textDisplayB;
+				text = module->display.front().text[section];
 			}
 			char buffer[numChars + 1];
 			int l = text.size();
@@ -740,7 +977,7 @@ struct NoisePlethoraLEDDisplay : LightWidget {
 		}
 
 		if (module) {
-			const bool isSectionDisplayActive = (section == NoisePlethora::SECTION_A) ? module->isDisplayActiveA : module->isDisplayActiveB;
+			const bool isSectionDisplayActive = module->display.front().active[section];
 
 			// active bank dot
 			nvgBeginPath(args.vg);
@@ -820,6 +1057,15 @@ struct NoisePlethoraWidget : ModuleWidget {
 		addChild(displayB);
 	}
 
+	void step() override {
+		NoisePlethora* module = dynamic_cast<NoisePlethora*>(this->module);
+		if (module) {
+			// pick up the latest display state once per frame, for both LED displays
+			module->display.consume();
+		}
+		ModuleWidget::step();
+	}
+
 	void appendContextMenu(Menu* menu) override {
 		NoisePlethora* module = dynamic_cast<NoisePlethora*>(this->module);
 		assert(module);
@@ -839,26 +1085,13 @@ struct NoisePlethoraWidget : ModuleWidget {
 					menu->addChild(createSubmenuItem(string::f("Bank %d: %s", i + 1, bankAliases[i].c_str()), currentBank == i ? CHECKMARK_STRING : "", [ = ](Menu * menu) {
 						for (int j = 0; j < getBankForIndex(i).getSize(); ++j) {
 							const bool currentProgramAndBank = (currentProgram == j) && (currentBank == i);
-							const std::string algorithmName = getBankForIndex(i).getProgramName(j);
-
-							bool implemented = false;
-							for (auto item : MyFactory::Instance()->factoryFunctionRegistry) {
-								if (item.first == algorithmName) {
-									implemented = true;
-									break;
-								}
-							}
-
-							if (implemented) {
-								menu->addChild(createMenuItem(algorithmName, currentProgramAndBank ? CHECKMARK_STRING : "",
-								[ = ]() {
-									module->setAlgorithm(sectionId, algorithmName);
-								}));
-							}
-							else {
-								// placeholder text (greyed out)
-								menu->addChild(createMenuLabel(algorithmName));
-							}
+							const AlgorithmId id = getBankForIndex(i).getProgramId(j);
+
+							menu->addChild(createMenuItem(getAlgorithmName(id), currentProgramAndBank ? CHECKMARK_STRING : "",
+							[ = ]() {
+								module->setAlgorithm(sectionId, id);
+								module->prepareAlgorithms();
+							}));
 						}
 					}));
 				}
@@ -866,12 +1099,42 @@ struct NoisePlethoraWidget : ModuleWidget {
 
 
 		}
+		menu->addChild(createBoolMenuItem("Polyphonic", "",
+		[ = ]() {
+			return module->polyphonic;
+		},
+		[ = ](bool polyphonic) {
+			module->polyphonic = polyphonic;
+			module->prepareAlgorithms();
+		}
+		                                 ));
 
 		menu->addChild(createMenuLabel("Filters"));
 		menu->addChild(createBoolPtrMenuItem("Remove DC", "", &module->blockDC));
 		menu->addChild(createBoolPtrMenuItem("Bypass Filters", "", &module->bypassFilters));
+
+		menu->addChild(createMenuLabel("Audio engine"));
+		menu->addChild(createIndexSubmenuItem("Algorithm engine",
+		{"Hardware-exact (int16)", "Fast (float)"},
+		[ = ]() {
+			return module->graphEngine;
+		},
+		[ = ](int engine) {
+			module->graphEngine = (GraphEngine) engine;
+			module->prepareAlgorithms();
+		}
+		                                     ));
+		menu->addChild(createBoolMenuItem("Preload all algorithms", "",
+		[ = ]() {
+			return module->preloadAlgorithms;
+		},
+		[ = ](bool preload) {
+			module->preloadAlgorithms = preload;
+			module->prepareAlgorithms();
+		}
+		                                 ));
 	}
 };
 
 
-Model* modelNoisePlethora = createModel<NoisePlethora, NoisePlethoraWidget>("NoisePlethora");
\ No newline at end of file
+Model* modelNoisePlethora = createModelWithTelemetry<NoisePlethora, NoisePlethoraWidget>("NoisePlethora");
\ No newline at end of file
@@ -28,11 +28,12 @@ struct Percall : Module {
 
 	ADEnvelope envs[4];
 
-	float gains[4] = {};
+	ControlRateValue<float> gains[4];
 
 	dsp::SchmittTrigger trigger[4];
-	dsp::ClockDivider cvDivider;
+	ControlRate<NUM_PARAMS> controlRate;
 	dsp::ClockDivider lightDivider;
+	IdleDetector idleDetector;
 	const int LAST_CHANNEL_ID = 3;
 
 	const float attackTime = 1.5e-3;
@@ -60,24 +61,50 @@ struct Percall : Module {
 			configParam(CHOKE_PARAMS + i, 0.f, 1.f, 0.f, string::f("Choke %d to %d", 2 * i + 1, 2 * i + 2));
 		}
 
-		cvDivider.setDivision(16);
+		controlRate.setDivision(16);
 		lightDivider.setDivision(128);
 	}
 
 	void process(const ProcessArgs& args) override {
 
+		// triggers are checked even when idle, so that a hit wakes the module on the same sample
+		bool triggered[4] = {};
+		bool active = false;
+		for (int i = 0; i < 4; i++) {
+			triggered[i] = trigger[i].process(rescale(inputs[TRIG_INPUTS + i].getVoltage(), 0.1f, 2.f, 0.f, 1.f));
+			active = active || triggered[i] || envs[i].stage != ADEnvelope::STAGE_OFF;
+		}
+
+		// with every envelope off, all outputs are silent
+		if (idleDetector.process(active)) {
+			if (idleDetector.enteredIdle()) {
+				for (int i = 0; i < NUM_OUTPUTS; i++) {
+					outputs[i].clearVoltages();
+				}
+				for (int i = 0; i < 4; i++) {
+					lights[LEDS + i].setBrightness(0.f);
+				}
+			}
+			return;
+		}
+
 		float strength = 1.0f;
 		if (inputs[STRENGTH_INPUT].isConnected()) {
 			strength = std::sqrt(clamp(inputs[STRENGTH_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f));
 		}
 
-		// only calculate gains/decays every 16 samples
-		if (cvDivider.process()) {
+		// only calculate gains/decays every 16 samples, gains are ramped in between
+		if (controlRate.process() || idleDetector.leftIdle()) {
+			// on waking up, jump straight to the current gains so the first hit is sample-accurate
+			const int samples = idleDetector.leftIdle() ? 1 : controlRate.getDivision();
 			for (int i = 0; i < 4; i++) {
-				gains[i] = std::pow(params[VOL_PARAMS + i].getValue(), 2.f) * strength;
+				const float vol = params[VOL_PARAMS + i].getValue();
+				gains[i].setTarget(vol * vol * strength, samples);
 
-				float fallCv = inputs[CV_INPUTS + i].getVoltage() * 0.05f + params[DECAY_PARAMS + i].getValue();
-				envs[i].decayTime = rescale(std::pow(clamp(fallCv, 0.f, 1.0f), 2.f), 0.f, 1.f, minDecayTime, maxDecayTime);
+				const float fall = clamp(inputs[CV_INPUTS + i].getVoltage() * 0.05f + params[DECAY_PARAMS + i].getValue(), 0.f, 1.0f);
+				if (controlRate.changed(DECAY_PARAMS + i, fall)) {
+					envs[i].decayTime = rescale(fall * fall, 0.f, 1.f, minDecayTime, maxDecayTime);
+				}
 			}
 		}
 
@@ -87,7 +114,7 @@ struct Percall : Module {
 		// Mixer channels
 		for (int i = 0; i < 4; i++) {
 
-			if (trigger[i].process(rescale(inputs[TRIG_INPUTS + i].getVoltage(), 0.1f, 2.f, 0.f, 1.f))) {
+			if (triggered[i]) {
 				envs[i].trigger();
 			}
 			// if choke is enabled, and current channel is odd and left channel is in attack
@@ -98,6 +125,7 @@ struct Percall : Module {
 			}
 
 			envs[i].process(args.sampleTime);
+			const float gain = gains[i].process() * envs[i].env;
 
 			int polyphonyChannels = 1;
 			float_4 in[4] = {};
@@ -115,7 +143,6 @@ struct Percall : Module {
 
 				// only process input audio if envelope is active
 				if (envs[i].stage != ADEnvelope::STAGE_OFF) {
-					float gain = gains[i] * envs[i].env;
 					for (int c = 0; c < polyphonyChannels; c += 4) {
 						in[c / 4] = inputs[channelToReadFrom].getVoltageSimd<float_4>(c) * gain;
 					}
@@ -224,4 +251,4 @@ struct PercallWidget : ModuleWidget {
 };
 
 
-Model* modelPercall = createModel<Percall, PercallWidget>("Percall");
\ No newline at end of file
+Model* modelPercall = createModelWithTelemetry<Percall, PercallWidget>("Percall");
\ No newline at end of file
@@ -104,8 +104,33 @@ struct PonyVCO : Module {
 	};
 
 	float range[4] = {8.f, 1.f, 1.f / 12.f, 10.f};
-	chowdsp::VariableOversampling<6, float_4> oversampler[4]; 	// uses a 2*6=12th order Butterworth filter
+	using Oversampler = chowdsp::VariableOversampling<6, float_4>;
+	Oversampler oversampler[4]; 	// uses a 2*6=12th order Butterworth filter (or polyphase half-band)
 	int oversamplingIndex = 1; 	// default is 2^oversamplingIndex == x2 oversampling
+	using FilterType = Oversampler::FilterType;
+	FilterType antialiasingFilter = Oversampler::IIR_BUTTERWORTH;
+	// each group picks its own ratio, up to oversamplingIndex, from the bandwidth of its voices
+	bool adaptiveOversampling = false;
+	// set by the context menu, the oversamplers are rebuilt at the start of the next process() call
+	std::atomic<bool> oversamplingChanged{false};
+
+	// per group, the highest oscillator bandwidth (see oscillatorBandwidth()) and the last output of the block
+	float_4 groupBandwidth[4] = {};
+	float_4 groupOutput[4] = {};
+	int numGroups = 1;
+
+	int getOversamplingRatio() {
+		// LFO mode is never oversampled
+		if (params[RANGE_PARAM].getValue() == 3) {
+			return 1;
+		}
+		// in adaptive mode the groups can run at different ratios, report the highest
+		int ratio = 1;
+		for (int g = 0; g < numGroups; g++) {
+			ratio = std::max(ratio, oversampler[g].getOversamplingRatio());
+		}
+		return ratio;
+	}
 
 	dsp::TRCFilter<float_4> blockTZFMDCFilter[4];
 	bool blockTZFMDC = true;
@@ -121,6 +146,8 @@ struct PonyVCO : Module {
 	FoldStage1<float_4> stage1[4];
 	FoldStage2<float_4> stage2[4];
 
+	BlockProcessor<INPUTS_LEN, OUTPUTS_LEN> block;
+
 	PonyVCO() {
 		config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
 		configParam(FREQ_PARAM, -0.5f, 0.5f, 0.0f, "Frequency");
@@ -149,7 +176,9 @@ struct PonyVCO : Module {
 		float sampleRate = APP->engine->getSampleRate();
 		for (int c = 0; c < 4; c++) {
 			blockTZFMDCFilter[c].setCutoffFreq(5.0 / sampleRate);
+			oversampler[c].setAdaptive(adaptiveOversampling);
 			oversampler[c].setOversamplingIndex(oversamplingIndex);
+			oversampler[c].setFilterType(antialiasingFilter);
 			oversampler[c].reset(sampleRate);
 
 			stage1[c].reset();
@@ -164,6 +193,13 @@ struct PonyVCO : Module {
 	float_4 phase[4] = {}; 	// phase at current (sub)sample
 
 	void process(const ProcessArgs& args) override {
+		if (oversamplingChanged.exchange(false)) {
+			onSampleRateChange();
+		}
+		block.process(this, args);
+	}
+
+	void processBlock(const ProcessArgs& args, const int frames) {
 
 		const int rangeIndex = params[RANGE_PARAM].getValue();
 		const bool lfoMode = rangeIndex == 3;
@@ -171,22 +207,90 @@ struct PonyVCO : Module {
 		const Waveform waveform = (Waveform) params[WAVE_PARAM].getValue();
 		const float mult = lfoMode ? 1.0 : dsp::FREQ_C4;
 		const float baseFreq = std::pow(2, (int)(params[OCT_PARAM].getValue() - 3)) * mult;
-		const int oversamplingRatio = lfoMode ? 1 : oversampler[0].getOversamplingRatio();
+		const GroupSettings settings = {
+			waveform,
+			baseFreq,
+			params[TIMBRE_PARAM].getValue(),
+			params[FREQ_PARAM].getValue() * range[rangeIndex]
+		};
 
 		// number of active polyphony engines (must be at least 1)
-		const int channels = std::max({inputs[TZFM_INPUT].getChannels(), inputs[VOCT_INPUT].getChannels(), inputs[TIMBRE_INPUT].getChannels(), 1});
+		const int channels = std::max({block.getChannels(TZFM_INPUT), block.getChannels(VOCT_INPUT), block.getChannels(TIMBRE_INPUT), 1});
+		numGroups = (channels + 3) / 4;
 
+		// each group of 4 channels has independent state, so run it over the whole block before moving to the next
 		for (int c = 0; c < channels; c += 4) {
-			const float_4 timbre = simd::clamp(params[TIMBRE_PARAM].getValue() + inputs[TIMBRE_INPUT].getPolyVoltageSimd<float_4>(c) / 10.f, 0.f, 1.f);
+			if (lfoMode) {
+				NoOversampling passthrough;
+				processGroup<1>(args, settings, frames, c, passthrough);
+			}
+			else {
+				oversampler[c / 4].dispatch(OversampledGroup{this, args, settings, frames, c});
+
+				if (adaptiveOversampling) {
+					float bandwidth = 0.f;
+					for (int i = 0; i < std::min(4, channels - c); i++) {
+						bandwidth = std::max(bandwidth, groupBandwidth[c / 4][i]);
+					}
+					// the oscillator runs at the oversampled rate, so only the downsampler has state to carry over
+					oversampler[c / 4].adapt(bandwidth, frames, 0.f, groupOutput[c / 4]);
+				}
+			}
+		}
+
+		outputs[OUT_OUTPUT].setChannels(channels);
+	}
+
+	struct GroupSettings {
+		Waveform waveform;
+		float baseFreq;
+		float timbreParam;
+		float freqOffset;
+	};
+
+	// LFO mode is never oversampled, processGroup() only uses osBuffer[0] at a ratio of 1
+	struct NoOversampling {
+		float_4 osBuffer[1] = {};
+
+		float_4 downsample() {
+			return osBuffer[0];
+		}
+	};
+
+	// runs processGroup() with the concrete oversampler for the current ratio and filter type
+	struct OversampledGroup {
+		PonyVCO* module;
+		const ProcessArgs& args;
+		const GroupSettings& settings;
+		int frames;
+		int c;
+
+		template <int ratio, Oversampler::FilterType type>
+		void run() {
+			module->processGroup<ratio>(args, settings, frames, c, module->oversampler[c / 4].get<ratio, type>());
+		}
+	};
 
-			float_4 tzfmVoltage = inputs[TZFM_INPUT].getPolyVoltageSimd<float_4>(c);
+	// processes channels [c, c + 4) over the block, with the oversampling ratio fixed at compile time
+	template <int oversamplingRatio, typename TOversampler>
+	void processGroup(const ProcessArgs& args, const GroupSettings& settings, const int frames, const int c, TOversampler& os) {
+		const Waveform waveform = settings.waveform;
+		const float baseFreq = settings.baseFreq;
+		const float timbreParam = settings.timbreParam;
+		const float freqOffset = settings.freqOffset;
+		float_4 peakBandwidth = 0.f;
+
+		for (int frame = 0; frame < frames; ++frame) {
+			const float_4 timbre = simd::clamp(timbreParam + block.getPolyVoltageSimd<float_4>(TIMBRE_INPUT, frame, c) / 10.f, 0.f, 1.f);
+
+			float_4 tzfmVoltage = block.getPolyVoltageSimd<float_4>(TZFM_INPUT, frame, c);
 			if (blockTZFMDC) {
 				blockTZFMDCFilter[c / 4].process(tzfmVoltage);
 				tzfmVoltage = blockTZFMDCFilter[c / 4].highpass();
 			}
 
-			const float_4 pitch = inputs[VOCT_INPUT].getPolyVoltageSimd<float_4>(c) + params[FREQ_PARAM].getValue() * range[rangeIndex];
-			const float_4 freq = baseFreq * simd::pow(2.f, pitch);
+			const float_4 pitch = block.getPolyVoltageSimd<float_4>(VOCT_INPUT, frame, c) + freqOffset;
+			const float_4 freq = baseFreq * exp2_fast(pitch);
 			const float_4 deltaBasePhase = simd::clamp(freq * args.sampleTime / oversamplingRatio, -0.5f, 0.5f);
 			// floating point arithmetic doesn't work well at low frequencies, specifically because the finite difference denominator
 			// becomes tiny - we check for that scenario and use naive / 1st order waveforms in that frequency regime (as aliasing isn't
@@ -198,6 +302,10 @@ struct PonyVCO : Module {
 			// not clamped, but _total_ phase treated later with floor/ceil
 			const float_4 deltaFMPhase = freq * tzfmVoltage * args.sampleTime / oversamplingRatio;
 
+			if (adaptiveOversampling) {
+				peakBandwidth = simd::fmax(peakBandwidth, oscillatorBandwidth(waveform, freq, tzfmVoltage, timbre));
+			}
+
 			float_4 pw = timbre;
 			if (limitPW) {
 				pw = clamp(pw, 0.05, 0.95);
@@ -207,7 +315,7 @@ struct PonyVCO : Module {
 			const float_4 pulseDCOffset = (!removePulseDC) * 2.f * (0.5f - pw);
 
 			// hard sync
-			const float_4 syncMask = syncTrigger[c / 4].process(inputs[SYNC_INPUT].getPolyVoltageSimd<float_4>(c));
+			const float_4 syncMask = syncTrigger[c / 4].process(block.getPolyVoltageSimd<float_4>(SYNC_INPUT, frame, c));
 			if (waveform == WAVE_SIN) {
 				// hardware waveform is actually cos, so pi/2 phase offset is required
 				// - variable phase is defined on [0, 1] rather than [0, 2pi] so pi/2 -> 0.25
@@ -217,7 +325,7 @@ struct PonyVCO : Module {
 				phase[c / 4] = simd::ifelse(syncMask, 0.f, phase[c / 4]);
 			}
 
-			float_4* osBuffer = oversampler[c / 4].getOSBuffer();
+			float_4* osBuffer = os.osBuffer;
 			for (int i = 0; i < oversamplingRatio; ++i) {
 
 				phase[c / 4] += deltaBasePhase + deltaFMPhase;
@@ -272,15 +380,27 @@ struct PonyVCO : Module {
 			} 	// end of oversampling loop
 
 			// downsample (if required)
-			const float_4 out = (oversamplingRatio > 1) ? oversampler[c / 4].downsample() : osBuffer[0];
+			const float_4 out = (oversamplingRatio > 1) ? os.downsample() : osBuffer[0];
+			groupOutput[c / 4] = out;
 
 			// end of chain VCA
-			const float_4 gain = simd::clamp(inputs[VCA_INPUT].getNormalPolyVoltageSimd<float_4>(10.f, c) / 10.f, 0.f, 1.f);
-			outputs[OUT_OUTPUT].setVoltageSimd(5.f * out * gain, c);
+			const float_4 gain = simd::clamp(block.getNormalPolyVoltageSimd<float_4>(VCA_INPUT, frame, 10.f, c) / 10.f, 0.f, 1.f);
+			block.setVoltageSimd(OUT_OUTPUT, frame, 5.f * out * gain, c);
+		}
 
-		} 	// end of channels loop
+		groupBandwidth[c / 4] = peakBandwidth;
+	}
 
-		outputs[OUT_OUTPUT].setChannels(channels);
+	// rough upper frequency (Hz) of the significant harmonics, for adaptive oversampling: the peak instantaneous
+	// frequency (through-zero FM included) times the number of harmonics the waveform and wavefolder produce
+	static float_4 oscillatorBandwidth(Waveform waveform, float_4 freq, float_4 tzfmVoltage, float_4 timbre) {
+		// the DPW waveforms already suppress most of their own aliasing, so count their harmonics to about -30 dB
+		float_4 harmonics = (waveform == WAVE_SIN) ? 1.f : (waveform == WAVE_TRI) ? 6.f : 24.f;
+		if (waveform != WAVE_PULSE) {
+			// timbre lowers the wavefolder threshold, and each extra fold adds harmonics
+			harmonics += 32.f * timbre;
+		}
+		return simd::abs(freq) * (1.f + simd::abs(tzfmVoltage)) * harmonics;
 	}
 
 	float_4 aliasSuppressedTri(float_4* phases) {
@@ -324,7 +444,10 @@ struct PonyVCO : Module {
 		json_object_set_new(rootJ, "blockTZFMDC", json_boolean(blockTZFMDC));
 		json_object_set_new(rootJ, "removePulseDC", json_boolean(removePulseDC));
 		json_object_set_new(rootJ, "limitPW", json_boolean(limitPW));
-		json_object_set_new(rootJ, "oversamplingIndex", json_integer(oversampler[0].getOversamplingIndex()));
+		json_object_set_new(rootJ, "oversamplingIndex", json_integer(oversamplingIndex));
+		json_object_set_new(rootJ, "antialiasingFilter", json_integer(antialiasingFilter));
+		json_object_set_new(rootJ, "adaptiveOversampling", json_boolean(adaptiveOversampling));
+		json_object_set_new(rootJ, "blockSize", json_integer(block.getBlockSize()));
 		return rootJ;
 	}
 
@@ -350,6 +473,23 @@ struct PonyVCO : Module {
 			oversamplingIndex = json_integer_value(oversamplingIndexJ);
 			onSampleRateChange();
 		}
+
+		json_t* antialiasingFilterJ = json_object_get(rootJ, "antialiasingFilter");
+		if (antialiasingFilterJ) {
+			antialiasingFilter = (FilterType) clamp((int) json_integer_value(antialiasingFilterJ), 0, Oversampler::NUM_FILTER_TYPES - 1);
+			onSampleRateChange();
+		}
+
+		json_t* adaptiveOversamplingJ = json_object_get(rootJ, "adaptiveOversampling");
+		if (adaptiveOversamplingJ) {
+			adaptiveOversampling = json_boolean_value(adaptiveOversamplingJ);
+			onSampleRateChange();
+		}
+
+		json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+		if (blockSizeJ) {
+			block.setBlockSize(json_integer_value(blockSizeJ));
+		}
 	}
 };
 
@@ -397,11 +537,34 @@ struct PonyVCOWidget : ModuleWidget {
 		},
 		[ = ](int mode) {
 			module->oversamplingIndex = mode;
-			module->onSampleRateChange();
+			module->oversamplingChanged = true;
 		}
 		                                     ));
 
+		menu->addChild(createIndexSubmenuItem("Anti-aliasing filter",
+		{"Butterworth (IIR)", "Half-band (polyphase)", "Chebyshev II (IIR)", "Elliptic (IIR)", "Linear phase (FIR)"},
+		[ = ]() {
+			return module->antialiasingFilter;
+		},
+		[ = ](int type) {
+			module->antialiasingFilter = (PonyVCO::FilterType) type;
+			module->oversamplingChanged = true;
+		}
+		                                     ));
+
+		menu->addChild(createBoolMenuItem("Adaptive oversampling", "up to the ratio above",
+		[ = ]() {
+			return module->adaptiveOversampling;
+		},
+		[ = ](bool adaptive) {
+			module->adaptiveOversampling = adaptive;
+			module->oversamplingChanged = true;
+		}
+		                                 ));
+
+		menu->addChild(createBlockSizeMenuItem(&module->block));
+
 	}
 };
 
-Model* modelPonyVCO = createModel<PonyVCO, PonyVCOWidget>("PonyVCO");
\ No newline at end of file
+Model* modelPonyVCO = createModelWithTelemetry<PonyVCO, PonyVCOWidget>("PonyVCO");
\ No newline at end of file
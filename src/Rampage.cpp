@@ -235,7 +235,7 @@ struct Rampage : Module {
 				rateCV = ifelse(delta_lt_0, fallCV[c / 4], rateCV);
 				rateCV = clamp(rateCV, 0.f, 10.0f);
 
-				float_4 rate = minTime * simd::pow(2.0f, rateCV);
+				float_4 rate = minTime * exp2_fast(rateCV);
 
 				float shape = params[SHAPE_A_PARAM + part].getValue();
 				out[part][c / 4] += shapeDelta(delta, rate, shape) * args.sampleTime;
@@ -402,4 +402,4 @@ struct RampageWidget : ModuleWidget {
 };
 
 
-Model* modelRampage = createModel<Rampage, RampageWidget>("Rampage");
+Model* modelRampage = createModelWithTelemetry<Rampage, RampageWidget>("Rampage");
@@ -136,4 +136,4 @@ struct STMixWidget : ModuleWidget {
 };
 
 
-Model* modelSTMix = createModel<STMix, STMixWidget>("STMix");
\ No newline at end of file
+Model* modelSTMix = createModelWithTelemetry<STMix, STMixWidget>("STMix");
\ No newline at end of file
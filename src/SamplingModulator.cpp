@@ -265,4 +265,4 @@ struct SamplingModulatorWidget : ModuleWidget {
 };
 
 
-Model* modelSamplingModulator = createModel<SamplingModulator, SamplingModulatorWidget>("SamplingModulator");
\ No newline at end of file
+Model* modelSamplingModulator = createModelWithTelemetry<SamplingModulator, SamplingModulatorWidget>("SamplingModulator");
\ No newline at end of file
@@ -22,6 +22,14 @@ struct SlewLimiter : Module {
 
 	float_4 out[4] = {};
 
+	// minimum and maximum slopes in volts per second
+	static constexpr float slewMin = 0.1;
+	static constexpr float slewMax = 10000.f;
+
+	// slopes set by the rise/fall knobs, evaluated at control rate
+	ControlRate<NUM_PARAMS> controlRate;
+	ControlRateValue<float> knobSlew[2];
+
 	SlewLimiter() {
 		config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS);
 		configParam(SHAPE_PARAM, 0.0, 1.0, 0.0, "Shape");
@@ -29,6 +37,10 @@ struct SlewLimiter : Module {
 		configParam(FALL_PARAM, 0.0, 1.0, 0.0, "Fall time");
 		configBypass(IN_INPUT, OUT_OUTPUT);
 
+		controlRate.setDivision(16);
+		knobSlew[0].interpolation = ControlRateValue<float>::EXPONENTIAL;
+		knobSlew[1].interpolation = ControlRateValue<float>::EXPONENTIAL;
+
 		configInput(RISE_INPUT, "Rise CV");
 		configInput(FALL_INPUT, "Fall CV");
 	}
@@ -36,46 +48,51 @@ struct SlewLimiter : Module {
 	void process(const ProcessArgs& args) override {
 
 		float_4 in[4] = {};
-		float_4 riseCV[4] = {};
-		float_4 fallCV[4] = {};
 
 		// this is the number of active polyphony engines, defined by the input
 		int numPolyphonyEngines = inputs[IN_INPUT].getChannels();
 
-		// minimum and std::maximum slopes in volts per second
-		const float slewMin = 0.1;
-		const float slewMax = 10000.f;
 		// Amount of extra slew per voltage difference
 		const float shapeScale = 1 / 10.f;
 
-		const float_4 param_rise = params[RISE_PARAM].getValue() * 10.f;
-		const float_4 param_fall = params[FALL_PARAM].getValue() * 10.f;
+		// slew = slewMax * (slewMin / slewMax)^(knob + CV / 10), so the knob's share is a control-rate value,
+		// and the CV's share is a per-sample exp2 only when patched
+		if (controlRate.process()) {
+			for (int i = 0; i < 2; i++) {
+				const float knob = params[RISE_PARAM + i].getValue();
+				if (controlRate.changed(RISE_PARAM + i, knob)) {
+					knobSlew[i].setTarget(slewMax * std::pow(slewMin / slewMax, knob), controlRate.getDivision());
+				}
+			}
+		}
+		const float riseSlew = knobSlew[0].process();
+		const float fallSlew = knobSlew[1].process();
+		const bool riseCVConnected = inputs[RISE_INPUT].isConnected();
+		const bool fallCVConnected = inputs[FALL_INPUT].isConnected();
+		// log2(slewMin / slewMax) / 10
+		const float slewPerCVOctaves = -1.6609640474f;
 
 		outputs[OUT_OUTPUT].setChannels(numPolyphonyEngines);
 
 		for (int c = 0; c < numPolyphonyEngines; c += 4) {
 			in[c / 4] = inputs[IN_INPUT].getVoltageSimd<float_4>(c);
 
-			if (inputs[RISE_INPUT].isConnected()) {
-				riseCV[c / 4] = inputs[RISE_INPUT].getPolyVoltageSimd<float_4>(c);
+			float_4 rise = riseSlew;
+			if (riseCVConnected) {
+				rise *= exp2_fast(slewPerCVOctaves * inputs[RISE_INPUT].getPolyVoltageSimd<float_4>(c));
 			}
-			if (inputs[FALL_INPUT].isConnected()) {
-				fallCV[c / 4] = inputs[FALL_INPUT].getPolyVoltageSimd<float_4>(c);
+			float_4 fall = fallSlew;
+			if (fallCVConnected) {
+				fall *= exp2_fast(slewPerCVOctaves * inputs[FALL_INPUT].getPolyVoltageSimd<float_4>(c));
 			}
 
-			riseCV[c / 4] += param_rise;
-			fallCV[c / 4] += param_fall;
-
 			float_4 delta = in[c / 4] - out[c / 4];
 			float_4 delta_gt_0 = delta > 0.f;
 			float_4 delta_lt_0 = delta < 0.f;
 
-			float_4 rateCV = {};
-			rateCV = ifelse(delta_gt_0, riseCV[c / 4], 0.f);
-			rateCV = ifelse(delta_lt_0, fallCV[c / 4], rateCV) * 0.1f;
-
+			// (with delta == 0 the slope is irrelevant, as pm_one and delta are both zero)
 			float_4 pm_one = simd::sgn(delta);
-			float_4 slew = slewMax * simd::pow(slewMin / slewMax, rateCV);
+			float_4 slew = ifelse(delta_gt_0, rise, fall);
 
 			const float shape = params[SHAPE_PARAM].getValue();
 			out[c / 4] += slew * simd::crossfade(pm_one, shapeScale * delta, shape) * args.sampleTime;
@@ -110,4 +127,4 @@ struct SlewLimiterWidget : ModuleWidget {
 };
 
 
-Model* modelSlewLimiter = createModel<::SlewLimiter, SlewLimiterWidget>("SlewLimiter");
+Model* modelSlewLimiter = createModelWithTelemetry<::SlewLimiter, SlewLimiterWidget>("SlewLimiter");
@@ -1,21 +1,59 @@
 #include "plugin.hpp"
 #include <pffft.h>
 
-static std::vector<uint8_t> ir;
+static const size_t BLOCK_SIZE = 1024;
 
-static void initIR() {
-	if (!ir.empty())
-		return;
+// the IR transformed into RealTimeConvolver's kernel layout (kernelBlocks FFTs of 2 * BLOCK_SIZE floats),
+// computed once and shared by every instance
+struct KernelFfts {
+	float* data = NULL;
+	size_t blocks = 0;
+	// length of the IR in samples
+	size_t length = 0;
+
+	~KernelFfts() {
+		if (data) {
+			pffft_aligned_free(data);
+		}
+	}
+};
 
+static void loadKernelFfts(KernelFfts& kernel) {
+	std::vector<uint8_t> ir;
 	try {
 		ir = system::readFile(asset::plugin(pluginInstance, "res/SpringReverbIR.f32"));
 	}
 	catch (std::exception& e) {
 		WARN("Cannot load IR: %s", e.what());
 	}
+
+	// let RealTimeConvolver do the transform, then take ownership of the result
+	dsp::RealTimeConvolver convolver(BLOCK_SIZE);
+	kernel.length = ir.size() / sizeof(float);
+	convolver.setKernel((const float*) ir.data(), kernel.length);
+	kernel.data = convolver.kernelFfts;
+	kernel.blocks = convolver.kernelBlocks;
+	convolver.kernelFfts = NULL;
 }
 
-static const size_t BLOCK_SIZE = 1024;
+/** A RealTimeConvolver that uses a shared kernel FFT rather than computing its own, only the input history is per instance */
+struct SharedKernelConvolver : dsp::RealTimeConvolver {
+	std::shared_ptr<const KernelFfts> kernel;
+
+	SharedKernelConvolver(size_t blockSize, std::shared_ptr<const KernelFfts> kernel) : dsp::RealTimeConvolver(blockSize), kernel(kernel) {
+		if (kernel->blocks > 0) {
+			kernelBlocks = kernel->blocks;
+			kernelFfts = kernel->data;
+			inputFfts = (float*) pffft_aligned_malloc(sizeof(float) * blockSize * 2 * kernelBlocks);
+			std::memset(inputFfts, 0, sizeof(float) * blockSize * 2 * kernelBlocks);
+		}
+	}
+
+	~SharedKernelConvolver() {
+		// not ours, so stop ~RealTimeConvolver() from freeing it (it still frees inputFfts)
+		kernelFfts = NULL;
+	}
+};
 
 
 struct SpringReverb : Module {
@@ -45,7 +83,7 @@ struct SpringReverb : Module {
 		NUM_LIGHTS
 	};
 
-	dsp::RealTimeConvolver* convolver = NULL;
+	SharedKernelConvolver* convolver = NULL;
 	dsp::SampleRateConverter<1> inputSrc;
 	dsp::SampleRateConverter<1> outputSrc;
 	dsp::DoubleRingBuffer<dsp::Frame<1>, 16 * BLOCK_SIZE> inputBuffer;
@@ -57,6 +95,16 @@ struct SpringReverb : Module {
 	dsp::VuMeter2 lightFilter;
 	dsp::ClockDivider lightRefreshClock;
 
+	// level and HPF maps are evaluated at control rate and ramped per sample
+	ControlRate<NUM_PARAMS> controlRate;
+	ControlRateValue<float> levelGain[2];
+	ControlRateValue<float> dryCutoffFreq;
+
+	// length of the IR (at 48kHz), i.e. how long the wet tail rings after the input goes silent
+	size_t kernelLen = 0;
+	float lastWet = 0.f;
+	IdleDetector idleDetector;
+
 	const float brightnessIntervals[8] = {17.f, 14.f, 12.f, 9.f, 6.f, 0.f, -6.f, -12.f};
 
 	SpringReverb() {
@@ -66,18 +114,17 @@ struct SpringReverb : Module {
 		configParam(LEVEL2_PARAM, 0.0, 1.0, 0.0, "In 2 level", "%", 0, 100);
 		configParam(HPF_PARAM, 0.0, 1.0, 0.5, "High pass filter cutoff");
 
-		initIR();
-
-		convolver = new dsp::RealTimeConvolver(BLOCK_SIZE);
-
-		const float* kernel = (const float*) ir.data();
-		size_t kernelLen = ir.size() / sizeof(float);
-		convolver->setKernel(kernel, kernelLen);
+		std::shared_ptr<const KernelFfts> kernel = SharedTable<KernelFfts>::get("SpringReverb IR", 0.f, loadKernelFfts);
+		convolver = new SharedKernelConvolver(BLOCK_SIZE, kernel);
+		kernelLen = kernel->length;
 
 		vuFilter.mode = dsp::VuMeter2::PEAK;
 		lightFilter.mode = dsp::VuMeter2::PEAK;
 
 		lightRefreshClock.setDivision(32);
+
+		controlRate.setDivision(16);
+		dryCutoffFreq.interpolation = ControlRateValue<float>::EXPONENTIAL;
 	}
 
 	~SpringReverb() {
@@ -99,12 +146,47 @@ struct SpringReverb : Module {
 		float in2 = inputs[IN2_INPUT].getVoltageSum();
 		const float levelScale = 0.030;
 		const float levelBase = 25.0;
-		float level1 = levelScale * dsp::exponentialBipolar(levelBase, params[LEVEL1_PARAM].getValue()) * inputs[CV1_INPUT].getNormalVoltage(10.0) / 10.0;
-		float level2 = levelScale * dsp::exponentialBipolar(levelBase, params[LEVEL2_PARAM].getValue()) * inputs[CV2_INPUT].getNormalVoltage(10.0) / 10.0;
+
+		if (controlRate.process()) {
+			const int samples = controlRate.getDivision();
+			for (int i = 0; i < 2; i++) {
+				const float level = params[LEVEL1_PARAM + i].getValue();
+				if (controlRate.changed(LEVEL1_PARAM + i, level)) {
+					levelGain[i].setTarget(levelScale * dsp::exponentialBipolar(levelBase, level), samples);
+				}
+			}
+			const float hpf = params[HPF_PARAM].getValue();
+			if (controlRate.changed(HPF_PARAM, hpf)) {
+				dryCutoffFreq.setTarget(200.0 * exp2_fast(4.321928f * hpf), samples); 	// 20^x
+			}
+		}
+
+		float level1 = levelGain[0].process() * inputs[CV1_INPUT].getNormalVoltage(10.0) / 10.0;
+		float level2 = levelGain[1].process() * inputs[CV2_INPUT].getNormalVoltage(10.0) / 10.0;
 		float dry = in1 * level1 + in2 * level2;
+		float dryCutoff = dryCutoffFreq.process() * args.sampleTime;
+
+		// once the input has been silent for longer than the IR plus the resampling/block latency, the tail has
+		// been flushed and the convolver can be skipped until the input is non-zero again
+		const int tailSamples = (kernelLen + 2 * BLOCK_SIZE) * args.sampleRate / 48000;
+		const bool active = !IdleDetector::isSilent(dry) || !IdleDetector::isSilent(lastWet);
+		if (idleDetector.process(active, tailSamples)) {
+			float balance = clamp(params[WET_PARAM].getValue() + inputs[MIX_CV_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
+			outputs[WET_OUTPUT].setVoltage(0.f);
+			outputs[MIX_OUTPUT].setVoltage(clamp(crossfade(in1, 0.f, balance), -10.0f, 10.0f));
+
+			if (idleDetector.enteredIdle()) {
+				vuFilter.v = 0.f;
+				lightFilter.v = 0.f;
+				for (int i = 0; i < 7; i++) {
+					lights[VU1_LIGHTS + i].setBrightness(0.f);
+				}
+				lights[PEAK_LIGHT].value = 0.f;
+			}
+			return;
+		}
 
 		// HPF on dry
-		float dryCutoff = 200.0 * std::pow(20.0, params[HPF_PARAM].getValue()) * args.sampleTime;
 		dryFilter.setCutoff(dryCutoff);
 		dryFilter.process(dry);
 
@@ -146,6 +228,7 @@ struct SpringReverb : Module {
 			return;
 
 		float wet = outputBuffer.shift().samples[0];
+		lastWet = wet;
 		float balance = clamp(params[WET_PARAM].getValue() + inputs[MIX_CV_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
 		float mix = crossfade(in1, wet, balance);
 
@@ -208,4 +291,4 @@ struct SpringReverbWidget : ModuleWidget {
 };
 
 
-Model* modelSpringReverb = createModel<SpringReverb, SpringReverbWidget>("SpringReverb");
+Model* modelSpringReverb = createModelWithTelemetry<SpringReverb, SpringReverbWidget>("SpringReverb");
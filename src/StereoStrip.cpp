@@ -1,4 +1,5 @@
 #include "plugin.hpp"
+#include "ChowDSP.hpp"
 
 using simd::float_4;
 
@@ -212,24 +213,30 @@ struct StereoStrip : Module {
 
 	PanningLaw panningLaw = LINEAR_6dB;
 
-	AeEqualizer<float_4> eqLow[4][2];
-	AeEqualizer<float_4> eqMid[4][2];
-	AeEqualizer<float_4> eqHigh[4][2];
+	// the EQ chain is the same for every voice, so each section runs as one bank of 16 voices per side
+	enum EQSection {
+		EQ_LOW,
+		EQ_MID,
+		EQ_HIGH,
+		EQ_HIGHPASS,
+		EQ_HIGHSHELF,
+		NUM_EQ_SECTIONS
+	};
+	using EQBank = chowdsp::IIRFilterBank<3, 16>;
+	EQBank eq[NUM_EQ_SECTIONS][2];
 
 	bool applyHighpass = true;
-	AeFilter<float_4> highpass[4][2];
 	bool applyHighshelf = true;
-	AeEqualizer<float_4> highshelf[4][2];
 	bool applySoftClipping = true;
 
-	float lastLowGain = -INFINITY;
-	float lastMidGain = -INFINITY;
-	float lastHighGain = -INFINITY;
-
 	// for processing mutes
 	dsp::SlewLimiter clickFilter;
 
-	dsp::ClockDivider sliderUpdate;
+	// EQ sliders and level are polled at control rate, and only the ones that moved are recalculated
+	ControlRate<PARAMS_LEN> controlRate;
+	ControlRateValue<float> levelGain;
+
+	BlockProcessor<INPUTS_LEN, OUTPUTS_LEN> block;
 
 	StereoStrip() {
 		config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
@@ -263,18 +270,30 @@ struct StereoStrip : Module {
 		clickFilter.fall = 50.f; // Hz
 
 		// only poll EQ sliders every 16 samples
-		sliderUpdate.setDivision(16);
+		controlRate.setDivision(16);
+		levelGain.interpolation = ControlRateValue<float>::EXPONENTIAL;
 	}
 
 	void onSampleRateChange() override {
 		bool forceUpdate = true;
 		updateEQsIfChanged(forceUpdate);
 
+		AeFilter<float> highpass;
+		highpass.setCutoff(25.0f, 0.8f, AeFilterType::AeHIGHPASS);
+		setEQCoefficients(EQ_HIGHPASS, highpass);
+
+		AeEqualizer<float> highshelf;
+		highshelf.setParams(12000.0f, 0.8f, -5.0f, AeEQType::AeHIGHSHELVE);
+		setEQCoefficients(EQ_HIGHSHELF, highshelf);
+	}
+
+	// copies the coefficients of an AeFilter or AeEqualizer design to both sides of an EQ section
+	template <typename TDesign>
+	void setEQCoefficients(EQSection section, const TDesign& design) {
+		const float b[3] = {design.b0, design.b1, design.b2};
+		const float a[3] = {1.f, design.a1, design.a2};
 		for (int side = 0; side < 2; ++side) {
-			for (int c = 0; c < 16; c += 4) {
-				highpass[side][c / 4].setCutoff(25.0f, 0.8f, AeFilterType::AeHIGHPASS);
-				highshelf[side][c / 4].setParams(12000.0f, 0.8f, -5.0f, AeEQType::AeHIGHSHELVE);
-			}
+			eq[section][side].setCoefficients(b, a);
 		}
 	}
 
@@ -283,110 +302,165 @@ struct StereoStrip : Module {
 		float midGain = params[MID_PARAM].getValue();
 		float lowGain = params[LOW_PARAM].getValue();
 
+		if (forceUpdate) {
+			controlRate.invalidate();
+		}
+
 		// only calculate coefficients when neccessary
-		if (highGain != lastHighGain || forceUpdate) {
-			for (int c = 0; c < 16; c += 4) {
-				for (int side = 0; side < 2; ++side) {
-					eqHigh[c / 4][side].setParams(2000.0f, 0.4f, highGain, AeEQType::AeHIGHSHELVE);
-				}
-			}
-			lastHighGain = highGain;
+		AeEqualizer<float> design;
+		if (controlRate.changed(HIGH_PARAM, highGain)) {
+			design.setParams(2000.0f, 0.4f, highGain, AeEQType::AeHIGHSHELVE);
+			setEQCoefficients(EQ_HIGH, design);
 		}
 
-		if (midGain != lastMidGain || forceUpdate) {
-			for (int c = 0; c < 16; c += 4) {
-				for (int side = 0; side < 2; ++side) {
-					eqMid[c / 4][side].setParams(1200.0f, 0.52f, midGain, AeEQType::AePEAKINGEQ);
-				}
-			}
-			lastMidGain = midGain;
+		if (controlRate.changed(MID_PARAM, midGain)) {
+			design.setParams(1200.0f, 0.52f, midGain, AeEQType::AePEAKINGEQ);
+			setEQCoefficients(EQ_MID, design);
 		}
 
-		if (lowGain != lastLowGain || forceUpdate) {
-			for (int c = 0; c < 16; c += 4) {
-				for (int side = 0; side < 2; ++side) {
-					eqLow[c / 4][side].setParams(125.0f, 0.45f, lowGain, AeEQType::AeLOWSHELVE);
-				}
+		if (controlRate.changed(LOW_PARAM, lowGain)) {
+			design.setParams(125.0f, 0.45f, lowGain, AeEQType::AeLOWSHELVE);
+			setEQCoefficients(EQ_LOW, design);
+		}
+	}
+
+	// runs frames of both sides' voltages ([side][frame][channel]) through the EQ chain, in place
+	void processEQ(float (*x)[decltype(block)::MAX_BLOCK_SIZE][16], int frameStart, int frameEnd, int channels) {
+		if (frameEnd <= frameStart) {
+			return;
+		}
+		// voltages are gathered 4 channels at a time, so filtering whole groups of 4 costs nothing extra
+		const int lanes = (channels + 3) & ~3;
+		for (int side = 0; side < 2; ++side) {
+			EQBank* sections[NUM_EQ_SECTIONS];
+			int numSections = 0;
+			sections[numSections++] = &eq[EQ_LOW][side];
+			sections[numSections++] = &eq[EQ_MID][side];
+			sections[numSections++] = &eq[EQ_HIGH][side];
+			if (applyHighpass) {
+				sections[numSections++] = &eq[EQ_HIGHPASS][side];
 			}
-			lastLowGain = lowGain;
+			if (applyHighshelf) {
+				sections[numSections++] = &eq[EQ_HIGHSHELF][side];
+			}
+			EQBank::processCascade(sections, numSections, x[side][frameStart], frameEnd - frameStart, lanes);
 		}
 	}
 
 	void process(const ProcessArgs& args) override {
+		block.process(this, args);
+	}
 
-		float_4 out[4][2] = {}, in[4][2] = {};
+	void processBlock(const ProcessArgs& args, const int frames) {
 
-		const int numPolyphonyEngines = std::max(inputs[LEFT_INPUT].getChannels(), inputs[RIGHT_INPUT].getChannels());
+		float_4 out[4][2] = {};
+		// gain before the per-voice VCA and panning, and the voltages of each side (filtered in place by processEQ())
+		float preVCAGains[decltype(block)::MAX_BLOCK_SIZE];
+		float voltages[2][decltype(block)::MAX_BLOCK_SIZE][16];
 
-		// slew mute to avoid clicks
-		const float muteGain = clickFilter.process(args.sampleTime, params[MUTE_PARAM].getValue() != MUTE_ON);
+		const int numPolyphonyEngines = std::max(block.getChannels(LEFT_INPUT), block.getChannels(RIGHT_INPUT));
+		const bool inputIsConnected = block.isConnected(LEFT_INPUT) || block.isConnected(RIGHT_INPUT);
 
-		if (inputs[LEFT_INPUT].isConnected() || inputs[RIGHT_INPUT].isConnected()) {
+		// switches and knobs (other than the EQ sliders and level) are read once per block
+		const bool muteTarget = params[MUTE_PARAM].getValue() != MUTE_ON;
+		const float switchGains = (params[IN_BOOST_PARAM].getValue() ? 2.0f : 1.0f) * (params[OUT_CUT_PARAM].getValue() ? 0.5f : 1.0f);
+		const float panParam = params[PAN_PARAM].getValue();
+		const float panCVParam = params[PAN_CV_PARAM].getValue();
 
-			const float switchGains = (params[IN_BOOST_PARAM].getValue() ? 2.0f : 1.0f) * (params[OUT_CUT_PARAM].getValue() ? 0.5f : 1.0f);
-			const float preVCAGain = switchGains * muteGain * std::pow(10, params[LEVEL_PARAM].getValue() / 20.0f);
+		// EQ coefficients change at control rate ticks, so the chain is run up to each tick before updating them
+		int eqFrameStart = 0;
+		for (int frame = 0; frame < frames; ++frame) {
 
-			if (sliderUpdate.process()) {
+			if (controlRate.process()) {
+				if (inputIsConnected) {
+					processEQ(voltages, eqFrameStart, frame, numPolyphonyEngines);
+					eqFrameStart = frame;
+				}
 				updateEQsIfChanged();
-			}
 
-			for (int c = 0; c < numPolyphonyEngines; c += 4) {
+				const float level = params[LEVEL_PARAM].getValue();
+				if (controlRate.changed(LEVEL_PARAM, level)) {
+					levelGain.setTarget(dbToGain_fast(level), controlRate.getDivision());
+				}
+			}
 
-				const float_4 postVCAGain = preVCAGain * clamp(inputs[LEVEL_INPUT].getNormalPolyVoltageSimd<float_4>(10.f, c) / 10.f, 0.f, 1.f);
+			// slew mute to avoid clicks
+			const float muteGain = clickFilter.process(args.sampleTime, muteTarget);
 
-				const float_4 panCV = clamp(params[PAN_CV_PARAM].getValue() * inputs[PAN_INPUT].getPolyVoltageSimd<float_4>(c) / 5.f, -1.f, +1.f);
-				const float_4 pan = clamp(params[PAN_PARAM].getValue() + panCV, -1.f, +1.f);
+			if (inputIsConnected) {
+				preVCAGains[frame] = switchGains * muteGain * levelGain.process();
 
-				// https://www.desmos.com/calculator/b0lisclikw
-				float_4 gainForSide[2] = {};
-				switch (panningLaw) {
-					case LINEAR_6dB: {
-						gainForSide[0] = postVCAGain * (1.f - pan);
-						gainForSide[1] = postVCAGain * (1.f + pan);
-						break;
-					}
-					case EQUAL_POWER: {
-						gainForSide[0] = postVCAGain * simd::sqrt(1.f - pan);
-						gainForSide[1] = postVCAGain * simd::sqrt(1.f + pan);
-						break;
-					}
-					case LINEAR_CLIPPED: {
-						gainForSide[0] = simd::ifelse(pan < 0, postVCAGain, postVCAGain * (1.f - pan));
-						gainForSide[1] = simd::ifelse(pan > 0, postVCAGain, postVCAGain * (1.f + pan));
-						break;
-					}
+				for (int c = 0; c < numPolyphonyEngines; c += 4) {
+					float_4 inLeft = block.getPolyVoltageSimd<float_4>(LEFT_INPUT, frame, c);
+					inLeft.store(&voltages[LEFT][frame][c]);
+					block.getNormalPolyVoltageSimd<float_4>(RIGHT_INPUT, frame, inLeft, c).store(&voltages[RIGHT][frame][c]);
 				}
+			}
+		}
+		if (inputIsConnected) {
+			processEQ(voltages, eqFrameStart, frames, numPolyphonyEngines);
+		}
 
-				in[c / 4][LEFT] = inputs[LEFT_INPUT].getPolyVoltageSimd<float_4>(c);
-				in[c / 4][RIGHT] = inputs[RIGHT_INPUT].getNormalPolyVoltageSimd<float_4>(in[c / 4][LEFT], c);
+		for (int frame = 0; frame < frames; ++frame) {
+
+			if (inputIsConnected) {
+
+				const float preVCAGain = preVCAGains[frame];
+
+				for (int c = 0; c < numPolyphonyEngines; c += 4) {
+
+					const float_4 postVCAGain = preVCAGain * clamp(block.getNormalPolyVoltageSimd<float_4>(LEVEL_INPUT, frame, 10.f, c) / 10.f, 0.f, 1.f);
+
+					const float_4 panCV = clamp(panCVParam * block.getPolyVoltageSimd<float_4>(PAN_INPUT, frame, c) / 5.f, -1.f, +1.f);
+					const float_4 pan = clamp(panParam + panCV, -1.f, +1.f);
+
+					// https://www.desmos.com/calculator/b0lisclikw
+					float_4 gainForSide[2] = {};
+					switch (panningLaw) {
+						case LINEAR_6dB: {
+							gainForSide[0] = postVCAGain * (1.f - pan);
+							gainForSide[1] = postVCAGain * (1.f + pan);
+							break;
+						}
+						case EQUAL_POWER: {
+							gainForSide[0] = postVCAGain * simd::sqrt(1.f - pan);
+							gainForSide[1] = postVCAGain * simd::sqrt(1.f + pan);
+							break;
+						}
+						case LINEAR_CLIPPED: {
+							gainForSide[0] = simd::ifelse(pan < 0, postVCAGain, postVCAGain * (1.f - pan));
+							gainForSide[1] = simd::ifelse(pan > 0, postVCAGain, postVCAGain * (1.f + pan));
+							break;
+						}
+					}
 
-				for (int side = 0; side < 2; ++side) {
+					for (int side = 0; side < 2; ++side) {
 
-					float_4 outForSide = in[c / 4][side];
+						float_4 outForSide = float_4::load(&voltages[side][frame][c]) * gainForSide[side];
 
-					outForSide = eqLow[c / 4][side].process(outForSide);
-					outForSide = eqMid[c / 4][side].process(outForSide);
-					outForSide = eqHigh[c / 4][side].process(outForSide);
-					outForSide = applyHighpass ? highpass[c / 4][side].process(outForSide) : outForSide;
-					outForSide = applyHighshelf ? highshelf[c / 4][side].process(outForSide) : outForSide;
-					outForSide = outForSide * gainForSide[side];
+						// soft clipping: the Saturator used elsewhere expects values in range [-1, +1] roughly, so rescale before
+						// and after (assuming input signals are 10Vpp, clipping will kick in above 12Vpp with the present values)
+						if (applySoftClipping) {
+							outForSide = Saturator<float_4>::process(outForSide / 6.f) * 6.f;
+						}
 
-					// soft clipping: the Saturator used elsewhere expects values in range [-1, +1] roughly, so rescale before
-					// and after (assuming input signals are 10Vpp, clipping will kick in above 12Vpp with the present values)
-					if (applySoftClipping) {
-						outForSide = Saturator<float_4>::process(outForSide / 6.f) * 6.f;
+						out[c / 4][side] = outForSide;
 					}
-
-					out[c / 4][side] = outForSide;
 				}
 			}
+
+			for (int c = 0; c < numPolyphonyEngines; c += 4) {
+				block.setVoltageSimd(LEFT_OUTPUT, frame, out[c / 4][LEFT], c);
+				block.setVoltageSimd(RIGHT_OUTPUT, frame, out[c / 4][RIGHT], c);
+			}
 		}
 
+		// lights follow the last frame of the block
 		if (numPolyphonyEngines <= 1) {
 			lights[LEFT_LIGHT + 0].setBrightness(0.f);
 			lights[RIGHT_LIGHT + 0].setBrightness(0.f);
-			lights[LEFT_LIGHT + 1].setBrightnessSmooth(std::abs(out[0][LEFT][0]), args.sampleTime);
-			lights[RIGHT_LIGHT + 1].setBrightnessSmooth(std::abs(out[0][RIGHT][0]), args.sampleTime);
+			lights[LEFT_LIGHT + 1].setBrightnessSmooth(std::abs(out[0][LEFT][0]), args.sampleTime * frames);
+			lights[RIGHT_LIGHT + 1].setBrightnessSmooth(std::abs(out[0][RIGHT][0]), args.sampleTime * frames);
 			lights[LEFT_LIGHT + 2].setBrightness(0.f);
 			lights[RIGHT_LIGHT + 2].setBrightness(0.f);
 		}
@@ -399,11 +473,6 @@ struct StereoStrip : Module {
 			lights[RIGHT_LIGHT + 2].setBrightness(1.f);
 		}
 
-		for (int c = 0; c < numPolyphonyEngines; c += 4) {
-			outputs[LEFT_OUTPUT].setVoltageSimd(out[c / 4][LEFT], c);
-			outputs[RIGHT_OUTPUT].setVoltageSimd(out[c / 4][RIGHT], c);
-		}
-
 		outputs[LEFT_OUTPUT].setChannels(numPolyphonyEngines);
 		outputs[RIGHT_OUTPUT].setChannels(numPolyphonyEngines);
 
@@ -415,6 +484,7 @@ struct StereoStrip : Module {
 		json_object_set_new(rootJ, "applyHighshelf", json_boolean(applyHighshelf));
 		json_object_set_new(rootJ, "panningLaw", json_integer(panningLaw));
 		json_object_set_new(rootJ, "applySoftClipping", json_boolean(applySoftClipping));
+		json_object_set_new(rootJ, "blockSize", json_integer(block.getBlockSize()));
 
 		return rootJ;
 	}
@@ -439,6 +509,11 @@ struct StereoStrip : Module {
 		if (softClippingJ) {
 			applySoftClipping = json_boolean_value(softClippingJ);
 		}
+
+		json_t* blockSizeJ = json_object_get(rootJ, "blockSize");
+		if (blockSizeJ) {
+			block.setBlockSize(json_integer_value(blockSizeJ));
+		}
 	}
 };
 
@@ -549,8 +624,9 @@ struct StereoStripWidget : ModuleWidget {
 		menu->addChild(createBoolPtrMenuItem("Apply soft-clipping", "", &module->applySoftClipping));
 		menu->addChild(new MenuSeparator());
 		menu->addChild(createIndexPtrSubmenuItem("Panning law", {"Linear (+6dB)", "Equal power (+3dB)", "Linear clipped"}, &module->panningLaw));
+		menu->addChild(createBlockSizeMenuItem(&module->block));
 	}
 };
 
 
-Model* modelChannelStrip = createModel<StereoStrip, StereoStripWidget>("StereoStrip");
\ No newline at end of file
+Model* modelChannelStrip = createModelWithTelemetry<StereoStrip, StereoStripWidget>("StereoStrip");
\ No newline at end of file
@@ -91,4 +91,4 @@ struct VoltioWidget : ModuleWidget {
 };
 
 
-Model* modelVoltio = createModel<Voltio, VoltioWidget>("Voltio");
\ No newline at end of file
+Model* modelVoltio = createModelWithTelemetry<Voltio, VoltioWidget>("Voltio");
\ No newline at end of file
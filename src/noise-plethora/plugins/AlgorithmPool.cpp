@@ -0,0 +1,180 @@
+#include "AlgorithmPool.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(ARCH_MAC)
+#include <dispatch/dispatch.h>
+#elif defined(ARCH_WIN)
+#include <climits>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <semaphore.h>
+#endif
+
+namespace {
+
+// counting semaphore: post() never blocks, locks or allocates (unlike notifying a condition variable without its
+// mutex, it can't be missed by a thread about to wait), so the audio thread can wake the worker with it
+class Semaphore {
+public:
+#if defined(ARCH_MAC)
+	// unnamed POSIX semaphores aren't implemented on macOS
+	Semaphore() : semaphore(dispatch_semaphore_create(0)) {}
+	~Semaphore() {
+		dispatch_release(semaphore);
+	}
+	void post() {
+		dispatch_semaphore_signal(semaphore);
+	}
+	void wait() {
+		dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+	}
+private:
+	dispatch_semaphore_t semaphore;
+#elif defined(ARCH_WIN)
+	// winpthreads' sem_post takes a mutex, the native semaphore doesn't
+	Semaphore() : semaphore(CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr)) {}
+	~Semaphore() {
+		CloseHandle(semaphore);
+	}
+	void post() {
+		ReleaseSemaphore(semaphore, 1, nullptr);
+	}
+	void wait() {
+		WaitForSingleObject(semaphore, INFINITE);
+	}
+private:
+	HANDLE semaphore;
+#else
+	Semaphore() {
+		sem_init(&semaphore, 0, 0);
+	}
+	~Semaphore() {
+		sem_destroy(&semaphore);
+	}
+	void post() {
+		sem_post(&semaphore);
+	}
+	void wait() {
+		// a signal handler can interrupt the wait
+		while (sem_wait(&semaphore) != 0) {}
+	}
+private:
+	sem_t semaphore;
+#endif
+};
+
+} // namespace
+
+/** The thread that builds and frees algorithms for every AlgorithmPool. It blocks on a semaphore, and each wake()
+ gets it to service all the pools once: with many Noise Plethoras in a patch there is still only one thread, and it
+ costs nothing while no pool needs it. */
+class AlgorithmPool::Worker {
+public:
+	static Worker& get() {
+		static Worker worker;
+		return worker;
+	}
+
+	void attach(AlgorithmPool* pool) {
+		std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex);
+		bool first;
+		{
+			std::lock_guard<std::mutex> lock(poolsMutex);
+			pools.push_back(pool);
+			first = pools.size() == 1;
+		}
+		if (first) {
+			running = true;
+			thread = std::thread([this]() {
+				run();
+			});
+		}
+	}
+
+	// once this returns the worker no longer touches the pool
+	void detach(AlgorithmPool* pool) {
+		std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex);
+		bool last;
+		{
+			// waits for the worker to finish servicing the pools
+			std::lock_guard<std::mutex> lock(poolsMutex);
+			pools.erase(std::remove(pools.begin(), pools.end(), pool), pools.end());
+			last = pools.empty();
+		}
+		if (last) {
+			running = false;
+			semaphore.post();
+			thread.join();
+		}
+	}
+
+	void wake() {
+		// only the first wake() since the worker last woke up posts, later ones are covered by that pass
+		if (!pending.exchange(true)) {
+			semaphore.post();
+		}
+	}
+
+private:
+	void run() {
+		// the worker draws from its own random generator, e.g. for the random walks' initial conditions
+		rack::random::init();
+
+		while (true) {
+			semaphore.wait();
+			// cleared before servicing, so a wake() from here on posts again and gets another pass
+			pending = false;
+			if (!running) {
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(poolsMutex);
+			for (AlgorithmPool* pool : pools) {
+				pool->service();
+			}
+		}
+	}
+
+	// serialises starting and stopping the thread
+	std::mutex lifecycleMutex;
+	std::mutex poolsMutex;
+	std::vector<AlgorithmPool*> pools;
+
+	std::thread thread;
+	Semaphore semaphore;
+	std::atomic<bool> pending{false};
+	std::atomic<bool> running{false};
+};
+
+AlgorithmPool::AlgorithmPool() {
+	Worker::get().attach(this);
+}
+
+AlgorithmPool::~AlgorithmPool() {
+	Worker::get().detach(this);
+
+	for (Slot& slot : slots) {
+		for (int engine = 0; engine < NUM_GRAPH_ENGINES; ++engine) {
+			for (int i = 0; i < MAX_SPARES; ++i) {
+				delete slot.spares[engine][i].load();
+			}
+		}
+	}
+	while (!retired.empty()) {
+		delete retired.shift();
+	}
+}
+
+void AlgorithmPool::wake() {
+	Worker::get().wake();
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+
+#include "NoisePlethoraPlugin.hpp"
+
+/** Ready-to-play algorithm instances, so that a program change on the audio thread never allocates, frees or locks.
+
+ Constructing an algorithm means a heap allocation of a large object (some hold reverb or grain buffers) and its
+ init(). The pool does that on a worker thread, or on the calling thread in prepare(), and keeps the results as
+ spares. The audio thread take()s a spare with one atomic exchange, and retire()s the instance it replaces through a
+ lock-free queue, to be deleted on the worker thread.
+
+ If no spare is ready, take() returns nullptr and asks the worker to build one, and the module carries on with the
+ algorithm it has until a later take() succeeds. With preloading on, the worker keeps spares of every algorithm
+ for the chosen engine, and refills each one as soon as it is taken, so take() only misses if the same algorithm
+ is taken again within the few milliseconds that refilling takes.
+
+ In polyphonic mode every channel of A and B plays its own instance, so an algorithm can have up to MAX_SPARES
+ spares, prepared for the patched channels all at once. Channels patched later miss in take(), and the worker then
+ builds as many spares as there were misses. trim() frees the ones left over once they are no longer needed.
+
+ There is one worker for all the pools of the plugin (see AlgorithmPool.cpp), started with the first pool and
+ stopped with the last. It sleeps until a pool wakes it. */
+class AlgorithmPool {
+
+public:
+	// both sections may play the same algorithm, on every channel
+	static const int MAX_SPARES = 2 * rack::engine::PORT_MAX_CHANNELS;
+	// spares of each algorithm kept by preloading, enough for A and B in mono
+	static const int PRELOAD_SPARES = 2;
+
+	AlgorithmPool();
+	~AlgorithmPool();
+
+	AlgorithmPool(const AlgorithmPool&) = delete;
+	AlgorithmPool& operator=(const AlgorithmPool&) = delete;
+
+	/** Any thread but the audio thread: builds spares of the algorithm now, until numSpares are ready */
+	void prepare(AlgorithmId id, GraphEngine engine, int numSpares = 1) {
+		if (id == ALGORITHM_NONE) {
+			return;
+		}
+		std::atomic<NoisePlethoraPlugin*>* spares = slots[id].spares[engine];
+		int numReady = 0;
+		for (int i = 0; i < MAX_SPARES; ++i) {
+			numReady += spares[i].load() != nullptr;
+		}
+		for (; numReady < numSpares && numReady < MAX_SPARES; ++numReady) {
+			fill(id, engine);
+		}
+	}
+
+	/** Audio thread: hands over a spare, initialised and not yet played. If there is none, returns nullptr and asks
+	 the worker for one */
+	std::unique_ptr<NoisePlethoraPlugin> take(AlgorithmId id, GraphEngine engine) {
+		if (id == ALGORITHM_NONE) {
+			return nullptr;
+		}
+		Slot& slot = slots[id];
+		for (int i = 0; i < MAX_SPARES; ++i) {
+			// the load skips empty spares without writing to them
+			NoisePlethoraPlugin* instance = slot.spares[engine][i].load() ? slot.spares[engine][i].exchange(nullptr) : nullptr;
+			if (instance) {
+				if (preloadAll) {
+					wake();
+				}
+				return std::unique_ptr<NoisePlethoraPlugin>(instance);
+			}
+		}
+		++slot.requested[engine];
+		wake();
+		return nullptr;
+	}
+
+	/** Audio thread: whether retire() will accept an instance. Only the worker frees room, so this stays true until
+	 the next retire() */
+	bool canRetire() const {
+		return !retired.full();
+	}
+
+	/** Audio thread: passes an instance that is no longer played to the worker, to be deleted there, and empties
+	 `instance`. If the queue is full (the worker can't keep up), returns false and leaves the instance with the caller,
+	 who should hold on to it and try again later: it is never freed on the audio thread. */
+	bool retire(std::unique_ptr<NoisePlethoraPlugin>& instance) {
+		if (!instance) {
+			return true;
+		}
+		if (retired.full()) {
+			return false;
+		}
+		retired.push(instance.release());
+		wake();
+		return true;
+	}
+
+	/** Any thread but the audio thread: frees the spares of the algorithm beyond the first numSpares */
+	void trim(AlgorithmId id, GraphEngine engine, int numSpares) {
+		if (id == ALGORITHM_NONE) {
+			return;
+		}
+		int numKept = 0;
+		for (int i = 0; i < MAX_SPARES; ++i) {
+			std::atomic<NoisePlethoraPlugin*>& spare = slots[id].spares[engine][i];
+			if (!spare.load()) {
+				continue;
+			}
+			if (numKept < numSpares) {
+				++numKept;
+				continue;
+			}
+			// take() may have got there first, in which case this deletes nullptr
+			delete spare.exchange(nullptr);
+		}
+	}
+
+	/** Keep spares of every algorithm built with engine, or only build the ones asked for (the default) */
+	void setPreload(bool preload, GraphEngine engine) {
+		preloadEngine = engine;
+		preloadAll = preload;
+		wake();
+	}
+
+private:
+	class Worker;
+
+	struct Slot {
+		std::atomic<NoisePlethoraPlugin*> spares[NUM_GRAPH_ENGINES][MAX_SPARES] = {};
+		// how many take()s found no spare since the worker last looked, i.e. how many voices are waiting for one
+		std::atomic<int> requested[NUM_GRAPH_ENGINES] = {};
+	};
+
+	// constructs and initialises an instance, and stores it in a free spare if there is one
+	void fill(AlgorithmId id, GraphEngine engine) {
+		std::unique_ptr<NoisePlethoraPlugin> instance = createAlgorithm(id, engine);
+		if (!instance) {
+			return;
+		}
+		instance->init();
+
+		for (int i = 0; i < MAX_SPARES; ++i) {
+			NoisePlethoraPlugin* expected = nullptr;
+			if (slots[id].spares[engine][i].compare_exchange_strong(expected, instance.get())) {
+				instance.release();
+				return;
+			}
+		}
+	}
+
+	// worker thread: frees the retired instances, and builds the spares that were asked for or are preloaded
+	void service() {
+		while (!retired.empty()) {
+			delete retired.shift();
+		}
+
+		for (int id = 0; id < NUM_ALGORITHMS; ++id) {
+			Slot& slot = slots[id];
+			for (int engine = 0; engine < NUM_GRAPH_ENGINES; ++engine) {
+				const bool preloaded = preloadAll && engine == preloadEngine;
+				// a voice that is still waiting asks again at its next update, so this is a target rather than a
+				// count of spares to add
+				const int numSpares = std::max(slot.requested[engine].exchange(0), preloaded ? PRELOAD_SPARES : 0);
+				if (numSpares > 0) {
+					prepare((AlgorithmId) id, (GraphEngine) engine, numSpares);
+				}
+			}
+		}
+	}
+
+	// wakes the worker, which then services every pool. Doesn't lock or allocate, so safe on the audio thread
+	static void wake();
+
+	Slot slots[NUM_ALGORITHMS];
+
+	std::atomic<bool> preloadAll{false};
+	std::atomic<GraphEngine> preloadEngine{HARDWARE_INT16};
+
+	// instances taken out of play, single producer (audio thread) and single consumer (worker). Holds a few rounds of
+	// every voice changing algorithm at once
+	rack::dsp::RingBuffer<NoisePlethoraPlugin*, 256> retired;
+};
@@ -1,24 +1,30 @@
 #include "Banks.hpp"
 #include "Banks_Def.hpp"
 
-const Bank::BankElem Bank::defaultElem = {"", 1.0};
+const Bank::BankElem Bank::defaultElem = {ALGORITHM_NONE, 1.0};
 
 Bank::Bank() {
 	programs.fill(defaultElem);
 }
 
-Bank::Bank(const BankElem& p1, const BankElem& p2, const BankElem& p3,
-           const BankElem& p4, const BankElem& p5, const BankElem& p6,
-           const BankElem& p7, const BankElem& p8, const BankElem& p9,
-           const BankElem& p10)
-	: programs{p1, p2, p3, p4, p5, p6, p7, p8, p9, p10}
-{ }
+Bank::Bank(std::initializer_list<BankElem> elems) {
+	programs.fill(defaultElem);
+	for (const BankElem& elem : elems) {
+		if (size < programsPerBank) {
+			programs[size++] = elem;
+		}
+	}
+}
 
-const std::string Bank::getProgramName(int i) {
+AlgorithmId Bank::getProgramId(int i) {
 	if (i >= 0 && i < programsPerBank) {
-		return programs[i].name;
+		return programs[i].id;
 	}
-	return "";
+	return ALGORITHM_NONE;
+}
+
+std::string Bank::getProgramName(int i) {
+	return getAlgorithmName(getProgramId(i));
 }
 
 float Bank::getProgramGain(int i) {
@@ -29,13 +35,6 @@ float Bank::getProgramGain(int i) {
 }
 
 int Bank::getSize() {
-	int size = 0;
-	for (auto it = programs.begin(); it != programs.end(); it++) {
-		if ((*it).name == "") {
-			break;
-		}
-		size++;
-	}
 	return size;
 }
 
@@ -89,18 +88,19 @@ int Bank::getSize() {
 //#include "P_Rwalk_WaveTwist.hpp"
 
 
-static const Bank bank1 BANKS_DEF_1; // Banks_Def.hpp
-static const Bank bank2 BANKS_DEF_2;
-static const Bank bank3 BANKS_DEF_3;
-//static const Bank bank4 BANKS_DEF_4;
-//static const Bank bank5 BANKS_DEF_5;
+#define BANK_ELEM(name, gain) {ALGORITHM_ ## name, gain},
+static const Bank bank1 {BANKS_DEF_1(BANK_ELEM)}; // Banks_Def.hpp
+static const Bank bank2 {BANKS_DEF_2(BANK_ELEM)};
+static const Bank bank3 {BANKS_DEF_3(BANK_ELEM)};
+//static const Bank bank4 {BANKS_DEF_4(BANK_ELEM)};
+//static const Bank bank5 {BANKS_DEF_5(BANK_ELEM)};
 static std::array<Bank, numBanks> banks { bank1, bank2, bank3 }; //, bank5 };
 
-// static const Bank bank6 BANKS_DEF_6;
-// static const Bank bank7 BANKS_DEF_7;
-// static const Bank bank8 BANKS_DEF_8;
-// static const Bank bank9 BANKS_DEF_9;
-// static const Bank bank10 BANKS_DEF_10;
+// static const Bank bank6 {BANKS_DEF_6(BANK_ELEM)};
+// static const Bank bank7 {BANKS_DEF_7(BANK_ELEM)};
+// static const Bank bank8 {BANKS_DEF_8(BANK_ELEM)};
+// static const Bank bank9 {BANKS_DEF_9(BANK_ELEM)};
+// static const Bank bank10 {BANKS_DEF_10(BANK_ELEM)};
 // static std::array<Bank, programsPerBank> banks { bank1, bank2, bank3, bank4, bank5, bank6, bank7, bank8, bank9, bank10 };
 
 Bank& getBankForIndex(int i) {
@@ -110,3 +110,76 @@ Bank& getBankForIndex(int i) {
 		i = (programsPerBank - 1);
 	return banks[i];
 }
+
+#define ALGORITHM_NAME(name, gain) #name,
+static const char* const algorithmNames[NUM_ALGORITHMS] = {
+	BANKS_DEF_1(ALGORITHM_NAME)
+	BANKS_DEF_2(ALGORITHM_NAME)
+	BANKS_DEF_3(ALGORITHM_NAME)
+};
+
+const char* getAlgorithmName(AlgorithmId id) {
+	return (id >= 0 && id < NUM_ALGORITHMS) ? algorithmNames[id] : "";
+}
+
+AlgorithmId findAlgorithm(const std::string& name) {
+	for (int id = 0; id < NUM_ALGORITHMS; ++id) {
+		if (name == algorithmNames[id]) {
+			return (AlgorithmId) id;
+		}
+	}
+	return ALGORITHM_NONE;
+}
+
+// bank and program of each algorithm, indexed by AlgorithmId
+static const std::array<Bank::Location, NUM_ALGORITHMS> locations = []() {
+	std::array<Bank::Location, NUM_ALGORITHMS> locations;
+	locations.fill({-1, -1});
+	for (int bank = 0; bank < numBanks; ++bank) {
+		for (int program = 0; program < banks[bank].getSize(); ++program) {
+			locations[banks[bank].getProgramId(program)] = {bank, program};
+		}
+	}
+	return locations;
+}();
+
+Bank::Location Bank::locate(AlgorithmId id) {
+	return (id >= 0 && id < NUM_ALGORITHMS) ? locations[id] : Location{-1, -1};
+}
+
+
+template <template <class> class TAlgorithm, class Engine>
+static NoisePlethoraPlugin* construct() {
+	return new TAlgorithm<Engine>();
+}
+
+// indexed by AlgorithmId and GraphEngine
+typedef NoisePlethoraPlugin* (*AlgorithmConstructor)();
+#define ALGORITHM_CONSTRUCTORS(name, gain) {construct<name, Int16Engine>, construct<name, FloatEngine>},
+static const AlgorithmConstructor algorithmConstructors[NUM_ALGORITHMS][NUM_GRAPH_ENGINES] = {
+	BANKS_DEF_1(ALGORITHM_CONSTRUCTORS)
+	BANKS_DEF_2(ALGORITHM_CONSTRUCTORS)
+	BANKS_DEF_3(ALGORITHM_CONSTRUCTORS)
+};
+
+std::unique_ptr<NoisePlethoraPlugin> createAlgorithm(AlgorithmId id, GraphEngine engine) {
+	if (id < 0 || id >= NUM_ALGORITHMS) {
+		return nullptr;
+	}
+	return std::unique_ptr<NoisePlethoraPlugin>(algorithmConstructors[id][engine]());
+}
+
+// indexed by AlgorithmId and GraphEngine, what one instance (e.g. one polyphonic voice) costs
+#define ALGORITHM_SIZES(name, gain) {sizeof(name<Int16Engine>), sizeof(name<FloatEngine>)},
+static const size_t algorithmSizes[NUM_ALGORITHMS][NUM_GRAPH_ENGINES] = {
+	BANKS_DEF_1(ALGORITHM_SIZES)
+	BANKS_DEF_2(ALGORITHM_SIZES)
+	BANKS_DEF_3(ALGORITHM_SIZES)
+};
+
+size_t getAlgorithmSize(AlgorithmId id, GraphEngine engine) {
+	if (id < 0 || id >= NUM_ALGORITHMS) {
+		return 0;
+	}
+	return algorithmSizes[id][engine];
+}
@@ -3,41 +3,66 @@
 #include <string>
 #include <memory>
 #include <array>
+#include <initializer_list>
+
+#include "Banks_Def.hpp"
 
 static const int programsPerBank = 10;
 static const int numBanks = 3;
 
+/** Every algorithm in the banks, in bank order. The audio thread only deals in these, algorithm names are only
+ used for display and in saved patches (see getAlgorithmName() and findAlgorithm()) */
+enum AlgorithmId {
+	ALGORITHM_NONE = -1,
+#define ALGORITHM_ID(name, gain) ALGORITHM_ ## name,
+	BANKS_DEF_1(ALGORITHM_ID)
+	BANKS_DEF_2(ALGORITHM_ID)
+	BANKS_DEF_3(ALGORITHM_ID)
+#undef ALGORITHM_ID
+	NUM_ALGORITHMS
+};
+
+/** The name an algorithm is saved under, "" for ALGORITHM_NONE */
+const char* getAlgorithmName(AlgorithmId id);
+/** The algorithm with the given name, or ALGORITHM_NONE */
+AlgorithmId findAlgorithm(const std::string& name);
+
 struct Bank {
 
 	struct BankElem {
 		BankElem() {};
 
-		BankElem(std::string n, float g = 1.0)
-			: name{n}
+		BankElem(AlgorithmId id, float g = 1.0)
+			: id{id}
 			, gain{g}
 		{}
 
-		std::string name = "";
+		AlgorithmId id = ALGORITHM_NONE;
 		float gain = 1.0;
 	};
 
 	static const BankElem defaultElem;
 
 	Bank();
-	Bank(const BankElem& p1, const BankElem& p2 = defaultElem,
-	     const BankElem& p3 = defaultElem, const BankElem& p4 = defaultElem,
-	     const BankElem& p5 = defaultElem, const BankElem& p6 = defaultElem,
-	     const BankElem& p7 = defaultElem, const BankElem& p8 = defaultElem,
-	     const BankElem& p9 = defaultElem, const BankElem& p10 = defaultElem);
+	Bank(std::initializer_list<BankElem> elems);
 
-	const std::string getProgramName(int i);
+	AlgorithmId getProgramId(int i);
+	std::string getProgramName(int i);
 	float getProgramGain(int i);
 
 	int getSize();
 
+	/** Where an algorithm is in the banks (-1 if it isn't), found with an array lookup */
+	struct Location {
+		int bank;
+		int program;
+	};
+	static Location locate(AlgorithmId id);
+
 private:
 
 	std::array<BankElem, programsPerBank> programs;
+	int size = 0;
 
 };
 
@@ -1,50 +1,49 @@
 #pragma once
 
-#define BANKS_DEF_1 { \
-		{ "radioOhNo", 1.0 }, \
-		{ "Rwalk_SineFMFlange", 1.0 }, \
-		{ "xModRingSqr", 1.0 }, \
-		{ "XModRingSine", 1.0 }, \
-		{ "CrossModRing", 1.0 }, \
-		{ "resonoise", 1.0 }, \
-		{ "grainGlitch", 1.0 }, \
-		{ "grainGlitchII", 1.0 }, \
-		{ "grainGlitchIII", 1.0 }, \
-		{ "basurilla", 1.0 } \
-	}
+// Each bank lists its algorithms as X(class, gain), where class is the plugin's class template (P_<class>.hpp). An
+// algorithm's AlgorithmId is ALGORITHM_<class>, numbered in bank order (see Banks.hpp)
 
-#define BANKS_DEF_2 { \
-		{ "clusterSaw", 1.0 }, \
-		{ "pwCluster", 1.0 }, \
-		{ "crCluster2", 1.0 }, \
-		{ "sineFMcluster", 1.0 }, \
-		{ "TriFMcluster", 1.0 }, \
-		{ "PrimeCluster", 0.8 }, \
-		{ "PrimeCnoise", 0.8 }, \
-		{ "FibonacciCluster", 1.0 }, \
-		{ "partialCluster", 1.0 }, \
-		{ "phasingCluster", 1.0 } \
-	}
+#define BANKS_DEF_1(X) \
+		X(radioOhNo, 1.0) \
+		X(Rwalk_SineFMFlange, 1.0) \
+		X(xModRingSqr, 1.0) \
+		X(XModRingSine, 1.0) \
+		X(CrossModRing, 1.0) \
+		X(resonoise, 1.0) \
+		X(grainGlitch, 1.0) \
+		X(grainGlitchII, 1.0) \
+		X(grainGlitchIII, 1.0) \
+		X(basurilla, 1.0)
 
-#define BANKS_DEF_3 { \
-		{ "BasuraTotal", 1.0 }, \
-		{ "Atari", 1.0 },  \
-		{ "WalkingFilomena", 1.0 }, \
-		{ "S_H", 1.0 }, \
-		{ "arrayOnTheRocks", 1.0 }, \
-		{ "existencelsPain", 1.0 }, \
-		{ "whoKnows", 1.0 }, \
-		{ "satanWorkout", 1.0 }, \
-		{ "Rwalk_BitCrushPW", 1.0 }, \
-		{ "Rwalk_LFree", 1.0 } \
-	}
+#define BANKS_DEF_2(X) \
+		X(clusterSaw, 1.0) \
+		X(pwCluster, 1.0) \
+		X(crCluster2, 1.0) \
+		X(sineFMcluster, 1.0) \
+		X(TriFMcluster, 1.0) \
+		X(PrimeCluster, 0.8) \
+		X(PrimeCnoise, 0.8) \
+		X(FibonacciCluster, 1.0) \
+		X(partialCluster, 1.0) \
+		X(phasingCluster, 1.0)
 
-#define BANKS_DEF_4 { \
-		{ "TestPlugin", 1.0 }, \
-		{ "WhiteNoise", 1.0 }, \
-		{ "TeensyAlt", 1.0 }  \
-	}
-#define BANKS_DEF_5
+#define BANKS_DEF_3(X) \
+		X(BasuraTotal, 1.0) \
+		X(Atari, 1.0) \
+		X(WalkingFilomena, 1.0) \
+		X(S_H, 1.0) \
+		X(arrayOnTheRocks, 1.0) \
+		X(existencelsPain, 1.0) \
+		X(whoKnows, 1.0) \
+		X(satanWorkout, 1.0) \
+		X(Rwalk_BitCrushPW, 1.0) \
+		X(Rwalk_LFree, 1.0)
+
+#define BANKS_DEF_4(X) \
+		X(TestPlugin, 1.0) \
+		X(WhiteNoise, 1.0) \
+		X(TeensyAlt, 1.0)
+#define BANKS_DEF_5(X)
 
 // #define BANKS_DEF_6
 // #define BANKS_DEF_7
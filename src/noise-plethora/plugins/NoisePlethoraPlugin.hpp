@@ -3,10 +3,113 @@
 #include <rack.hpp>
 #include <memory>
 #include <string> // string might not be allowed
-#include <functional>
-#include <map>
+#include <array>
+#include <algorithm>
 
+#include "Banks.hpp"
 #include "../teensy/TeensyAudioReplacements.hpp"
+#include "../teensy-float/FloatAudioReplacements.hpp"
+
+
+/** Which implementation of the Teensy audio library a plugin's graph is built from:
+
+ - HARDWARE_INT16: the int16 fixed-point port in teensy/, which reproduces the hardware's saturation and rounding
+ - FAST_FLOAT: the float32 port in teensy-float/, perceptually matched but not bit-exact, and cheaper to run */
+enum GraphEngine {
+	HARDWARE_INT16,
+	FAST_FLOAT,
+	NUM_GRAPH_ENGINES
+};
+
+// Each engine names the same set of audio objects, so a plugin written against one builds against either (see
+// USING_TEENSY_ENGINE)
+struct Int16Engine {
+	typedef ::audio_block_t audio_block_t;
+	typedef ::TeensyBuffer TeensyBuffer;
+	typedef ::AudioAmplifier AudioAmplifier;
+	typedef ::AudioEffectBitcrusher AudioEffectBitcrusher;
+	typedef ::AudioEffectDigitalCombine AudioEffectDigitalCombine;
+	typedef ::AudioEffectFlange AudioEffectFlange;
+	typedef ::AudioEffectFreeverb AudioEffectFreeverb;
+	typedef ::AudioEffectGranular AudioEffectGranular;
+	typedef ::AudioEffectMultiply AudioEffectMultiply;
+	typedef ::AudioEffectWaveFolder AudioEffectWaveFolder;
+	typedef ::AudioFilterStateVariable AudioFilterStateVariable;
+	typedef ::AudioMixer4 AudioMixer4;
+	typedef ::AudioMixerTree AudioMixerTree;
+	typedef ::AudioSynthNoisePink AudioSynthNoisePink;
+	typedef ::AudioSynthNoiseWhite AudioSynthNoiseWhite;
+	typedef ::AudioSynthWaveform AudioSynthWaveform;
+	typedef ::AudioSynthWaveformBank AudioSynthWaveformBank;
+	typedef ::AudioSynthWaveformDc AudioSynthWaveformDc;
+	typedef ::AudioSynthWaveformModulated AudioSynthWaveformModulated;
+	typedef ::AudioSynthWaveformPWM AudioSynthWaveformPWM;
+	typedef ::AudioSynthWaveformSine AudioSynthWaveformSine;
+	typedef ::AudioSynthWaveformSineModulated AudioSynthWaveformSineModulated;
+
+	// empties a full buffer into out, as floats in the range [-1, 1]
+	static void shiftBlock(TeensyBuffer& buffer, float* out) {
+		int16_t block[AUDIO_BLOCK_SAMPLES];
+		buffer.shiftBuffer(block, AUDIO_BLOCK_SAMPLES);
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			out[i] = int16_to_float_1v(block[i]);
+		}
+	}
+};
+
+struct FloatEngine {
+	typedef teensyfloat::audio_block_t audio_block_t;
+	typedef teensyfloat::TeensyBuffer TeensyBuffer;
+	typedef teensyfloat::AudioAmplifier AudioAmplifier;
+	typedef teensyfloat::AudioEffectBitcrusher AudioEffectBitcrusher;
+	typedef teensyfloat::AudioEffectDigitalCombine AudioEffectDigitalCombine;
+	typedef teensyfloat::AudioEffectFlange AudioEffectFlange;
+	typedef teensyfloat::AudioEffectFreeverb AudioEffectFreeverb;
+	typedef teensyfloat::AudioEffectGranular AudioEffectGranular;
+	typedef teensyfloat::AudioEffectMultiply AudioEffectMultiply;
+	typedef teensyfloat::AudioEffectWaveFolder AudioEffectWaveFolder;
+	typedef teensyfloat::AudioFilterStateVariable AudioFilterStateVariable;
+	typedef teensyfloat::AudioMixer4 AudioMixer4;
+	typedef teensyfloat::AudioMixerTree AudioMixerTree;
+	typedef teensyfloat::AudioSynthNoisePink AudioSynthNoisePink;
+	typedef teensyfloat::AudioSynthNoiseWhite AudioSynthNoiseWhite;
+	typedef teensyfloat::AudioSynthWaveform AudioSynthWaveform;
+	typedef teensyfloat::AudioSynthWaveformBank AudioSynthWaveformBank;
+	typedef teensyfloat::AudioSynthWaveformDc AudioSynthWaveformDc;
+	typedef teensyfloat::AudioSynthWaveformModulated AudioSynthWaveformModulated;
+	typedef teensyfloat::AudioSynthWaveformPWM AudioSynthWaveformPWM;
+	typedef teensyfloat::AudioSynthWaveformSine AudioSynthWaveformSine;
+	typedef teensyfloat::AudioSynthWaveformSineModulated AudioSynthWaveformSineModulated;
+
+	static void shiftBlock(TeensyBuffer& buffer, float* out) {
+		buffer.shiftBuffer(out, AUDIO_BLOCK_SAMPLES);
+	}
+};
+
+// brings an engine's audio objects into a plugin's scope under their Teensy names
+#define USING_TEENSY_ENGINE(Engine) \
+	typedef typename Engine::audio_block_t audio_block_t; \
+	typedef typename Engine::TeensyBuffer TeensyBuffer; \
+	typedef typename Engine::AudioAmplifier AudioAmplifier; \
+	typedef typename Engine::AudioEffectBitcrusher AudioEffectBitcrusher; \
+	typedef typename Engine::AudioEffectDigitalCombine AudioEffectDigitalCombine; \
+	typedef typename Engine::AudioEffectFlange AudioEffectFlange; \
+	typedef typename Engine::AudioEffectFreeverb AudioEffectFreeverb; \
+	typedef typename Engine::AudioEffectGranular AudioEffectGranular; \
+	typedef typename Engine::AudioEffectMultiply AudioEffectMultiply; \
+	typedef typename Engine::AudioEffectWaveFolder AudioEffectWaveFolder; \
+	typedef typename Engine::AudioFilterStateVariable AudioFilterStateVariable; \
+	typedef typename Engine::AudioMixer4 AudioMixer4; \
+	typedef typename Engine::AudioMixerTree AudioMixerTree; \
+	typedef typename Engine::AudioSynthNoisePink AudioSynthNoisePink; \
+	typedef typename Engine::AudioSynthNoiseWhite AudioSynthNoiseWhite; \
+	typedef typename Engine::AudioSynthWaveform AudioSynthWaveform; \
+	typedef typename Engine::AudioSynthWaveformBank AudioSynthWaveformBank; \
+	typedef typename Engine::AudioSynthWaveformDc AudioSynthWaveformDc; \
+	typedef typename Engine::AudioSynthWaveformModulated AudioSynthWaveformModulated; \
+	typedef typename Engine::AudioSynthWaveformPWM AudioSynthWaveformPWM; \
+	typedef typename Engine::AudioSynthWaveformSine AudioSynthWaveformSine; \
+	typedef typename Engine::AudioSynthWaveformSineModulated AudioSynthWaveformSineModulated;
 
 
 class NoisePlethoraPlugin {
@@ -26,11 +129,50 @@ public:
 	// then request that the buffer be refilled, returns values in range [-1, 1]
 	float processGraph() {
 
-		if (blockBuffer.empty()) {
-			processGraphAsBlock(blockBuffer);
+		if (outputIndex >= AUDIO_BLOCK_SAMPLES) {
+			renderGraph(output);
+			outputIndex = blockStart;
+			blockStart = 0;
 		}
 
-		return int16_to_float_1v(blockBuffer.shift());
+		return output[outputIndex++];
+	}
+
+	// fills out with the next frames values in range [-1, 1], for any frames; whole blocks that line up with the
+	// graph are rendered straight into out
+	void processGraph(float* out, int frames) {
+
+		while (frames > 0) {
+			if (outputIndex >= AUDIO_BLOCK_SAMPLES) {
+				if (blockStart == 0 && frames >= AUDIO_BLOCK_SAMPLES) {
+					renderGraph(out);
+					out += AUDIO_BLOCK_SAMPLES;
+					frames -= AUDIO_BLOCK_SAMPLES;
+					continue;
+				}
+				renderGraph(output);
+				outputIndex = blockStart;
+				blockStart = 0;
+			}
+
+			const int n = std::min(frames, AUDIO_BLOCK_SAMPLES - outputIndex);
+			std::copy(output + outputIndex, output + outputIndex + n, out);
+			outputIndex += n;
+			out += n;
+			frames -= n;
+		}
+	}
+
+	// position in its block of the next value to be read, a new block is rendered whenever this is 0
+	int getBlockPosition() const {
+		return (outputIndex >= AUDIO_BLOCK_SAMPLES) ? blockStart : outputIndex;
+	}
+
+	// shifts the graph's block boundaries so that the next value read is at the given position in its block, used
+	// to stop two graphs rendering on the same sample. The first block is read from position onwards, so the output
+	// has no gap. Call before the first processGraph()
+	void setBlockPosition(int position) {
+		blockStart = rack::math::eucMod(position, AUDIO_BLOCK_SAMPLES);
 	}
 
 	virtual AudioStream& getStream() = 0;
@@ -38,53 +180,39 @@ public:
 
 protected:
 
-	// subclass should process the audio graph and fill the supplied buffer
-	virtual void processGraphAsBlock(TeensyBuffer& blockBuffer) = 0;
+	// subclass should process the audio graph into AUDIO_BLOCK_SAMPLES values in range [-1, 1]
+	virtual void renderGraph(float* out) = 0;
 
-	TeensyBuffer blockBuffer;
+private:
+	float output[AUDIO_BLOCK_SAMPLES] = {};
+	int outputIndex = AUDIO_BLOCK_SAMPLES;
+	// where in the first rendered block output starts, see setBlockPosition()
+	int blockStart = 0;
 };
 
+/** Base of the plugins, which are templates on the engine their audio graph is built from */
+template <class Engine>
+class NoisePlethoraGraph : public NoisePlethoraPlugin {
 
-class MyFactory {
-public:
-	static MyFactory* Instance() {
-		static MyFactory factory;
-		return &factory;
-	}
-
-	std::shared_ptr<NoisePlethoraPlugin> Create(std::string name) {
-		NoisePlethoraPlugin* instance = nullptr;
-
-		// find name in the registry and call factory method.
-		auto it = factoryFunctionRegistry.find(name);
-		if (it != factoryFunctionRegistry.end()) {
-			instance = it->second();
-		}
+protected:
+	typedef typename Engine::TeensyBuffer TeensyBuffer;
 
-		// wrap instance in a shared ptr and return
-		if (instance != nullptr) {
-			return std::shared_ptr<NoisePlethoraPlugin>(instance);
-		}
-		else {
-			return nullptr;
-		}
-	}
+	// subclass should process the audio graph and fill the supplied buffer
+	virtual void processGraphAsBlock(TeensyBuffer& blockBuffer) = 0;
 
-	void RegisterFactoryFunction(std::string name, std::function<NoisePlethoraPlugin*(void)> classFactoryFunction) {
-		// register the class factory function
-		factoryFunctionRegistry[name] = classFactoryFunction;
+	void renderGraph(float* out) override {
+		processGraphAsBlock(blockBuffer);
+		Engine::shiftBlock(blockBuffer, out);
 	}
 
-	std::map<std::string, std::function<NoisePlethoraPlugin*(void)>> factoryFunctionRegistry;
+private:
+	TeensyBuffer blockBuffer;
 };
 
-template<class T> class Registrar {
-public:
-	Registrar(std::string className) {
-		// register the class factory function
-		MyFactory::Instance()->RegisterFactoryFunction(className,
-		    [](void) -> NoisePlethoraPlugin * { return new T();});
-	}
-};
 
-#define REGISTER_PLUGIN(NAME) static Registrar<NAME> NAME ##_reg(#NAME)
\ No newline at end of file
+/** Constructs the algorithm built from engine's audio objects, nullptr for ALGORITHM_NONE. Allocates, so not on the
+ audio thread (see AlgorithmPool) */
+std::unique_ptr<NoisePlethoraPlugin> createAlgorithm(AlgorithmId id, GraphEngine engine);
+
+/** Bytes taken by one instance of the algorithm built from engine's audio objects, not counting the heap */
+size_t getAlgorithmSize(AlgorithmId id, GraphEngine engine);
@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class Atari : public NoisePlethoraPlugin {
+template <class Engine>
+class Atari : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -66,5 +68,3 @@ private:
 	//AudioConnection          patchCord3;
 
 };
-
-REGISTER_PLUGIN(Atari);
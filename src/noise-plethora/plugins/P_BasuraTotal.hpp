@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class BasuraTotal : public NoisePlethoraPlugin {
+template <class Engine>
+class BasuraTotal : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -88,5 +90,3 @@ private:
 	// AudioConnection             patchCord1;
 	// unsigned long               lastClick;
 };
-
-REGISTER_PLUGIN(BasuraTotal);
\ No newline at end of file
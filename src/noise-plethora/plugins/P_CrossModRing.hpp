@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class CrossModRing : public NoisePlethoraPlugin {
+template <class Engine>
+class CrossModRing : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -115,5 +117,3 @@ private:
 	// AudioConnection          patchCord10(multiply1, 0, multiply3, 0);
 
 };
-
-REGISTER_PLUGIN(CrossModRing);
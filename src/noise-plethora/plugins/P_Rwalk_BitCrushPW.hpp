@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class Rwalk_BitCrushPW : public NoisePlethoraPlugin {
+template <class Engine>
+class Rwalk_BitCrushPW : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -35,14 +37,9 @@ public:
 		L = 600; // Size of box: maximum frequency
 		v_0 = 30; // speed: size of step in frequency units.
 
-		mixer1.gain(0, 1);
-		mixer1.gain(1, 1);
-		mixer1.gain(2, 1);
-		mixer1.gain(3, 1);
-		mixer2.gain(0, 1);
-		mixer2.gain(1, 1);
-		mixer2.gain(2, 1);
-		mixer2.gain(3, 1);
+		for (int i = 0; i < 8; i++) {
+			mixer.gain(i, 1);
+		}
 		// mixer3.gain(0, 1);
 		// mixer3.gain(1, 1);
 		// mixer3.gain(2, 1);
@@ -168,32 +165,27 @@ public:
 
 
 	void processGraphAsBlock(TeensyBuffer& blockBuffer) override {
-		// sum first block of oscillators
 		waveform1.update(&waveformBlock[0]);
 		waveform2.update(&waveformBlock[1]);
 		waveform3.update(&waveformBlock[2]);
 		waveform4.update(&waveformBlock[3]);
-		mixer1.update(&waveformBlock[0], &waveformBlock[1], &waveformBlock[2], &waveformBlock[3], &mixerBlock[0]);
-
-		// sum second block of oscillators
 		waveform5.update(&waveformBlock[4]);
 		waveform6.update(&waveformBlock[5]);
 		waveform7.update(&waveformBlock[6]);
 		waveform8.update(&waveformBlock[7]);
-		mixer2.update(&waveformBlock[4], &waveformBlock[5], &waveformBlock[6], &waveformBlock[7], &mixerBlock[1]);
 
-		// sum two blocks and feed into bitcrusher
-		mixer5.update(&mixerBlock[0], &mixerBlock[1], nullptr, nullptr, &mixerBlock[2]);
-		bitcrusher1.update(&mixerBlock[2], &bitcrushBlock);
+		// sum two blocks of oscillators (mixer1 and mixer2 into mixer5) and feed into bitcrusher
+		mixer.update(waveformBlock, 8, &mixerBlock[0]);
+		bitcrusher1.update(&mixerBlock[0], &bitcrushBlock);
 
 		waveform9.update(&waveformBlock[8]);
 		// mixer3/6 are just one-input + unit gain so just skip to freeverb
 		freeverb1.update(&waveformBlock[8], &freeverbBlock);
 
 		// finally sum bitcrush and freeverb
-		mixer7.update(&bitcrushBlock, &freeverbBlock, nullptr, nullptr, &mixerBlock[3]);
+		mixer7.update(&bitcrushBlock, &freeverbBlock, nullptr, nullptr, &mixerBlock[1]);
 
-		blockBuffer.pushBuffer(mixerBlock[3].data, AUDIO_BLOCK_SAMPLES);
+		blockBuffer.pushBuffer(mixerBlock[1].data, AUDIO_BLOCK_SAMPLES);
 	}
 
 	AudioStream& getStream() override {
@@ -205,7 +197,7 @@ public:
 
 private:
 
-	audio_block_t waveformBlock[9], mixerBlock[4], bitcrushBlock, freeverbBlock;
+	audio_block_t waveformBlock[9], mixerBlock[2], bitcrushBlock, freeverbBlock;
 
 	/* will be filled in */
 	// GUItool: begin automatically generated code
@@ -218,12 +210,10 @@ private:
 	AudioSynthWaveform       waveform3;      //xy=522.75,391.75
 	AudioSynthWaveform       waveform1;      //xy=523.75,316.75
 	AudioSynthWaveform       waveform2;      //xy=523.75,354.75
-	AudioMixer4              mixer2; //xy=713.75,528.75
-	AudioMixer4              mixer1;         //xy=714.75,377.75
 	//AudioMixer4              mixer3; //xy=716.75,664.75
 	//AudioMixer4              mixer6;         //xy=1248,561
 
-	AudioMixer4              mixer5; //xy=961.75,589.75
+	AudioMixerTree           mixer; // mixer1 and mixer2 into mixer5
 
 	AudioEffectBitcrusher    bitcrusher1;    //xy=1439,393
 	AudioEffectFreeverb      freeverb1;      //xy=923.5,281.5
@@ -248,11 +238,9 @@ private:
 	// AudioConnection          patchCord24(freeverb1, 0, mixer7, 2);
 
 
-	int L; //, i, t;
-	float theta, posx, posy, xn, yin;
-	float v_0, v_var, bc_01, fv;//pw = pulse width
-	float x[9], y[9], vx[9], vy[9]; // number depends on waveforms declared
+	int L = 0; //, i, t;
+	float theta = 0.f, posx = 0.f, posy = 0.f, xn = 0.f, yin = 0.f;
+	float v_0 = 0.f, v_var = 0.f, bc_01 = 0.f, fv = 0.f;//pw = pulse width
+	float x[9] = {}, y[9] = {}, vx[9] = {}, vy[9] = {}; // number depends on waveforms declared
 
 };
-
-REGISTER_PLUGIN(Rwalk_BitCrushPW); // this is important, so that we can include the plugin in a bank
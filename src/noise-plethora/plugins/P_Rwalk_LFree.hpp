@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class Rwalk_LFree : public NoisePlethoraPlugin {
+template <class Engine>
+class Rwalk_LFree : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -146,11 +148,9 @@ private:
 	//AudioConnection          patchCord4;
 	//AudioConnection          patchCord5;
 
-	int L; //, i, t;
-	float theta, posx, posy, xn, yin;
-	float v_0, v_var;//pw = pulse width
-	float x[4], y[4], vx[4], vy[4]; // number depends on waveforms declared
+	int L = 0; //, i, t;
+	float theta = 0.f, posx = 0.f, posy = 0.f, xn = 0.f, yin = 0.f;
+	float v_0 = 0.f, v_var = 0.f;//pw = pulse width
+	float x[4] = {}, y[4] = {}, vx[4] = {}, vy[4] = {}; // number depends on waveforms declared
 
 };
-
-REGISTER_PLUGIN(Rwalk_LFree); // this is important, so that we can include the plugin in a bank
@@ -4,7 +4,9 @@
 
 #define FLANGE_DELAY_LENGTH (2*AUDIO_BLOCK_SAMPLES)
 
-class Rwalk_SineFMFlange : public NoisePlethoraPlugin {
+template <class Engine>
+class Rwalk_SineFMFlange : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -182,18 +184,16 @@ private:
 	// AudioConnection          patchCord9;
 
 
-	int L; //, i, t;
-	float theta, posx, posy, xn, yin;
-	float v_0, v_var, snfm;//pw = pulse width
-	float x[4], y[4], vx[4], vy[4]; // number depends on waveforms declared
+	int L = 0; //, i, t;
+	float theta = 0.f, posx = 0.f, posy = 0.f, xn = 0.f, yin = 0.f;
+	float v_0 = 0.f, v_var = 0.f, snfm = 0.f;//pw = pulse width
+	float x[4] = {}, y[4] = {}, vx[4] = {}, vy[4] = {}; // number depends on waveforms declared
 
 	/*Variables for flange effect*/
-	short l_delayline[FLANGE_DELAY_LENGTH]; //left channel
+	short l_delayline[FLANGE_DELAY_LENGTH] = {}; //left channel
 	int s_idx = 2 * FLANGE_DELAY_LENGTH / 4;
 	int s_depth = FLANGE_DELAY_LENGTH / 4;
 	double s_freq = 3;
-	double mod_freq;
+	double mod_freq = 0.0;
 
 };
-
-REGISTER_PLUGIN(Rwalk_SineFMFlange); // this is important, so that we can include the plugin in a bank
@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class S_H : public NoisePlethoraPlugin {
+template <class Engine>
+class S_H : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -61,5 +63,3 @@ private:
 	//AudioConnection          patchCord3(freeverb1, 0, mixer1, 1);
 
 };
-
-REGISTER_PLUGIN(S_H);
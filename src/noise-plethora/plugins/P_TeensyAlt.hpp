@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class TeensyAlt : public NoisePlethoraPlugin {
+template <class Engine>
+class TeensyAlt : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -60,5 +62,3 @@ private:
 	AudioFilterStateVariable filter1;        //xy=1062.2726001739502,460.8181266784668
 
 };
-
-REGISTER_PLUGIN(TeensyAlt);
@@ -5,7 +5,9 @@
 #include "NoisePlethoraPlugin.hpp"
 
 
-class TestPlugin : public NoisePlethoraPlugin {
+template <class Engine>
+class TestPlugin : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -80,6 +82,3 @@ private:
 	//AudioConnection          patchCord3;
 
 };
-
-
-REGISTER_PLUGIN(TestPlugin);
\ No newline at end of file
@@ -3,7 +3,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class WalkingFilomena : public NoisePlethoraPlugin {
+template <class Engine>
+class WalkingFilomena : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -41,26 +43,13 @@ public:
 		L = 1800; // Size of box: maximum frequency
 		v_0 = 10; // speed: size of step in frequency units.
 
-		mixer1.gain(0, 1);
-		mixer1.gain(1, 1);
-		mixer1.gain(2, 1);
-		mixer1.gain(3, 1);
-		mixer2.gain(0, 1);
-		mixer2.gain(1, 1);
-		mixer2.gain(2, 1);
-		mixer2.gain(3, 1);
-		mixer3.gain(0, 1);
-		mixer3.gain(1, 1);
-		mixer3.gain(2, 1);
-		mixer3.gain(3, 1);
-		mixer4.gain(0, 1);
-		mixer4.gain(1, 1);
-		mixer4.gain(2, 1);
-		mixer4.gain(3, 1);
-		mixer5.gain(0, 1);
-		mixer5.gain(1, 1);
-		mixer5.gain(2, 1);
-		mixer5.gain(3, 1);
+		for (int i = 0; i < 16; i++) {
+			mixer.gain(i, 1);
+		}
+		mixer.groupGain(0, 1);
+		mixer.groupGain(1, 1);
+		mixer.groupGain(2, 1);
+		mixer.groupGain(3, 1);
 
 		//   SINE
 		WaveformType masterWaveform = WAVEFORM_PULSE;
@@ -229,17 +218,13 @@ public:
 		waveform15.update(&waveformBlock[14]);
 		waveform16.update(&waveformBlock[15]);
 
-		mixer1.update(&waveformBlock[0], &waveformBlock[1], &waveformBlock[2], &waveformBlock[3], &mixBlock[0]);
-		mixer2.update(&waveformBlock[4], &waveformBlock[5], &waveformBlock[6], &waveformBlock[7], &mixBlock[1]);
-		mixer3.update(&waveformBlock[8], &waveformBlock[9], &waveformBlock[10], &waveformBlock[11], &mixBlock[2]);
-		mixer4.update(&waveformBlock[12], &waveformBlock[13], &waveformBlock[14], &waveformBlock[15], &mixBlock[3]);
-
-		mixer5.update(&mixBlock[0], &mixBlock[1], &mixBlock[2], &mixBlock[3], &mixBlock[4]);
-		blockBuffer.pushBuffer(mixBlock[4].data, AUDIO_BLOCK_SAMPLES);
+		// mixer1-4 into mixer5, in one pass
+		mixer.update(waveformBlock, 16, &mixBlock);
+		blockBuffer.pushBuffer(mixBlock.data, AUDIO_BLOCK_SAMPLES);
 	}
 
 	AudioStream& getStream() override {
-		return mixer5;
+		return mixer;
 	}
 	unsigned char getPort() override {
 		return 0;
@@ -247,7 +232,7 @@ public:
 
 private:
 
-	audio_block_t waveformBlock[16], mixBlock[5];
+	audio_block_t waveformBlock[16], mixBlock;
 
 	/* will be filled in */
 	// GUItool: begin automatically generated code
@@ -267,11 +252,7 @@ private:
 	AudioSynthWaveform       waveform3;      //xy=522.75,391.75
 	AudioSynthWaveform       waveform1;      //xy=523.75,316.75
 	AudioSynthWaveform       waveform2;      //xy=523.75,354.75
-	AudioMixer4              mixer2; //xy=713.75,528.75
-	AudioMixer4              mixer1;         //xy=714.75,377.75
-	AudioMixer4              mixer3; //xy=716.75,664.75
-	AudioMixer4              mixer4; //xy=717.75,792.75
-	AudioMixer4              mixer5; //xy=961.75,589.75
+	AudioMixerTree           mixer; // mixer1-4 into mixer5
 	//AudioOutputI2S           i2s1;           //xy=1227.75,604.75
 	// AudioConnection          patchCord1;
 	// AudioConnection          patchCord2;
@@ -295,11 +276,9 @@ private:
 	// AudioConnection          patchCord20;
 	//AudioConnection          patchCord21(mixer5, 0, i2s1, 0);
 	//AudioControlSGTL5000     audioOut;     //xy=1016.75,846.75
-	int L; //, i, t;
-	float theta, posx, posy, xn, yin;
-	float v_0, v_var;//pw = pulse width
-	float x[16], y[16], vx[16], vy[16]; // number depends on waveforms declared
+	int L = 0; //, i, t;
+	float theta = 0.f, posx = 0.f, posy = 0.f, xn = 0.f, yin = 0.f;
+	float v_0 = 0.f, v_var = 0.f;//pw = pulse width
+	float x[16] = {}, y[16] = {}, vx[16] = {}, vy[16] = {}; // number depends on waveforms declared
 
 };
-
-REGISTER_PLUGIN(WalkingFilomena); // this is important, so that we can include the plugin in a bank
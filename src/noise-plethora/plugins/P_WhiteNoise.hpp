@@ -3,7 +3,9 @@
 #include "NoisePlethoraPlugin.hpp"
 #include <rack.hpp>
 
-class WhiteNoise : public NoisePlethoraPlugin {
+template <class Engine>
+class WhiteNoise : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -45,5 +47,3 @@ private:
 	AudioSynthNoiseWhite noise1;
 
 };
-
-REGISTER_PLUGIN(WhiteNoise);
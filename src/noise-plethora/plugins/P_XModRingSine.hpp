@@ -4,7 +4,9 @@
 #include "NoisePlethoraPlugin.hpp"
 
 
-class XModRingSine : public NoisePlethoraPlugin {
+template <class Engine>
+class XModRingSine : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 	XModRingSine()
@@ -76,5 +78,3 @@ private:
 	// AudioConnection          patchCord3;
 	// AudioConnection          patchCord4;
 };
-
-REGISTER_PLUGIN(XModRingSine); // this is important, so that we can include the plugin in a bank
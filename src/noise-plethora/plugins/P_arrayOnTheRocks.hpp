@@ -4,7 +4,9 @@
 
 
 
-class arrayOnTheRocks: public NoisePlethoraPlugin {
+template <class Engine>
+class arrayOnTheRocks : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 public:
 
 	arrayOnTheRocks()
@@ -92,34 +94,9 @@ private:
 	AudioSynthWaveformModulated waveformMod1;   //xy=475.88893127441406,517.2221565246582
 	// AudioConnection          patchCord1;
 
-	const int16_t test = 8622; // (int16_t)random(-28000, 28000);
-	const int16_t myWaveform[256] = {0,  1895,  3748,  5545,  7278,  8934, 10506, 11984, 13362, 14634,
-	                                 test, 16840, 17769, 18580, 19274, 19853, 20319, 20678, 20933, 21093,
-	                                 21163, 21153, 21072, 20927, 20731, 20492, 20221, test, 19625, 19320,
-	                                 19022, 18741, 18486, 18263, 18080, 17942, 17853, 17819, 17841, 17920,
-	                                 18058, 18254, 18507, 18813, 19170, 19573, 20017, 20497, 21006, test,
-	                                 test, test, test, 23753, 24294, 24816, 25314, 25781, 26212, 26604,
-	                                 26953, test, test, 27718, 27876, 27986, test, test, test, 27989,
-	                                 27899, 27782, 27644, 27490, test, test, test, test, test, 26582,
-	                                 26487, 26423, test, test, test, test, test, 26812, 27012, 27248,
-	                                 27514, 27808, 28122, test, 28787, test, 29451, 29762, 30045, 30293,
-	                                 test, 30643, 30727, 30738, 30667, test, 30254, 29897, test, 28858,
-	                                 28169, 27363, 26441, 25403, 24251, 22988, 21620, 20150, 18587, 16939,
-	                                 15214, 13423, 11577,  9686,  7763,  5820,  3870,  1926,     0, -1895,
-	                                 -3748, -5545, -7278, -8934, -10506, test, -13362, -14634, -15794, -16840,
-	                                 -17769, -18580, -19274, -19853, -20319, -20678, -20933, -21093, -21163, -21153,
-	                                 -21072, -20927, (int16_t) - test, -20492, -20221, -19929, -19625, -19320, -19022, -18741,
-	                                 (int16_t) - test, -18263, -18080, -17942, -17853, (int16_t) - test, -17841, -17920, -18058, -18254,
-	                                 -18507, -18813, -19170, -19573, (int16_t) - test, -20497, -21006, -21538, -22085, -22642,
-	                                 -23200, -23753, (int16_t) - test, (int16_t) - test, -25314, -25781, -26212, -26604, -26953, -27256,
-	                                 -27511, -27718, (int16_t) - test, (int16_t) - test, (int16_t) - test, -28068, -28047, (int16_t) - test, -27899, -27782,
-	                                 -27644, -27490, -27326, (int16_t) - test, -26996, -26841, -26701, -26582, -26487, (int16_t) - test,
-	                                 -26392, -26397, -26441, -26525, (int16_t) - test, -26812, (int16_t) - test, -27248, -27514, -27808,
-	                                 -28122, -28451, (int16_t) - test, (int16_t) - test, (int16_t) - test, -29762, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test,
-	                                 (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, test, -28169, -27363,
-	                                 (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, test,
-	                                 (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test
-	                                };
+	// the waveform never changes, so every instance (one per polyphonic voice) shares one copy
+	static constexpr int16_t test = 8622; // (int16_t)random(-28000, 28000);
+	static const int16_t myWaveform[256];
 
 	// int current_waveform = 0;
 
@@ -129,9 +106,34 @@ private:
 
 };
 
-
-
-
-
-
-REGISTER_PLUGIN(arrayOnTheRocks); // this is important, so that we can include the plugin in a bank
+template <class Engine>
+constexpr int16_t arrayOnTheRocks<Engine>::test;
+
+template <class Engine>
+const int16_t arrayOnTheRocks<Engine>::myWaveform[256] = {0,  1895,  3748,  5545,  7278,  8934, 10506, 11984, 13362, 14634,
+                                                          test, 16840, 17769, 18580, 19274, 19853, 20319, 20678, 20933, 21093,
+                                                          21163, 21153, 21072, 20927, 20731, 20492, 20221, test, 19625, 19320,
+                                                          19022, 18741, 18486, 18263, 18080, 17942, 17853, 17819, 17841, 17920,
+                                                          18058, 18254, 18507, 18813, 19170, 19573, 20017, 20497, 21006, test,
+                                                          test, test, test, 23753, 24294, 24816, 25314, 25781, 26212, 26604,
+                                                          26953, test, test, 27718, 27876, 27986, test, test, test, 27989,
+                                                          27899, 27782, 27644, 27490, test, test, test, test, test, 26582,
+                                                          26487, 26423, test, test, test, test, test, 26812, 27012, 27248,
+                                                          27514, 27808, 28122, test, 28787, test, 29451, 29762, 30045, 30293,
+                                                          test, 30643, 30727, 30738, 30667, test, 30254, 29897, test, 28858,
+                                                          28169, 27363, 26441, 25403, 24251, 22988, 21620, 20150, 18587, 16939,
+                                                          15214, 13423, 11577,  9686,  7763,  5820,  3870,  1926,     0, -1895,
+                                                          -3748, -5545, -7278, -8934, -10506, test, -13362, -14634, -15794, -16840,
+                                                          -17769, -18580, -19274, -19853, -20319, -20678, -20933, -21093, -21163, -21153,
+                                                          -21072, -20927, (int16_t) - test, -20492, -20221, -19929, -19625, -19320, -19022, -18741,
+                                                          (int16_t) - test, -18263, -18080, -17942, -17853, (int16_t) - test, -17841, -17920, -18058, -18254,
+                                                          -18507, -18813, -19170, -19573, (int16_t) - test, -20497, -21006, -21538, -22085, -22642,
+                                                          -23200, -23753, (int16_t) - test, (int16_t) - test, -25314, -25781, -26212, -26604, -26953, -27256,
+                                                          -27511, -27718, (int16_t) - test, (int16_t) - test, (int16_t) - test, -28068, -28047, (int16_t) - test, -27899, -27782,
+                                                          -27644, -27490, -27326, (int16_t) - test, -26996, -26841, -26701, -26582, -26487, (int16_t) - test,
+                                                          -26392, -26397, -26441, -26525, (int16_t) - test, -26812, (int16_t) - test, -27248, -27514, -27808,
+                                                          -28122, -28451, (int16_t) - test, (int16_t) - test, (int16_t) - test, -29762, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test,
+                                                          (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, test, -28169, -27363,
+                                                          (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, test,
+                                                          (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test, (int16_t) - test
+                                                       };
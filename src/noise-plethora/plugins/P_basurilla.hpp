@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class basurilla : public NoisePlethoraPlugin {
+template <class Engine>
+class basurilla : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -104,5 +106,3 @@ private:
 	//
 
 };
-
-REGISTER_PLUGIN(basurilla);
@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class existencelsPain : public NoisePlethoraPlugin {
+template <class Engine>
+class existencelsPain : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -142,5 +144,3 @@ private:
 	// AudioConnection          patchCord12;
 
 };
-
-REGISTER_PLUGIN(existencelsPain); // this is important, so that we can include the plugin in a bank
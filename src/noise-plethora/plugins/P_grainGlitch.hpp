@@ -3,7 +3,9 @@
 #include "NoisePlethoraPlugin.hpp"
 #define GRANULAR_MEMORY_SIZE 12800  // enough for 290 ms at 44.1 kHz
 
-class grainGlitch : public NoisePlethoraPlugin {
+template <class Engine>
+class grainGlitch : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -80,12 +82,10 @@ private:
 	// AudioConnection          patchCord3;
 	// AudioConnection          patchCord4;
 
-	int16_t granularMemory[GRANULAR_MEMORY_SIZE];
+	int16_t granularMemory[GRANULAR_MEMORY_SIZE] = {};
 
 
 	audio_block_t granularOut;
 	audio_block_t waveformMod1Out;
 	audio_block_t combine1Out;
 };
-
-REGISTER_PLUGIN(grainGlitch);
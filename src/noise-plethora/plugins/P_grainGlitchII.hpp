@@ -3,7 +3,9 @@
 #include "NoisePlethoraPlugin.hpp"
 #define GRANULAR_MEMORY_SIZE 12800  // enough for 290 ms at 44.1 kHz
 
-class grainGlitchII : public NoisePlethoraPlugin {
+template <class Engine>
+class grainGlitchII : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -70,9 +72,7 @@ private:
 	// AudioConnection          patchCord1;
 	// AudioConnection          patchCord2;
 	// AudioConnection          patchCord3;
-	int16_t granularMemory[GRANULAR_MEMORY_SIZE];
+	int16_t granularMemory[GRANULAR_MEMORY_SIZE] = {};
 
 	audio_block_t granularOut, waveformMod1Out;
 };
-
-REGISTER_PLUGIN(grainGlitchII);
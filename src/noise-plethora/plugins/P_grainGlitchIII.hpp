@@ -3,7 +3,9 @@
 #include "NoisePlethoraPlugin.hpp"
 #define GRANULAR_MEMORY_SIZE 12800
 
-class grainGlitchIII : public NoisePlethoraPlugin {
+template <class Engine>
+class grainGlitchIII : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -65,10 +67,8 @@ private:
 	AudioSynthWaveformModulated waveformMod1;   //xy=889.75,480.74999871477485
 	//AudioConnection          patchCord2;
 	//AudioConnection          patchCord3;
-	int16_t granularMemory[GRANULAR_MEMORY_SIZE];
+	int16_t granularMemory[GRANULAR_MEMORY_SIZE] = {};
 
 	audio_block_t granularOut;
 	audio_block_t waveformMod1Previous;
 };
-
-REGISTER_PLUGIN(grainGlitchIII);
@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class phasingCluster : public NoisePlethoraPlugin {
+template <class Engine>
+class phasingCluster : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -52,48 +54,12 @@ public:
 
 
 	void init() override {
-		mixer1.gain(0, 1);
-		mixer1.gain(1, 1);
-		mixer1.gain(2, 1);
-		mixer1.gain(3, 1);
-		mixer2.gain(0, 1);
-		mixer2.gain(1, 1);
-		mixer2.gain(2, 1);
-		mixer2.gain(3, 1);
-		mixer3.gain(0, 1);
-		mixer3.gain(1, 1);
-		mixer3.gain(2, 1);
-		mixer3.gain(3, 1);
-		mixer4.gain(0, 1);
-		mixer4.gain(1, 1);
-		mixer4.gain(2, 1);
-		mixer4.gain(3, 1);
-		mixer5.gain(0, 1);
-		mixer5.gain(1, 1);
-		mixer5.gain(2, 1);
-		mixer5.gain(3, 1);
-
 		int masterWaveform = WAVEFORM_SQUARE;
 		float masterVolume = 0.1;
 		int indexWaveform = WAVEFORM_TRIANGLE;
 		float index = 0.005;
 
-		waveform1.begin(masterVolume, 794, masterWaveform);
-		waveform2.begin(masterVolume, 647, masterWaveform);
-		waveform3.begin(masterVolume, 524, masterWaveform);
-		waveform4.begin(masterVolume, 444, masterWaveform);
-		waveform5.begin(masterVolume, 368, masterWaveform);
-		waveform6.begin(masterVolume, 283, masterWaveform);
-		waveform7.begin(masterVolume, 283, masterWaveform);
-		waveform8.begin(masterVolume, 283, masterWaveform);
-		waveform9.begin(masterVolume, 283, masterWaveform);
-		waveform10.begin(masterVolume, 283, masterWaveform);
-		waveform11.begin(masterVolume, 283, masterWaveform);
-		waveform12.begin(masterVolume, 283, masterWaveform);
-		waveform13.begin(masterVolume, 283, masterWaveform);
-		waveform14.begin(masterVolume, 283, masterWaveform);
-		waveform15.begin(masterVolume, 283, masterWaveform);
-		waveform16.begin(masterVolume, 283, masterWaveform);
+		bank.begin(16, masterVolume, masterWaveform);
 
 		modulator1.begin(index, 10, indexWaveform);
 		modulator2.begin(index, 11, indexWaveform);
@@ -138,22 +104,22 @@ public:
 		float f15 = f14 * spread;
 		float f16 = f15 * spread;
 
-		waveform1.frequency(f1);
-		waveform2.frequency(f2);
-		waveform3.frequency(f3);
-		waveform4.frequency(f4);
-		waveform5.frequency(f5);
-		waveform6.frequency(f6);
-		waveform7.frequency(f7);
-		waveform8.frequency(f8);
-		waveform9.frequency(f9);
-		waveform10.frequency(f10);
-		waveform11.frequency(f11);
-		waveform12.frequency(f12);
-		waveform13.frequency(f13);
-		waveform14.frequency(f14);
-		waveform15.frequency(f15);
-		waveform16.frequency(f16);
+		bank.frequency(0, f1);
+		bank.frequency(1, f2);
+		bank.frequency(2, f3);
+		bank.frequency(3, f4);
+		bank.frequency(4, f5);
+		bank.frequency(5, f6);
+		bank.frequency(6, f7);
+		bank.frequency(7, f8);
+		bank.frequency(8, f9);
+		bank.frequency(9, f10);
+		bank.frequency(10, f11);
+		bank.frequency(11, f12);
+		bank.frequency(12, f13);
+		bank.frequency(13, f14);
+		bank.frequency(14, f15);
+		bank.frequency(15, f16);
 	}
 
 	void processGraphAsBlock(TeensyBuffer& blockBuffer) override {
@@ -177,35 +143,13 @@ public:
 		modulator16.update(&waveformOut[15]);
 
 		// FM from each of the modulators
-		waveform1.update(&waveformOut[0], nullptr, &waveformModOut[0]);
-		waveform2.update(&waveformOut[1], nullptr, &waveformModOut[1]);
-		waveform3.update(&waveformOut[2], nullptr, &waveformModOut[2]);
-		waveform4.update(&waveformOut[3], nullptr, &waveformModOut[3]);
-		waveform5.update(&waveformOut[4], nullptr, &waveformModOut[4]);
-		waveform6.update(&waveformOut[5], nullptr, &waveformModOut[5]);
-		waveform7.update(&waveformOut[6], nullptr, &waveformModOut[6]);
-		waveform8.update(&waveformOut[7], nullptr, &waveformModOut[7]);
-		waveform9.update(&waveformOut[8], nullptr, &waveformModOut[8]);
-		waveform10.update(&waveformOut[9], nullptr, &waveformModOut[9]);
-		waveform11.update(&waveformOut[10], nullptr, &waveformModOut[10]);
-		waveform12.update(&waveformOut[11], nullptr, &waveformModOut[11]);
-		waveform13.update(&waveformOut[12], nullptr, &waveformModOut[12]);
-		waveform14.update(&waveformOut[13], nullptr, &waveformModOut[13]);
-		waveform15.update(&waveformOut[14], nullptr, &waveformModOut[14]);
-		waveform16.update(&waveformOut[15], nullptr, &waveformModOut[15]);
-
-		mixer1.update(&waveformModOut[0], &waveformModOut[1], &waveformModOut[2], &waveformModOut[3], &mixerOut[0]);
-		mixer2.update(&waveformModOut[4], &waveformModOut[5], &waveformModOut[6], &waveformModOut[7], &mixerOut[1]);
-		mixer3.update(&waveformModOut[8], &waveformModOut[9], &waveformModOut[10], &waveformModOut[11], &mixerOut[2]);
-		mixer4.update(&waveformModOut[12], &waveformModOut[13], &waveformModOut[14], &waveformModOut[15], &mixerOut[3]);
+		bank.updatePerPartial(waveformOut, nullptr, &bankOut);
 
-		mixer5.update(&mixerOut[0], &mixerOut[1], &mixerOut[2], &mixerOut[3], &mixerOut[4]);
-
-		blockBuffer.pushBuffer(mixerOut[4].data, AUDIO_BLOCK_SAMPLES);
+		blockBuffer.pushBuffer(bankOut.data, AUDIO_BLOCK_SAMPLES);
 	}
 
 	AudioStream& getStream() override {
-		return mixer5;
+		return bank;
 	}
 	unsigned char getPort() override {
 		return 0;
@@ -213,7 +157,7 @@ public:
 
 private:
 
-	audio_block_t waveformOut[16] = {}, waveformModOut[16] = {}, mixerOut[5] = {};
+	audio_block_t waveformOut[16] = {}, bankOut = {};
 
 	AudioSynthWaveform       modulator13; //xy=331.3333435058594,888.6666870117188
 	AudioSynthWaveform       modulator14; //xy=331.3333435058594,935.6666870117188
@@ -231,27 +175,7 @@ private:
 	AudioSynthWaveform       modulator10; //xy=344.3333435058594,687.6666870117188
 	AudioSynthWaveform       modulator8; //xy=346.3333435058594,569.6666870117188
 	AudioSynthWaveform       modulator9; //xy=350.3333435058594,624.6666870117188
-	AudioSynthWaveformModulated waveform16;     //xy=532.3333282470703,986.8888931274414
-	AudioSynthWaveformModulated waveform14;     //xy=534.3333282470703,881.8888931274414
-	AudioSynthWaveformModulated waveform15;     //xy=534.3333282470703,926.8888931274414
-	AudioSynthWaveformModulated waveform13;     //xy=535.3333282470703,839.8888931274414
-	AudioSynthWaveformModulated waveform8;      //xy=542.3333282470703,566.8888931274414
-	AudioSynthWaveformModulated waveform6;      //xy=544.3333282470703,461.8888931274414
-	AudioSynthWaveformModulated waveform7;      //xy=544.3333282470703,506.8888931274414
-	AudioSynthWaveformModulated waveform12;     //xy=543.3333282470703,777.8888931274414
-	AudioSynthWaveformModulated waveform5;      //xy=545.3333282470703,419.8888931274414
-	AudioSynthWaveformModulated waveform10;     //xy=545.3333282470703,672.8888931274414
-	AudioSynthWaveformModulated waveform11;     //xy=545.3333282470703,717.8888931274414
-	AudioSynthWaveformModulated waveform9;      //xy=546.3333282470703,630.8888931274414
-	AudioSynthWaveformModulated waveform4;      //xy=550.3333282470703,351.8888931274414
-	AudioSynthWaveformModulated waveform2;      //xy=552.3333282470703,246.8888931274414
-	AudioSynthWaveformModulated waveform3;      //xy=552.3333282470703,291.8888931274414
-	AudioSynthWaveformModulated waveform1;      //xy=553.3333282470703,203.8888931274414
-	AudioMixer4              mixer4;         //xy=752.3333282470703,930.8888931274414
-	AudioMixer4              mixer3;         //xy=763.3333282470703,721.8888931274414
-	AudioMixer4              mixer2;         //xy=769.3333282470703,510.8888931274414
-	AudioMixer4              mixer1;         //xy=770.3333282470703,295.8888931274414
-	AudioMixer4              mixer5;         //xy=1017.3333282470703,507.8888931274414
+	AudioSynthWaveformBank   bank;
 
 	// AudioConnection          patchCord1;
 	// AudioConnection          patchCord2;
@@ -290,5 +214,3 @@ private:
 	// AudioConnection          patchCord35;
 	// AudioConnection          patchCord36;
 };
-
-REGISTER_PLUGIN(phasingCluster);
@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class radioOhNo : public NoisePlethoraPlugin {
+template <class Engine>
+class radioOhNo : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -95,5 +97,3 @@ private:
 	// AudioConnection          patchCord9;
 	// AudioConnection          patchCord10;
 };
-
-REGISTER_PLUGIN(radioOhNo);
@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class resonoise : public NoisePlethoraPlugin {
+template <class Engine>
+class resonoise : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -91,5 +93,3 @@ private:
 	// AudioConnection          patchCord5;
 
 };
-
-REGISTER_PLUGIN(resonoise); // this is important, so that we can include the plugin in a bank
@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class satanWorkout : public NoisePlethoraPlugin {
+template <class Engine>
+class satanWorkout : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -70,5 +72,3 @@ private:
 
 
 };
-
-REGISTER_PLUGIN(satanWorkout); // this is important, so that we can include the plugin in a bank
@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class whoKnows : public NoisePlethoraPlugin {
+template <class Engine>
+class whoKnows : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -144,5 +146,3 @@ private:
 	// AudioConnection          patchCord12;
 
 };
-
-REGISTER_PLUGIN(whoKnows); // this is important, so that we can include the plugin in a bank
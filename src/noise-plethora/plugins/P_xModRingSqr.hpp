@@ -2,7 +2,9 @@
 
 #include "NoisePlethoraPlugin.hpp"
 
-class xModRingSqr : public NoisePlethoraPlugin {
+template <class Engine>
+class xModRingSqr : public NoisePlethoraGraph<Engine> {
+	USING_TEENSY_ENGINE(Engine)
 
 public:
 
@@ -67,5 +69,3 @@ private:
 	// AudioConnection          patchCord4;
 
 };
-
-REGISTER_PLUGIN(xModRingSqr);
@@ -68,7 +68,11 @@ public:
 		return program.setValue(p, getBankForIndex(getBank()).getSize());
 	}
 
-	const std::string getCurrentProgramName() {
+	AlgorithmId getCurrentProgramId() {
+		return getBankForIndex(getBank()).getProgramId(getProgram());
+	}
+
+	std::string getCurrentProgramName() {
 		return getBankForIndex(getBank()).getProgramName(getProgram());
 	}
 
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <rack.hpp>
+#include "../../plugin.hpp"
+
+#include "audio_core.hpp"
+#include "effect_bitcrusher.hpp"
+#include "effect_combine.hpp"
+#include "effect_freeverb.hpp"
+#include "effect_flange.hpp"
+#include "effect_granular.hpp"
+#include "effect_multiply.hpp"
+#include "effect_wavefolder.hpp"
+#include "filter_variable.hpp"
+#include "mixer.hpp"
+#include "synth_dc.hpp"
+#include "synth_sine.hpp"
+#include "synth_waveform.hpp"
+#include "synth_waveform_bank.hpp"
+#include "synth_whitenoise.hpp"
+#include "synth_pinknoise.hpp"
+#include "synth_pwm.hpp"
\ No newline at end of file
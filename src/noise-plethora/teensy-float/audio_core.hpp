@@ -0,0 +1,56 @@
+#pragma once
+
+#include <rack.hpp>
+#include "../../plugin.hpp"
+#include "../teensy/audio_core.hpp"
+
+// Float32 re-implementations of the teensy/ classes, derived from the Teensy Audio Library
+// (Copyright (c) 2014, Paul Stoffregen, paul@pjrc.com, MIT licence, see the headers in ../teensy).
+//
+// Each class has the same name, setters and update() signature as its teensy/ counterpart, so an audio graph can be
+// built from either set unchanged (see Int16Engine and FloatEngine in NoisePlethoraPlugin.hpp). Setters keep the
+// hardware's ranges and rounding, and samples are floats where 1.0 is int16 full scale (32767). Where the hardware
+// saturates to int16 the float classes clamp to [-1, 1], but intermediate fixed-point rounding and shifting is gone,
+// and the block loops are plain float arithmetic that the compiler vectorises. The results are perceptually matched
+// to the int16 engine, not bit-exact.
+
+namespace teensyfloat {
+
+typedef struct audio_block_struct {
+	alignas(16) float data[AUDIO_BLOCK_SAMPLES] = {};
+
+	// initialises data to zeroes
+	void zeroAudioBlock() {
+		std::fill(data, data + AUDIO_BLOCK_SAMPLES, 0.f);
+	}
+
+	static void copyBlock(const audio_block_struct* src, audio_block_struct* dst) {
+		if (src && dst) {
+			std::copy(src->data, src->data + AUDIO_BLOCK_SAMPLES, dst->data);
+		}
+	}
+} audio_block_t;
+
+typedef rack::dsp::RingBuffer<float, AUDIO_BLOCK_SAMPLES> TeensyBuffer;
+
+// 32 bit phase accumulator value to turns, i.e. [0, 1) for uint32_t or [-0.5, 0.5) for the same bits as int32_t
+static const float PHASE_TO_TURNS = 1.f / 4294967296.f;
+
+inline float clampSample(float x) {
+	return std::min(std::max(x, -1.f), 1.f);
+}
+
+// quantises a block to the int16 format, for the effects that operate on the bits of int16 samples
+inline void toInt16(const audio_block_t& in, ::audio_block_t& out) {
+	for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		out.data[i] = (int16_t) std::min(std::max(in.data[i] * 32767.f, -32768.f), 32767.f);
+	}
+}
+
+inline void toFloat(const ::audio_block_t& in, audio_block_t& out) {
+	for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		out.data[i] = int16_to_float_1v(in.data[i]);
+	}
+}
+
+} // namespace teensyfloat
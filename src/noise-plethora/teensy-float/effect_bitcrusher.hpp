@@ -0,0 +1,64 @@
+#pragma once
+
+#include "audio_core.hpp"
+
+namespace teensyfloat {
+
+class AudioEffectBitcrusher : public AudioStream {
+public:
+	AudioEffectBitcrusher(void)
+		: AudioStream(1) {}
+	void bits(uint8_t b) {
+		if (b > 16)
+			b = 16;
+		else if (b == 0)
+			b = 1;
+		crushBits = b;
+		// the int16 engine drops the low (16 - bits) bits, i.e. rounds down to a multiple of 2^(16 - bits)
+		quantum = (1 << (16 - b)) / 32767.f;
+	}
+	void sampleRate(float hz) {
+		// modification to account for Rack sample rate
+		int n = (APP->engine->getSampleRate() / hz) + 0.5f;
+		if (n < 1)
+			n = 1;
+		else if (n > 64)
+			n = 64;
+		sampleStep = n;
+	}
+	void update(const audio_block_t* inputBlock, audio_block_t* outputBlock) {
+		if (!inputBlock || !outputBlock) {
+			return;
+		}
+
+		if (sampleStep <= 1) {
+			if (crushBits == 16) {
+				// nothing to do. Output is sent through clean
+				audio_block_t::copyBlock(inputBlock, outputBlock);
+				return;
+			}
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				outputBlock->data[i] = crush(inputBlock->data[i]);
+			}
+		}
+		else {
+			// pick up a root sample every sampleStep samples (from the start of each block, as the int16 engine)
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i += sampleStep) {
+				const float sampleSqueeze = (crushBits == 16) ? inputBlock->data[i] : crush(inputBlock->data[i]);
+				const int end = std::min(i + (int) sampleStep, AUDIO_BLOCK_SAMPLES);
+				std::fill(outputBlock->data + i, outputBlock->data + end, sampleSqueeze);
+			}
+		}
+	}
+
+private:
+	float crush(float x) const {
+		return std::floor(x / quantum) * quantum;
+	}
+
+	uint8_t crushBits = 16; // 16 = off
+	float quantum = 1.f / 32767.f;
+	uint8_t sampleStep = 1; // the number of samples to double up. This simple technique only allows a few stepped positions.
+};
+
+} // namespace teensyfloat
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "audio_core.hpp"
+#include "../teensy/effect_combine.hpp"
+
+namespace teensyfloat {
+
+/** Combines the bits of the int16 samples, so the int16 implementation runs on quantised inputs and its output is
+ converted */
+class AudioEffectDigitalCombine : public AudioStream {
+public:
+	enum combineMode {
+		OR    = ::AudioEffectDigitalCombine::OR,
+		XOR   = ::AudioEffectDigitalCombine::XOR,
+		AND   = ::AudioEffectDigitalCombine::AND,
+		MODULO = ::AudioEffectDigitalCombine::MODULO,
+	};
+	AudioEffectDigitalCombine() : AudioStream(2) { }
+	void setCombineMode(int mode_in) {
+		combine.setCombineMode(mode_in);
+	}
+	void update(const audio_block_t* blocka, const audio_block_t* blockb, audio_block_t* output) {
+		if (!blocka || !blockb || !output) {
+			return;
+		}
+		toInt16(*blocka, int16BlockA);
+		toInt16(*blockb, int16BlockB);
+		combine.update(&int16BlockA, &int16BlockB, &int16Output);
+		toFloat(int16Output, *output);
+	}
+private:
+	::AudioEffectDigitalCombine combine;
+	::audio_block_t int16BlockA, int16BlockB, int16Output;
+};
+
+} // namespace teensyfloat
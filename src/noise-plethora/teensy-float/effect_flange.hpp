@@ -0,0 +1,34 @@
+#pragma once
+
+#include "audio_core.hpp"
+#include "../teensy/effect_flange.h"
+
+namespace teensyfloat {
+
+/** The flanger reads the caller's int16 delay line (and plugins size it in int16 samples), so the int16
+ implementation runs on the quantised input and its output is converted */
+class AudioEffectFlange : public AudioStream {
+public:
+	AudioEffectFlange(void) : AudioStream(1) {}
+
+	bool begin(short* delayline, int d_length, int delay_offset, int d_depth, float delay_rate) {
+		return flange.begin(delayline, d_length, delay_offset, d_depth, delay_rate);
+	}
+	bool voices(int delay_offset, int d_depth, float delay_rate) {
+		return flange.voices(delay_offset, d_depth, delay_rate);
+	}
+	void update(const audio_block_t* inputBlock, audio_block_t* outputBlock) {
+		if (!inputBlock || !outputBlock) {
+			return;
+		}
+		toInt16(*inputBlock, int16Input);
+		flange.update(&int16Input, &int16Output);
+		toFloat(int16Output, *outputBlock);
+	}
+
+private:
+	::AudioEffectFlange flange;
+	::audio_block_t int16Input, int16Output;
+};
+
+} // namespace teensyfloat
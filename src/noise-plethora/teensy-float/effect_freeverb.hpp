@@ -0,0 +1,133 @@
+#pragma once
+
+#include "audio_core.hpp"
+
+namespace teensyfloat {
+
+/** Freeverb with the int16 engine's delay lengths and gains. Each comb filter only depends on the input, so they
+ run one after another over the whole block (summing into one block), and so do the allpass filters. */
+class AudioEffectFreeverb : public AudioStream {
+public:
+	AudioEffectFreeverb() : AudioStream(1) {}
+	void update(const audio_block_t* block, audio_block_t* outblock) {
+		if (!block || !outblock) {
+			return;
+		}
+
+		float input[AUDIO_BLOCK_SAMPLES];
+		float sum[AUDIO_BLOCK_SAMPLES] = {};
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			// TODO: scale numerical range depending on roomsize & damping
+			input[i] = block->data[i] * (8738.f / 131072.f); // for numerical headroom
+		}
+
+		comb1.process(input, sum, combdamp1, combdamp2, combfeeback);
+		comb2.process(input, sum, combdamp1, combdamp2, combfeeback);
+		comb3.process(input, sum, combdamp1, combdamp2, combfeeback);
+		comb4.process(input, sum, combdamp1, combdamp2, combfeeback);
+		comb5.process(input, sum, combdamp1, combdamp2, combfeeback);
+		comb6.process(input, sum, combdamp1, combdamp2, combfeeback);
+		comb7.process(input, sum, combdamp1, combdamp2, combfeeback);
+		comb8.process(input, sum, combdamp1, combdamp2, combfeeback);
+
+		float* output = outblock->data;
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			output[i] = clampSample(sum[i] * (31457.f / 131072.f));
+		}
+
+		allpass1.process(output);
+		allpass2.process(output);
+		allpass3.process(output);
+		allpass4.process(output);
+
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			output[i] = clampSample(output[i] * 30.f);
+		}
+
+		if (snapTimer.process(AUDIO_BLOCK_SAMPLES)) {
+			comb1.snap();
+			comb2.snap();
+			comb3.snap();
+			comb4.snap();
+			comb5.snap();
+			comb6.snap();
+			comb7.snap();
+			comb8.snap();
+		}
+	}
+	void roomsize(float n) {
+		if (n > 1.0f)
+			n = 1.0f;
+		else if (n < 0.0f)
+			n = 0.0f;
+		combfeeback = ((int)(n * 9175.04f) + 22937) / 32768.f;
+	}
+	void damping(float n) {
+		if (n > 1.0f)
+			n = 1.0f;
+		else if (n < 0.0f)
+			n = 0.0f;
+		int x1 = (int)(n * 13107.2f);
+		int x2 = 32768 - x1;
+		combdamp1 = x1 / 32768.f;
+		combdamp2 = x2 / 32768.f;
+	}
+
+private:
+	template <int N>
+	struct Comb {
+		float buf[N] = {};
+		int index = 0;
+		float filter = 0.f;
+
+		void process(const float* input, float* sum, float damp1, float damp2, float feedback) {
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				const float bufout = buf[index];
+				sum[i] += bufout;
+				filter = bufout * damp2 + filter * damp1;
+				buf[index] = clampSample(input[i] + filter * feedback);
+				if (++index >= N)
+					index = 0;
+			}
+		}
+
+		void snap() {
+			filter = snapToZero(filter);
+		}
+	};
+
+	template <int N>
+	struct Allpass {
+		float buf[N] = {};
+		int index = 0;
+
+		void process(float* output) {
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				const float bufout = buf[index];
+				buf[index] = output[i] + bufout * 0.5f;
+				output[i] = clampSample((bufout - output[i]) * 0.5f);
+				if (++index >= N)
+					index = 0;
+			}
+		}
+	};
+
+	Comb<1116> comb1;
+	Comb<1188> comb2;
+	Comb<1277> comb3;
+	Comb<1356> comb4;
+	Comb<1422> comb5;
+	Comb<1491> comb6;
+	Comb<1557> comb7;
+	Comb<1617> comb8;
+	float combdamp1 = 6553 / 32768.f;
+	float combdamp2 = 26215 / 32768.f;
+	float combfeeback = 27524 / 32768.f;
+	Allpass<556> allpass1;
+	Allpass<441> allpass2;
+	Allpass<341> allpass3;
+	Allpass<225> allpass4;
+	DenormalSnapTimer snapTimer;
+};
+
+} // namespace teensyfloat
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "audio_core.hpp"
+#include "../teensy/effect_granular.hpp"
+
+namespace teensyfloat {
+
+/** The granular effect records into the caller's int16 sample bank, so the int16 implementation runs on the
+ quantised input and its output is converted */
+class AudioEffectGranular : public AudioStream {
+public:
+	AudioEffectGranular(void) : AudioStream(1) { }
+
+	void begin(int16_t* sample_bank_def, int16_t max_len_def) {
+		granular.begin(sample_bank_def, max_len_def);
+	}
+	void setSpeed(float ratio) {
+		granular.setSpeed(ratio);
+	}
+	void beginFreeze(float grain_length) {
+		granular.beginFreeze(grain_length);
+	}
+	void beginPitchShift(float grain_length) {
+		granular.beginPitchShift(grain_length);
+	}
+	void stop() {
+		granular.stop();
+	}
+	void update(const audio_block_t* input_block, audio_block_t* output_block) {
+		if (!input_block || !output_block) {
+			return;
+		}
+		toInt16(*input_block, int16Input);
+		granular.update(&int16Input, &int16Output);
+		toFloat(int16Output, *output_block);
+	}
+
+private:
+	::AudioEffectGranular granular;
+	::audio_block_t int16Input, int16Output;
+};
+
+} // namespace teensyfloat
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "audio_core.hpp"
+
+namespace teensyfloat {
+
+class AudioEffectMultiply : public AudioStream {
+public:
+	AudioEffectMultiply() : AudioStream(2) { }
+	void update(const audio_block_t* blocka, const audio_block_t* blockb, audio_block_t* blockout) {
+		if (!blocka || !blockb || !blockout) {
+			return;
+		}
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			blockout->data[i] = clampSample(blocka->data[i] * blockb->data[i]);
+		}
+	}
+};
+
+} // namespace teensyfloat
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "audio_core.hpp"
+
+namespace teensyfloat {
+
+class AudioEffectWaveFolder : public AudioStream {
+public:
+	AudioEffectWaveFolder() : AudioStream(2) {}
+	void update(const audio_block_t* blocka, const audio_block_t* blockb, audio_block_t* output) {
+		if (!blocka || !blockb || !output) {
+			return;
+		}
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			// scale upto 16 times input, so that can fold upto 16 times in each polarity
+			const float s = 16.f * blocka->data[i] * blockb->data[i];
+			// wrap into [-1, 1), reversing the sense in every other band
+			const float band = std::floor(0.5f * (s + 1.f));
+			const float wrapped = s - 2.f * band;
+			output->data[i] = ((int) band & 1) ? -wrapped : wrapped;
+		}
+	}
+};
+
+} // namespace teensyfloat
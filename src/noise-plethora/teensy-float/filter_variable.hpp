@@ -0,0 +1,120 @@
+#pragma once
+
+#include "audio_core.hpp"
+
+namespace teensyfloat {
+
+/** State Variable Filter (Chamberlin) with 2X oversampling, as the int16 AudioFilterStateVariable. The control input
+ sets the frequency with the same linear approximation of the coefficient as the int16 engine, so it tracks the same
+ way. */
+class AudioFilterStateVariable: public AudioStream {
+public:
+	AudioFilterStateVariable() : AudioStream(2) {
+		frequency(1000);
+		octaveControl(1.0); // default values
+		resonance(0.707);
+		state_inputprev = 0;
+		state_lowpass = 0;
+		state_bandpass = 0;
+	}
+	void frequency(float freq) {
+		// for reproducibility, max frequency cuts out at 2/5 Teensy sample rate
+		// (unless we're running at very low sample rates, in which case make sure we don't allow unstable f_c)
+		const float minFrequency = 20.f;
+		const float maxFrequency = std::min(AUDIO_SAMPLE_RATE_EXACT, APP->engine->getSampleRate()) / 2.5f;
+
+		if (freq < minFrequency) {
+			freq = minFrequency;
+		}
+		else if (freq > maxFrequency) {
+			freq = maxFrequency;
+		}
+		setting_fcenter = freq * (3.141592654f / (APP->engine->getSampleRate() * 2.0f));
+		setting_fmult = 2.f * sinf(setting_fcenter);
+	}
+	void resonance(float q) {
+		if (q < 0.7f)
+			q = 0.7f;
+		else if (q > 5.0f)
+			q = 5.0f;
+		// TODO: allow lower Q when frequency is lower
+		setting_damp = 1.0f / q;
+	}
+	void octaveControl(float n) {
+		// filter's corner frequency is Fcenter * 2^(control * N)
+		// where "control" ranges from -1.0 to +1.0
+		// and "N" allows the frequency to change from 0 to 7 octaves
+		if (n < 0.0f)
+			n = 0.0f;
+		else if (n > 6.9999f)
+			n = 6.9999f;
+		setting_octavemult = n;
+	}
+
+	void update(const audio_block_t* input_block, const audio_block_t* control_block,
+	            audio_block_t* lowpass_block, audio_block_t* bandpass_block, audio_block_t* highpass_block) {
+
+		if (control_block) {
+			// fmult = 2 fcenter 2^(control * N), limited as in the int16 engine (5378279 / 2^23)
+			float octaves[AUDIO_BLOCK_SAMPLES], fmult[AUDIO_BLOCK_SAMPLES];
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				octaves[i] = control_block->data[i] * setting_octavemult;
+			}
+			exp2_fast(octaves, fmult, AUDIO_BLOCK_SAMPLES);
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				fmult[i] = 2.f * std::min(setting_fcenter * fmult[i], 0.64114f);
+			}
+			process(input_block->data, fmult, lowpass_block->data, bandpass_block->data, highpass_block->data);
+		}
+		else {
+			float fmult[AUDIO_BLOCK_SAMPLES];
+			std::fill(fmult, fmult + AUDIO_BLOCK_SAMPLES, setting_fmult);
+			process(input_block->data, fmult, lowpass_block->data, bandpass_block->data, highpass_block->data);
+		}
+
+		if (snapTimer.process(AUDIO_BLOCK_SAMPLES)) {
+			state_inputprev = snapToZero(state_inputprev);
+			state_lowpass = snapToZero(state_lowpass);
+			state_bandpass = snapToZero(state_bandpass);
+		}
+	}
+
+private:
+	void process(const float* in, const float* fmult, float* lp, float* bp, float* hp) {
+		const float damp = setting_damp;
+		float inputprev = state_inputprev;
+		float lowpass = state_lowpass;
+		float bandpass = state_bandpass;
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			const float input = in[i];
+			const float f = fmult[i];
+			lowpass = lowpass + f * bandpass;
+			float highpass = (input + inputprev) * 0.5f - lowpass - damp * bandpass;
+			inputprev = input;
+			bandpass = bandpass + f * highpass;
+			const float lowpasstmp = lowpass;
+			const float bandpasstmp = bandpass;
+			const float highpasstmp = highpass;
+			lowpass = lowpass + f * bandpass;
+			highpass = input - lowpass - damp * bandpass;
+			bandpass = bandpass + f * highpass;
+			lp[i] = clampSample(0.5f * (lowpass + lowpasstmp));
+			bp[i] = clampSample(0.5f * (bandpass + bandpasstmp));
+			hp[i] = clampSample(0.5f * (highpass + highpasstmp));
+		}
+		state_inputprev = inputprev;
+		state_lowpass = lowpass;
+		state_bandpass = bandpass;
+	}
+
+	float setting_fcenter = 0.f;
+	float setting_fmult = 0.f;
+	float setting_octavemult = 0.f;
+	float setting_damp = 0.f;
+	float state_inputprev = 0.f;
+	float state_lowpass = 0.f;
+	float state_bandpass = 0.f;
+	DenormalSnapTimer snapTimer;
+};
+
+} // namespace teensyfloat
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "audio_core.hpp"
+#include "../teensy/mixer.hpp"
+
+namespace teensyfloat {
+
+class AudioMixer4 : public AudioStream {
+public:
+	AudioMixer4(void) : AudioStream(4) {
+		for (int i = 0; i < 4; i++)
+			multiplier[i] = 1.f;
+	}
+
+	void update(const audio_block_t* in1, const audio_block_t* in2, const audio_block_t* in3, const audio_block_t* in4, audio_block_t* out) {
+
+		if (!out) {
+			return;
+		}
+		else {
+			// zero buffer before processing
+			out->zeroAudioBlock();
+		}
+
+		// each input is added to the output with saturation, as the int16 engine does
+		const audio_block_t* in[4] = {in1, in2, in3, in4};
+		for (int channel = 0; channel < 4; channel++) {
+			if (in[channel]) {
+				const float gain = multiplier[channel];
+				for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+					out->data[i] = clampSample(out->data[i] + gain * in[channel]->data[i]);
+				}
+			}
+		}
+	}
+
+	void gain(unsigned int channel, float gain) {
+		if (channel >= 4)
+			return;
+		if (gain > 127.0f)
+			gain = 127.0f;
+		else if (gain < -127.0f)
+			gain = -127.0f;
+		multiplier[channel] = gain;
+	}
+private:
+	float multiplier[4] = {};
+};
+
+
+/** Up to four AudioMixer4 fed by up to 16 inputs, 4 * group + channel, whose outputs are summed by a fifth mixer.
+ The whole tree is evaluated in one pass over the block, four samples at a time, so the group mixers' outputs never
+ go through memory. Each input and each group saturates as it's added, as the int16 engine does. */
+class AudioMixerTree : public AudioStream {
+public:
+	static const int MAX_GROUPS = 4;
+	static const int MAX_INPUTS = 4 * MAX_GROUPS;
+
+	AudioMixerTree(void) : AudioStream(MAX_INPUTS) {
+		for (int i = 0; i < MAX_INPUTS; i++)
+			multiplier[i] = 1.f;
+		for (int group = 0; group < MAX_GROUPS; group++)
+			groupMultiplier[group] = 1.f;
+	}
+
+	/** Sums the first `numInputs` of the blocks at `in` */
+	void update(const audio_block_t* in, int numInputs, audio_block_t* out) {
+		if (!out) {
+			return;
+		}
+		numInputs = clamp(numInputs, 0, MAX_INPUTS);
+		const int numGroups = (numInputs + 3) / 4;
+
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i += 4) {
+			simd::float_4 sum = 0.f;
+			for (int group = 0; group < numGroups; group++) {
+				const int end = std::min(4 * group + 4, numInputs);
+				simd::float_4 groupSum = 0.f;
+				for (int input = 4 * group; input < end; input++) {
+					const simd::float_4 x = simd::float_4::load(&in[input].data[i]);
+					groupSum = simd::clamp(groupSum + multiplier[input] * x, -1.f, 1.f);
+				}
+				sum = simd::clamp(sum + groupMultiplier[group] * groupSum, -1.f, 1.f);
+			}
+			sum.store(&out->data[i]);
+		}
+	}
+
+	/** Gain of input `channel` into its group's mixer, as AudioMixer4::gain() */
+	void gain(unsigned int channel, float gain) {
+		if (channel >= MAX_INPUTS)
+			return;
+		multiplier[channel] = clamp(gain, -127.f, 127.f);
+	}
+
+	/** Gain of a group's mixer into the output mixer */
+	void groupGain(unsigned int group, float gain) {
+		if (group >= MAX_GROUPS)
+			return;
+		groupMultiplier[group] = clamp(gain, -127.f, 127.f);
+	}
+private:
+	float multiplier[MAX_INPUTS] = {};
+	float groupMultiplier[MAX_GROUPS] = {};
+};
+
+
+/** The int16 engine's amplifier overflows its 32 bit intermediate for large gains, and the plugins that use it rely
+ on the resulting distortion, so it runs the int16 implementation on a quantised copy of the block */
+class AudioAmplifier : public AudioStream {
+public:
+	AudioAmplifier(void) : AudioStream(1) {
+	}
+
+	// acts in place
+	void update(audio_block_t* block) {
+		if (!block) {
+			return;
+		}
+		toInt16(*block, int16Block);
+		amplifier.update(&int16Block);
+		toFloat(int16Block, *block);
+	}
+
+	void gain(float n) {
+		amplifier.gain(n);
+	}
+private:
+	::AudioAmplifier amplifier;
+	::audio_block_t int16Block;
+};
+
+} // namespace teensyfloat
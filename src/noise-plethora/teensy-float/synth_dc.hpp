@@ -0,0 +1,69 @@
+#pragma once
+
+#include "audio_core.hpp"
+
+namespace teensyfloat {
+
+class AudioSynthWaveformDc : public AudioStream {
+public:
+	AudioSynthWaveformDc() : AudioStream(0), remaining(0), magnitude(0), target(0), increment(0) {}
+	// immediately jump to the new DC level
+	void amplitude(float n) {
+		if (n > 1.0f)
+			n = 1.0f;
+		else if (n < -1.0f)
+			n = -1.0f;
+		magnitude = n;
+		remaining = 0;
+	}
+	// slowly transition to the new DC level
+	void amplitude(float n, float milliseconds) {
+		if (milliseconds <= 0.0f) {
+			amplitude(n);
+			return;
+		}
+		if (n > 1.0f)
+			n = 1.0f;
+		else if (n < -1.0f)
+			n = -1.0f;
+		int32_t c = (int32_t)(milliseconds * (AUDIO_SAMPLE_RATE_EXACT / 1000.0f));
+		if (c == 0) {
+			amplitude(n);
+			return;
+		}
+		target = n;
+		if (target == magnitude) {
+			remaining = 0;
+			return;
+		}
+		increment = (target - magnitude) / c;
+		remaining = c;
+	}
+	float read(void) {
+		return magnitude;
+	}
+	void update(audio_block_t* block) {
+		if (!block) {
+			return;
+		}
+
+		int i = 0;
+		// transitioning to a new DC level
+		for (; i < AUDIO_BLOCK_SAMPLES && remaining > 0; i++, remaining--) {
+			magnitude = (remaining == 1) ? target : magnitude + increment;
+			block->data[i] = magnitude;
+		}
+		// steady DC output, simply fill the rest of the buffer with a fixed value
+		for (; i < AUDIO_BLOCK_SAMPLES; i++) {
+			block->data[i] = magnitude;
+		}
+	}
+
+private:
+	int32_t remaining = 0; // samples until the target is reached, 0 for steady output
+	float magnitude = 0.f;   // current output
+	float target = 0.f;      // designed output (while transitiong)
+	float increment = 0.f;   // adjustment per sample (while transitiong)
+};
+
+} // namespace teensyfloat
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "audio_core.hpp"
+#include "../teensy/synth_pinknoise.hpp"
+
+namespace teensyfloat {
+
+/** The pink noise generator is all integer bit manipulation with no saturating arithmetic, so the int16
+ implementation runs as is and its output is converted */
+class AudioSynthNoisePink : public AudioStream {
+public:
+	AudioSynthNoisePink() : AudioStream(0) {}
+	void amplitude(float n) {
+		generator.amplitude(n);
+	}
+	void update(audio_block_t* block) {
+		if (!block) {
+			return;
+		}
+		generator.update(&int16Block);
+		toFloat(int16Block, *block);
+	}
+private:
+	::AudioSynthNoisePink generator;
+	::audio_block_t int16Block;
+};
+
+} // namespace teensyfloat
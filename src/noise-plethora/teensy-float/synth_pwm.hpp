@@ -0,0 +1,66 @@
+#pragma once
+
+#include "audio_core.hpp"
+
+namespace teensyfloat {
+
+class AudioSynthWaveformPWM : public AudioStream {
+public:
+	AudioSynthWaveformPWM() : AudioStream(1), duration(0), magnitude(0), elapsed(0) {}
+	void frequency(float freq) {
+
+		// for reproducibility, max frequency cuts out at 1/2 Teensy sample rate
+		// (unless we're running at very low sample rates, in which case use those to limit range)
+		const float maxFrequency = std::min(AUDIO_SAMPLE_RATE_EXACT, APP->engine->getSampleRate()) / 4.0f;
+
+		if (freq < 1.0) {
+			freq = 1.0;
+		}
+		else if (freq > maxFrequency) {
+			freq = maxFrequency;
+		}
+		duration = APP->engine->getSampleRate() / (freq * 2.0f);
+	}
+	void amplitude(float n) {
+		if (n < 0.0f)
+			n = 0;
+		else if (n > 1.0f)
+			n = 1.0f;
+		magnitude = n;
+	}
+	void update(const audio_block_t* modinput, audio_block_t* block) {
+		if (!block) {
+			return;
+		}
+
+		// at each edge the output takes the fraction of the sample before the edge at the old level, and the rest
+		// at the new one
+		float _elapsed = elapsed;
+		float _magnitude = magnitude;
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			_elapsed += 1.f;
+			float dur = duration;
+			if (modinput) {
+				// -1 to +1 scales the half cycle (of the current polarity) from 0 to twice its length
+				dur *= 1.f + ((_magnitude < 0.f) ? -modinput->data[i] : modinput->data[i]);
+			}
+			if (_elapsed < dur) {
+				block->data[i] = _magnitude;
+			}
+			else {
+				// elapsed must be 0 to 1
+				_elapsed = clamp(_elapsed - dur, 0.f, 1.f);
+				block->data[i] = _magnitude - 2.f * _magnitude * _elapsed;
+				_magnitude = -_magnitude;
+			}
+		}
+		elapsed = _elapsed;
+		magnitude = _magnitude;
+	}
+private:
+	float duration = 0.f; // samples per half cycle (when 50% duty)
+	float magnitude = 0.f;
+	float elapsed = 0.f;
+};
+
+} // namespace teensyfloat
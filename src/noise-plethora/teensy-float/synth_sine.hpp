@@ -0,0 +1,136 @@
+#pragma once
+
+#include "audio_core.hpp"
+
+namespace teensyfloat {
+
+// a * sin(2 pi x) for a block of phase accumulator values, as cos(2 pi (x - 1/4))
+inline void renderSine(const uint32_t* phases, float amplitude, float* out) {
+	float turns[AUDIO_BLOCK_SAMPLES];
+	for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		turns[i] = (int32_t) phases[i] * PHASE_TO_TURNS - 0.25f;
+	}
+	cos2pi_fast(turns, out, AUDIO_BLOCK_SAMPLES);
+	for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		out[i] *= amplitude;
+	}
+}
+
+class AudioSynthWaveformSine : public AudioStream {
+public:
+	AudioSynthWaveformSine() : AudioStream(0), magnitude(16384) {}
+	void frequency(float freq) {
+
+		// for reproducibility, max frequency cuts out at 1/2 Teensy sample rate
+		// (unless we're running at very low sample rates, in which case use those to limit range)
+		const float maxFrequency = std::min(AUDIO_SAMPLE_RATE_EXACT, APP->engine->getSampleRate()) / 2.0f;
+
+		if (freq < 0.0f)
+			freq = 0.0;
+		else if (freq > maxFrequency)
+			freq = maxFrequency;
+		phase_increment = freq * (4294967296.0f / APP->engine->getSampleRate());
+	}
+	void phase(float angle) {
+		if (angle < 0.0f)
+			angle = 0.0f;
+		else if (angle > 360.0f) {
+			angle = angle - 360.0f;
+			if (angle >= 360.0f)
+				return;
+		}
+		phase_accumulator = angle * (float)(4294967296.0 / 360.0);
+	}
+	void amplitude(float n) {
+		if (n < 0.0f)
+			n = 0;
+		else if (n > 1.0f)
+			n = 1.0f;
+		magnitude = n * 65536.0f;
+	}
+	void update(audio_block_t* block) {
+		if (magnitude && block) {
+			uint32_t phases[AUDIO_BLOCK_SAMPLES];
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				phases[i] = phase_accumulator + i * phase_increment;
+			}
+			renderSine(phases, magnitude * (1.f / 65536.f), block->data);
+		}
+		phase_accumulator += phase_increment * AUDIO_BLOCK_SAMPLES;
+	}
+private:
+	uint32_t phase_accumulator = 0;
+	uint32_t phase_increment = 0;
+	int32_t magnitude = 0;
+};
+
+
+class AudioSynthWaveformSineModulated : public AudioStream {
+public:
+	AudioSynthWaveformSineModulated() : AudioStream(1), magnitude(16384) {}
+	// maximum unmodulated carrier frequency is 11025 Hz
+	// input = +1.0 doubles carrier
+	// input = -1.0 DC output
+	void frequency(float freq) {
+
+		// for reproducibility, max frequency cuts out at 1/4 Teensy sample rate
+		// (unless we're running at very low sample rates, in which case use those to limit range)
+		const float maxFrequency = std::min(AUDIO_SAMPLE_RATE_EXACT, APP->engine->getSampleRate()) / 4.0f;
+
+		if (freq < 0.0f)
+			freq = 0.0f;
+		else if (freq > maxFrequency)
+			freq = maxFrequency;
+		phase_increment = freq * (4294967296.0f / APP->engine->getSampleRate());
+	}
+	void phase(float angle) {
+		if (angle < 0.0f)
+			angle = 0.0;
+		else if (angle > 360.0f) {
+			angle = angle - 360.0f;
+			if (angle >= 360.0f)
+				return;
+		}
+		phase_accumulator = angle * (float)(4294967296.0 / 360.0);
+	}
+
+	void amplitude(float n) {
+		if (n < 0.0f)
+			n = 0;
+		else if (n > 1.0f)
+			n = 1.0f;
+		magnitude = n * 65536.0f;
+	}
+
+	void update(const audio_block_t* modinput, audio_block_t* block) {
+		if (!block) {
+			return;
+		}
+
+		uint32_t phases[AUDIO_BLOCK_SAMPLES];
+		uint32_t ph = phase_accumulator;
+		const uint32_t inc = phase_increment;
+		if (modinput) {
+			// -1 = no phase increment, +1 = double phase increment (below 2^31, as inc is at most 2^30)
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				phases[i] = ph;
+				ph += (uint32_t)(int32_t)(inc * (1.f + modinput->data[i]));
+			}
+		}
+		else {
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				phases[i] = ph + i * inc;
+			}
+			ph += inc * AUDIO_BLOCK_SAMPLES;
+		}
+		phase_accumulator = ph;
+
+		renderSine(phases, magnitude * (1.f / 65536.f), block->data);
+	}
+private:
+	uint32_t phase_accumulator = 0;
+	uint32_t phase_increment = 0;
+	int32_t magnitude = 0;
+};
+
+} // namespace teensyfloat
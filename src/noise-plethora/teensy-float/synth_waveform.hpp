@@ -0,0 +1,410 @@
+#pragma once
+
+#include "audio_core.hpp"
+#include "synth_sine.hpp"
+
+namespace teensyfloat {
+
+/** Renders a waveform shared by AudioSynthWaveform and AudioSynthWaveformModulated at precomputed phase accumulator
+ values. The pulse width (also the width of WAVEFORM_TRIANGLE_VARIABLE) is per sample if `widths` is given, otherwise
+ `pulse_width`. Sample & hold depends on the phase history, so the callers render it themselves. */
+inline void renderWaveform(short tone_type, const uint32_t* phases, int32_t magnitude, uint32_t pulse_width,
+                           const uint32_t* widths, const int16_t* arbdata, float* out) {
+	const float amplitude = magnitude * (1.f / 65536.f);
+
+	switch (tone_type) {
+		case WAVEFORM_SINE:
+			renderSine(phases, amplitude, out);
+			break;
+
+		case WAVEFORM_ARBITRARY: {
+			// len = 256
+			const float scale = amplitude * (1.f / 32767.f);
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				const uint32_t index = phases[i] >> 24;
+				const float val1 = arbdata[index];
+				const float val2 = arbdata[(index + 1) & 0xFF];
+				const float frac = (phases[i] & 0xFFFFFF) * (1.f / 16777216.f);
+				out[i] = scale * (val1 + frac * (val2 - val1));
+			}
+		} break;
+
+		case WAVEFORM_SQUARE:
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				out[i] = (phases[i] & 0x80000000) ? -amplitude : amplitude;
+			}
+			break;
+
+		case WAVEFORM_SAWTOOTH:
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				out[i] = 2.f * amplitude * ((int32_t) phases[i] * PHASE_TO_TURNS);
+			}
+			break;
+
+		case WAVEFORM_SAWTOOTH_REVERSE:
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				out[i] = -2.f * amplitude * ((int32_t) phases[i] * PHASE_TO_TURNS);
+			}
+			break;
+
+		case WAVEFORM_TRIANGLE:
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				// rising through [-1, 1] over the middle half of the signed phase, falling back at either end
+				const float s = 4.f * ((int32_t) phases[i] * PHASE_TO_TURNS);
+				const float folded = (s > 0.f ? 2.f : -2.f) - s;
+				out[i] = amplitude * (std::fabs(s) <= 1.f ? s : folded);
+			}
+			break;
+
+		case WAVEFORM_TRIANGLE_VARIABLE:
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				// rises over the first and last width / 2 of the cycle, falls in between
+				const float width = clamp((widths ? widths[i] : pulse_width) * PHASE_TO_TURNS, 1.f / 65536.f, 1.f - 1.f / 65536.f);
+				const float x = phases[i] * PHASE_TO_TURNS;
+				float y;
+				if (x < 0.5f * width) {
+					y = 2.f * x / width;
+				}
+				else if (x < 1.f - 0.5f * width) {
+					y = 1.f - 2.f * (x - 0.5f * width) / (1.f - width);
+				}
+				else {
+					y = 2.f * (x - 1.f) / width;
+				}
+				out[i] = amplitude * y;
+			}
+			break;
+
+		case WAVEFORM_PULSE:
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				out[i] = (phases[i] < (widths ? widths[i] : pulse_width)) ? amplitude : -amplitude;
+			}
+			break;
+	}
+}
+
+// pulse widths for the shape input of AudioSynthWaveformModulated, as the int16 engine derives them
+inline void shapeToWidths(const audio_block_t* shapedata, uint32_t* widths) {
+	for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		widths[i] = (((int32_t)(shapedata->data[i] * 32767.f) + 0x8000) & 0xFFFF) << 16;
+	}
+}
+
+inline void applyOffset(audio_block_t* block, float tone_offset) {
+	for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		block->data[i] = clampSample(block->data[i] + tone_offset);
+	}
+}
+
+class AudioSynthWaveform : public AudioStream {
+public:
+	AudioSynthWaveform(void) : AudioStream(0),
+		phase_accumulator(0), phase_increment(0), phase_offset(0),
+		magnitude(0), pulse_width(0x40000000),
+		arbdata(NULL), sample(0), tone_type(WAVEFORM_SINE),
+		tone_offset(0) {
+	}
+
+	void frequency(float freq) {
+
+		// for reproducibility, max frequency cuts out at 1/2 Teensy sample rate
+		// (unless we're running at very low sample rates, in which case use those to limit range)
+		const float maxFrequency = std::min(AUDIO_SAMPLE_RATE_EXACT, APP->engine->getSampleRate()) / 2.0f;
+
+		if (freq < 0.0f) {
+			freq = 0.0;
+		}
+		else if (freq > maxFrequency) {
+			freq = maxFrequency;
+		}
+		phase_increment = freq * (4294967296.0f / APP->engine->getSampleRate());
+		if (phase_increment > 0x7FFE0000u)
+			phase_increment = 0x7FFE0000;
+	}
+	void phase(float angle) {
+		if (angle < 0.0f) {
+			angle = 0.0;
+		}
+		else if (angle > 360.0f) {
+			angle = angle - 360.0f;
+			if (angle >= 360.0f)
+				return;
+		}
+		phase_offset = angle * (float)(4294967296.0 / 360.0);
+	}
+	void amplitude(float n) {	// 0 to 1.0
+		if (n < 0) {
+			n = 0;
+		}
+		else if (n > 1.0f) {
+			n = 1.0;
+		}
+		magnitude = n * 65536.0f;
+	}
+	void offset(float n) {
+		if (n < -1.0f) {
+			n = -1.0f;
+		}
+		else if (n > 1.0f) {
+			n = 1.0f;
+		}
+		tone_offset = n;
+	}
+	void pulseWidth(float n) {	// 0.0 to 1.0
+		if (n < 0) {
+			n = 0;
+		}
+		else if (n > 1.0f) {
+			n = 1.0f;
+		}
+		pulse_width = n * 4294967296.0f;
+	}
+	void begin(short t_type) {
+		phase_offset = 0;
+		tone_type = t_type;
+	}
+	void begin(float t_amp, float t_freq, short t_type) {
+		amplitude(t_amp);
+		frequency(t_freq);
+		phase_offset = 0;
+		begin(t_type);
+	}
+
+	void arbitraryWaveform(const int16_t* data, float maxFreq) {
+		arbdata = data;
+	}
+
+	void update(audio_block_t* block) {
+		const uint32_t inc = phase_increment;
+		uint32_t ph = phase_accumulator + phase_offset;
+
+		if (magnitude == 0 || !block || (tone_type == WAVEFORM_ARBITRARY && !arbdata)) {
+			phase_accumulator += inc * AUDIO_BLOCK_SAMPLES;
+			return;
+		}
+
+		if (tone_type == WAVEFORM_SAMPLE_HOLD) {
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				block->data[i] = sample;
+				uint32_t newph = ph + inc;
+				if (newph < ph) {
+					sample = (int16_t)(teensy::random_teensy(magnitude) - (magnitude >> 1)) * (1.f / 32767.f);
+				}
+				ph = newph;
+			}
+		}
+		else {
+			uint32_t phases[AUDIO_BLOCK_SAMPLES];
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				phases[i] = ph + i * inc;
+			}
+			ph += inc * AUDIO_BLOCK_SAMPLES;
+			renderWaveform(tone_type, phases, magnitude, pulse_width, NULL, arbdata, block->data);
+		}
+		phase_accumulator = ph - phase_offset;
+
+		if (tone_offset) {
+			applyOffset(block, tone_offset);
+		}
+	}
+
+private:
+	uint32_t phase_accumulator = 0;
+	uint32_t phase_increment = 0;
+	uint32_t phase_offset = 0;
+	int32_t  magnitude = 0;
+	uint32_t pulse_width = 0;
+	const int16_t* arbdata = nullptr;
+	float    sample = 0.f; // for WAVEFORM_SAMPLE_HOLD
+	short    tone_type = 0;
+	float    tone_offset = 0.f;
+};
+
+class AudioSynthWaveformModulated : public AudioStream {
+public:
+	AudioSynthWaveformModulated(void) : AudioStream(2),
+		phase_accumulator(0), phase_increment(0), modulation_factor(32768),
+		magnitude(0), arbdata(NULL), sample(0), tone_offset(0),
+		tone_type(WAVEFORM_SINE), modulation_type(0) {
+	}
+
+	void frequency(float freq) {
+
+		// for reproducibility, max frequency cuts out at 1/2 Teensy sample rate
+		// (unless we're running at very low sample rates, in which case use those to limit range)
+		const float maxFrequency = std::min(AUDIO_SAMPLE_RATE_EXACT, APP->engine->getSampleRate()) / 2.0f;
+
+		if (freq < 0.0f) {
+			freq = 0.0;
+		}
+		else if (freq > maxFrequency) {
+			freq = maxFrequency;
+		}
+		phase_increment = freq * (4294967296.0f / APP->engine->getSampleRate());
+		if (phase_increment > 0x7FFE0000u)
+			phase_increment = 0x7FFE0000;
+	}
+	void amplitude(float n) {	// 0 to 1.0
+		if (n < 0) {
+			n = 0;
+		}
+		else if (n > 1.0f) {
+			n = 1.0f;
+		}
+		magnitude = n * 65536.0f;
+	}
+	void offset(float n) {
+		if (n < -1.0f) {
+			n = -1.0f;
+		}
+		else if (n > 1.0f) {
+			n = 1.0f;
+		}
+		tone_offset = n;
+	}
+	void begin(short t_type) {
+		tone_type = t_type;
+		// band-limited waveforms not used
+	}
+	void begin(float t_amp, float t_freq, short t_type) {
+		amplitude(t_amp);
+		frequency(t_freq);
+		begin(t_type) ;
+	}
+	void arbitraryWaveform(const int16_t* data, float maxFreq) {
+		arbdata = data;
+	}
+	void frequencyModulation(float octaves) {
+		if (octaves > 12.0f) {
+			octaves = 12.0f;
+		}
+		else if (octaves < 0.1f) {
+			octaves = 0.1f;
+		}
+		modulation_factor = octaves * 4096.0f;
+		modulation_type = 0;
+	}
+	void phaseModulation(float degrees) {
+		if (degrees > 9000.0f) {
+			degrees = 9000.0f;
+		}
+		else if (degrees < 30.0f) {
+			degrees = 30.0f;
+		}
+		modulation_factor = degrees * (float)(65536.0 / 180.0);
+		modulation_type = 1;
+	}
+
+	void update(audio_block_t* moddata, audio_block_t* shapedata, audio_block_t* block) {
+		const uint32_t inc = phase_increment;
+
+		if (!block) {
+			return;
+		}
+
+		// Pre-compute the phase angle for every output sample of this update
+		uint32_t ph = phase_accumulator;
+		uint32_t priorphase = phasedata[AUDIO_BLOCK_SAMPLES - 1];
+		if (moddata && modulation_type == 0) {
+			// Frequency Modulation: the increment times 2^(modulation * octaves), up to the same maximum step
+			float octaves[AUDIO_BLOCK_SAMPLES], scale[AUDIO_BLOCK_SAMPLES];
+			const float octavesPerUnit = modulation_factor * (1.f / 4096.f);
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				octaves[i] = moddata->data[i] * octavesPerUnit;
+			}
+			exp2_fast(octaves, scale, AUDIO_BLOCK_SAMPLES);
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				const float phstep = inc * scale[i];
+				ph += (phstep < (float) 0x7FFE0000) ? (uint32_t)(int32_t) phstep : 0x7FFE0000u;
+				phasedata[i] = ph;
+			}
+		}
+		else if (moddata) {
+			// Phase Modulation
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				// more than +/- 180 deg shift by 32 bit overflow of "n"
+				const uint32_t n = ((uint32_t)(int32_t)(moddata->data[i] * 32767.f)) * modulation_factor;
+				phasedata[i] = ph + i * inc + n;
+			}
+			ph += inc * AUDIO_BLOCK_SAMPLES;
+		}
+		else {
+			// No Modulation Input
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				phasedata[i] = ph + i * inc;
+			}
+			ph += inc * AUDIO_BLOCK_SAMPLES;
+		}
+		phase_accumulator = ph;
+
+		// Now generate the output samples using the pre-computed phase angles
+		uint32_t widths[AUDIO_BLOCK_SAMPLES];
+		switch (tone_type) {
+			case WAVEFORM_ARBITRARY:
+				if (!arbdata) {
+					block->zeroAudioBlock();
+					return;
+				}
+				renderWaveform(tone_type, phasedata, magnitude, 0, NULL, arbdata, block->data);
+				break;
+
+			case WAVEFORM_PULSE:
+				// without shape modulation an ordinary square
+				if (shapedata) {
+					shapeToWidths(shapedata, widths);
+					renderWaveform(WAVEFORM_PULSE, phasedata, magnitude, 0, widths, NULL, block->data);
+				}
+				else {
+					renderWaveform(WAVEFORM_SQUARE, phasedata, magnitude, 0, NULL, NULL, block->data);
+				}
+				break;
+
+			case WAVEFORM_TRIANGLE_VARIABLE:
+				// without shape modulation an ordinary triangle
+				if (shapedata) {
+					shapeToWidths(shapedata, widths);
+					renderWaveform(WAVEFORM_TRIANGLE_VARIABLE, phasedata, magnitude, 0, widths, NULL, block->data);
+				}
+				else {
+					renderWaveform(WAVEFORM_TRIANGLE, phasedata, magnitude, 0, NULL, NULL, block->data);
+				}
+				break;
+
+			case WAVEFORM_SAMPLE_HOLD:
+				for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+					ph = phasedata[i];
+					if (ph < priorphase) { // does not work for phase modulation
+						sample = (int16_t)(teensy::random_teensy(magnitude) - (magnitude >> 1)) * (1.f / 32767.f);
+					}
+					priorphase = ph;
+					block->data[i] = sample;
+				}
+				break;
+
+			default:
+				renderWaveform(tone_type, phasedata, magnitude, 0, NULL, NULL, block->data);
+				break;
+		}
+
+		if (tone_offset) {
+			applyOffset(block, tone_offset);
+		}
+	}
+
+private:
+
+	uint32_t phase_accumulator = 0;
+	uint32_t phase_increment = 0;
+	uint32_t modulation_factor = 0;
+	int32_t  magnitude = 0;
+	const int16_t* arbdata = nullptr;
+	uint32_t phasedata[AUDIO_BLOCK_SAMPLES] = {};
+
+	float    sample = 0.f; // for WAVEFORM_SAMPLE_HOLD
+	float    tone_offset = 0.f;
+	uint8_t  tone_type = 0;
+	uint8_t  modulation_type = 0;
+
+};
+
+} // namespace teensyfloat
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "synth_waveform.hpp"
+
+namespace teensyfloat {
+
+/** Up to 16 AudioSynthWaveformModulated oscillators sharing a waveform and amplitude, summed with unity gain in
+ groups of four by four mixers and then by a fifth mixer, as the cluster algorithms wire them.
+
+ The oscillators' state is stored across the partials rather than per object: float_4 g holds the four partials of
+ group g, so a group is rendered at once and a bank of n partials costs ceil(n / 4) passes over the block. The
+ mixers then saturate after each input like AudioMixer4. Sample & hold and arbitrary waveforms aren't supported
+ and render silence. */
+class AudioSynthWaveformBank : public AudioStream {
+public:
+	static const int MAX_PARTIALS = 16;
+
+	AudioSynthWaveformBank(void) : AudioStream(2), magnitude(0), numPartials(0), tone_type(WAVEFORM_SINE) {
+	}
+
+	/** Uses the first `n` partials, all with the same amplitude (0 to 1.0) and waveform */
+	void begin(int n, float t_amp, short t_type) {
+		numPartials = clamp(n, 0, MAX_PARTIALS);
+		if (t_amp < 0) {
+			t_amp = 0;
+		}
+		else if (t_amp > 1.0f) {
+			t_amp = 1.0f;
+		}
+		magnitude = t_amp * 65536.0f;
+		tone_type = t_type;
+	}
+
+	void frequency(int partial, float freq) {
+		if (partial < 0 || partial >= numPartials) {
+			return;
+		}
+
+		// for reproducibility, max frequency cuts out at 1/2 Teensy sample rate
+		// (unless we're running at very low sample rates, in which case use those to limit range)
+		const float maxFrequency = std::min(AUDIO_SAMPLE_RATE_EXACT, APP->engine->getSampleRate()) / 2.0f;
+
+		if (freq < 0.0f) {
+			freq = 0.0;
+		}
+		else if (freq > maxFrequency) {
+			freq = maxFrequency;
+		}
+		uint32_t phase_increment = freq * (4294967296.0f / APP->engine->getSampleRate());
+		if (phase_increment > 0x7FFE0000u)
+			phase_increment = 0x7FFE0000;
+		increments[partial / 4].s[partial % 4] = (int32_t) phase_increment;
+	}
+
+	/** Frequency modulation of every partial by the same input (8 octaves full scale), and the shape input that
+	 sets the width of WAVEFORM_PULSE and WAVEFORM_TRIANGLE_VARIABLE */
+	void update(const audio_block_t* moddata, const audio_block_t* shapedata, audio_block_t* out) {
+		if (!out) {
+			return;
+		}
+		prepare(shapedata, out);
+
+		float scale[AUDIO_BLOCK_SAMPLES];
+		if (moddata) {
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				scale[i] = moddata->data[i] * 8.f;
+			}
+			exp2_fast(scale, scale, AUDIO_BLOCK_SAMPLES);
+		}
+
+		simd::int32_4 phasedata[AUDIO_BLOCK_SAMPLES];
+		for (int group = 0; group < numGroups(); group++) {
+			simd::int32_4 ph = phases[group];
+			if (moddata) {
+				const simd::float_4 inc = simd::float_4(increments[group]);
+				for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+					ph = ph + modulatedStep(inc * scale[i]);
+					phasedata[i] = ph;
+				}
+			}
+			else {
+				for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+					phasedata[i] = ph;
+					ph = ph + increments[group];
+				}
+			}
+			phases[group] = ph;
+			render(group, phasedata, shapedata != NULL, out);
+		}
+	}
+
+	/** Frequency modulation of each partial by its own input, `moddata` points to one block per partial */
+	void updatePerPartial(const audio_block_t* moddata, const audio_block_t* shapedata, audio_block_t* out) {
+		if (!out) {
+			return;
+		}
+		prepare(shapedata, out);
+
+		simd::int32_4 phasedata[AUDIO_BLOCK_SAMPLES];
+		simd::float_4 scale[AUDIO_BLOCK_SAMPLES];
+		for (int group = 0; group < numGroups(); group++) {
+			// the group's modulation side by side, then 2^octaves in one block
+			for (int lane = 0; lane < 4; lane++) {
+				const int partial = 4 * group + lane;
+				for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+					scale[i].s[lane] = (partial < numPartials) ? moddata[partial].data[i] * 8.f : 0.f;
+				}
+			}
+			exp2_fast(fastmath::asFloats(scale), fastmath::asFloats(scale), 4 * AUDIO_BLOCK_SAMPLES);
+
+			const simd::float_4 inc = simd::float_4(increments[group]);
+			simd::int32_4 ph = phases[group];
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				ph = ph + modulatedStep(inc * scale[i]);
+				phasedata[i] = ph;
+			}
+			phases[group] = ph;
+			render(group, phasedata, shapedata != NULL, out);
+		}
+	}
+
+private:
+
+	int numGroups() const {
+		return (numPartials + 3) / 4;
+	}
+
+	// the increment times 2^(modulation * octaves), up to the same maximum step as AudioSynthWaveformModulated
+	static simd::int32_4 modulatedStep(simd::float_4 phstep) {
+		return simd::int32_4(simd::fmin(phstep, simd::float_4((float) 0x7FFE0000)));
+	}
+
+	// clears the output mixer, and converts the shape input to pulse widths in unsigned turns as shapeToWidths()
+	void prepare(const audio_block_t* shapedata, audio_block_t* out) {
+		out->zeroAudioBlock();
+		if (shapedata) {
+			for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				widths[i] = (uint32_t)((((int32_t)(shapedata->data[i] * 32767.f) + 0x8000) & 0xFFFF) << 16) * PHASE_TO_TURNS;
+			}
+		}
+	}
+
+	// a group of partials at the given phases through its mixer, then added to the output mixer
+	void render(int group, const simd::int32_4* phasedata, bool shaped, audio_block_t* out) {
+		// partials past the end are silent, as if their mixer input weren't connected
+		simd::float_4 amplitude = 0.f;
+		for (int lane = 0; lane < 4; lane++) {
+			if (4 * group + lane < numPartials) {
+				amplitude.s[lane] = magnitude * (1.f / 65536.f);
+			}
+		}
+
+		switch (tone_type) {
+			case WAVEFORM_SINE:
+				renderPartials<WAVEFORM_SINE>(phasedata, amplitude);
+				break;
+			case WAVEFORM_SQUARE:
+				renderPartials<WAVEFORM_SQUARE>(phasedata, amplitude);
+				break;
+			case WAVEFORM_SAWTOOTH:
+				renderPartials<WAVEFORM_SAWTOOTH>(phasedata, amplitude);
+				break;
+			case WAVEFORM_SAWTOOTH_REVERSE:
+				renderPartials<WAVEFORM_SAWTOOTH_REVERSE>(phasedata, amplitude);
+				break;
+			case WAVEFORM_TRIANGLE:
+				renderPartials<WAVEFORM_TRIANGLE>(phasedata, amplitude);
+				break;
+			case WAVEFORM_TRIANGLE_VARIABLE:
+				// without shape modulation an ordinary triangle
+				if (shaped) {
+					renderPartials<WAVEFORM_TRIANGLE_VARIABLE>(phasedata, amplitude);
+				}
+				else {
+					renderPartials<WAVEFORM_TRIANGLE>(phasedata, amplitude);
+				}
+				break;
+			case WAVEFORM_PULSE:
+				// without shape modulation an ordinary square
+				if (shaped) {
+					renderPartials<WAVEFORM_PULSE>(phasedata, amplitude);
+				}
+				else {
+					renderPartials<WAVEFORM_SQUARE>(phasedata, amplitude);
+				}
+				break;
+			default:
+				renderPartials<WAVEFORM_SAMPLE_HOLD>(phasedata, 0.f);
+				break;
+		}
+
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			float mix = 0.f;
+			for (int lane = 0; lane < 4; lane++) {
+				mix = clampSample(mix + rendered[i].s[lane]);
+			}
+			out->data[i] = clampSample(out->data[i] + mix);
+		}
+	}
+
+	template <short TYPE>
+	void renderPartials(const simd::int32_4* phasedata, simd::float_4 amplitude) {
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			// signed turns in [-0.5, 0.5)
+			const simd::float_4 x = simd::float_4(phasedata[i]) * PHASE_TO_TURNS;
+			simd::float_4 y;
+			switch (TYPE) {
+				case WAVEFORM_SINE:
+					y = cos2pi_fast<simd::float_4>(x - 0.25f);
+					break;
+				case WAVEFORM_SQUARE:
+					y = simd::ifelse(x < 0.f, -1.f, 1.f);
+					break;
+				case WAVEFORM_SAWTOOTH:
+					y = 2.f * x;
+					break;
+				case WAVEFORM_SAWTOOTH_REVERSE:
+					y = -2.f * x;
+					break;
+				case WAVEFORM_TRIANGLE: {
+					// rising through [-1, 1] over the middle half of the signed phase, falling back at either end
+					const simd::float_4 s = 4.f * x;
+					const simd::float_4 folded = simd::ifelse(s > 0.f, 2.f, -2.f) - s;
+					y = simd::ifelse(simd::fabs(s) <= 1.f, s, folded);
+				} break;
+				case WAVEFORM_TRIANGLE_VARIABLE: {
+					// rises over the first and last width / 2 of the cycle, falls in between
+					const float width = clamp(widths[i], 1.f / 65536.f, 1.f - 1.f / 65536.f);
+					const simd::float_4 u = simd::ifelse(x < 0.f, x + 1.f, x);
+					const simd::float_4 rise = (2.f / width) * simd::ifelse(u < 0.5f, u, u - 1.f);
+					const simd::float_4 fall = 1.f - (2.f / (1.f - width)) * (u - 0.5f * width);
+					y = simd::ifelse((u < 0.5f * width) | (u >= 1.f - 0.5f * width), rise, fall);
+				} break;
+				case WAVEFORM_PULSE: {
+					const simd::float_4 u = simd::ifelse(x < 0.f, x + 1.f, x);
+					y = simd::ifelse(u < widths[i], 1.f, -1.f);
+				} break;
+				default:
+					y = 0.f;
+					break;
+			}
+			rendered[i] = amplitude * y;
+		}
+	}
+
+	simd::int32_4 phases[MAX_PARTIALS / 4] = {};
+	simd::int32_4 increments[MAX_PARTIALS / 4] = {};
+	simd::float_4 rendered[AUDIO_BLOCK_SAMPLES];
+	float widths[AUDIO_BLOCK_SAMPLES] = {};
+	int32_t magnitude = 0;
+	int numPartials = 0;
+	short tone_type = 0;
+};
+
+} // namespace teensyfloat
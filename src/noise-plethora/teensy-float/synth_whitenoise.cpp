@@ -0,0 +1,29 @@
+#include "synth_whitenoise.hpp"
+
+namespace teensyfloat {
+
+// Park-Miller-Carta Pseudo-Random Number Generator, as in the int16 engine
+// http://www.firstpr.com.au/dsp/rand31/
+
+void AudioSynthNoiseWhite::update(audio_block_t* block) {
+	if (level == 0 || !block) {
+		return;
+	}
+
+	// the low 16 bits of each value as a signed sample
+	const float gain = level * (1.f / (65536.f * 32767.f));
+	uint32_t lo = seed;
+	for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		uint32_t hi = 16807 * (lo >> 16);
+		lo = 16807 * (lo & 0xFFFF);
+		lo += (hi & 0x7FFF) << 16;
+		lo += hi >> 15;
+		lo = (lo & 0x7FFFFFFF) + (lo >> 31);
+		block->data[i] = gain * (int16_t) lo;
+	}
+	seed = lo;
+}
+
+uint16_t AudioSynthNoiseWhite::instance_count = 0;
+
+} // namespace teensyfloat
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "audio_core.hpp"
+
+namespace teensyfloat {
+
+class AudioSynthNoiseWhite : public AudioStream {
+public:
+	AudioSynthNoiseWhite() : AudioStream(0) {
+		level = 0;
+		seed = 1 + instance_count++;
+	}
+	void amplitude(float n) {
+		if (n < 0.0f)
+			n = 0.0;
+		else if (n > 1.0f)
+			n = 1.0f;
+		level = (int32_t)(n * 65536.0f);
+	}
+	void update(audio_block_t* block);
+private:
+	int32_t  level = 0; // 0=off, 65536=max
+	uint32_t seed = 0;  // must start at 1
+	static uint16_t instance_count;
+};
+
+} // namespace teensyfloat
@@ -52,7 +52,7 @@ public:
 	virtual void update(const audio_block_t* inputBlock, audio_block_t* block);
 
 private:
-	uint8_t crushBits; // 16 = off
-	uint8_t sampleStep; // the number of samples to double up. This simple technique only allows a few stepped positions.
+	uint8_t crushBits = 0; // 16 = off
+	uint8_t sampleStep = 0; // the number of samples to double up. This simple technique only allows a few stepped positions.
 };
 
@@ -49,5 +49,5 @@ public:
 	}
 	virtual void update(const audio_block_t* blocka, const audio_block_t* blockb, audio_block_t* output);
 private:
-	short mode_sel;
+	short mode_sel = 0;
 };
@@ -43,11 +43,11 @@ public:
 
 private:
 
-	short* l_delayline;
-	int delay_length;
-	short l_circ_idx;
-	int delay_depth;
-	int delay_offset_idx;
-	int   delay_rate_incr;
-	unsigned int l_delay_rate_index;
+	short* l_delayline = nullptr;
+	int delay_length = 0;
+	short l_circ_idx = 0;
+	int delay_depth = 0;
+	int delay_offset_idx = 0;
+	int   delay_rate_incr = 0;
+	unsigned int l_delay_rate_index = 0;
 };
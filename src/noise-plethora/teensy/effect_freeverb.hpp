@@ -52,39 +52,39 @@ public:
 		//__enable_irq();
 	}
 private:
-	int16_t comb1buf[1116];
-	int16_t comb2buf[1188];
-	int16_t comb3buf[1277];
-	int16_t comb4buf[1356];
-	int16_t comb5buf[1422];
-	int16_t comb6buf[1491];
-	int16_t comb7buf[1557];
-	int16_t comb8buf[1617];
-	uint16_t comb1index;
-	uint16_t comb2index;
-	uint16_t comb3index;
-	uint16_t comb4index;
-	uint16_t comb5index;
-	uint16_t comb6index;
-	uint16_t comb7index;
-	uint16_t comb8index;
-	int16_t comb1filter;
-	int16_t comb2filter;
-	int16_t comb3filter;
-	int16_t comb4filter;
-	int16_t comb5filter;
-	int16_t comb6filter;
-	int16_t comb7filter;
-	int16_t comb8filter;
-	int16_t combdamp1;
-	int16_t combdamp2;
-	int16_t combfeeback;
-	int16_t allpass1buf[556];
-	int16_t allpass2buf[441];
-	int16_t allpass3buf[341];
-	int16_t allpass4buf[225];
-	uint16_t allpass1index;
-	uint16_t allpass2index;
-	uint16_t allpass3index;
-	uint16_t allpass4index;
+	int16_t comb1buf[1116] = {};
+	int16_t comb2buf[1188] = {};
+	int16_t comb3buf[1277] = {};
+	int16_t comb4buf[1356] = {};
+	int16_t comb5buf[1422] = {};
+	int16_t comb6buf[1491] = {};
+	int16_t comb7buf[1557] = {};
+	int16_t comb8buf[1617] = {};
+	uint16_t comb1index = 0;
+	uint16_t comb2index = 0;
+	uint16_t comb3index = 0;
+	uint16_t comb4index = 0;
+	uint16_t comb5index = 0;
+	uint16_t comb6index = 0;
+	uint16_t comb7index = 0;
+	uint16_t comb8index = 0;
+	int16_t comb1filter = 0;
+	int16_t comb2filter = 0;
+	int16_t comb3filter = 0;
+	int16_t comb4filter = 0;
+	int16_t comb5filter = 0;
+	int16_t comb6filter = 0;
+	int16_t comb7filter = 0;
+	int16_t comb8filter = 0;
+	int16_t combdamp1 = 0;
+	int16_t combdamp2 = 0;
+	int16_t combfeeback = 0;
+	int16_t allpass1buf[556] = {};
+	int16_t allpass2buf[441] = {};
+	int16_t allpass3buf[341] = {};
+	int16_t allpass4buf[225] = {};
+	uint16_t allpass1index = 0;
+	uint16_t allpass2index = 0;
+	uint16_t allpass3index = 0;
+	uint16_t allpass4index = 0;
 };
\ No newline at end of file
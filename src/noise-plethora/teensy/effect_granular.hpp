@@ -59,19 +59,19 @@ private:
 	void beginFreeze_int(int grain_samples);
 	void beginPitchShift_int(int grain_samples);
 
-	int16_t* sample_bank;
-	uint32_t playpack_rate;
-	uint32_t accumulator;
-	int16_t max_sample_len;
-	int16_t write_head;
-	int16_t read_head;
-	int16_t grain_mode;
-	int16_t freeze_len;
-	int16_t prev_input;
-	int16_t glitch_len;
-	bool allow_len_change;
-	bool sample_loaded;
-	bool write_en;
-	bool sample_req;
+	int16_t* sample_bank = nullptr;
+	uint32_t playpack_rate = 0;
+	uint32_t accumulator = 0;
+	int16_t max_sample_len = 0;
+	int16_t write_head = 0;
+	int16_t read_head = 0;
+	int16_t grain_mode = 0;
+	int16_t freeze_len = 0;
+	int16_t prev_input = 0;
+	int16_t glitch_len = 0;
+	bool allow_len_change = false;
+	bool sample_loaded = false;
+	bool write_en = false;
+	bool sample_req = false;
 };
 
@@ -98,11 +98,11 @@ public:
 private:
 	void update_fixed(const int16_t* in, int16_t* lp, int16_t* bp, int16_t* hp);
 	void update_variable(const int16_t* in, const int16_t* ctl, int16_t* lp, int16_t* bp, int16_t* hp);
-	int32_t setting_fcenter;
-	int32_t setting_fmult;
-	int32_t setting_octavemult;
-	int32_t setting_damp;
-	int32_t state_inputprev;
-	int32_t state_lowpass;
-	int32_t state_bandpass;
+	int32_t setting_fcenter = 0;
+	int32_t setting_fmult = 0;
+	int32_t setting_octavemult = 0;
+	int32_t setting_damp = 0;
+	int32_t state_inputprev = 0;
+	int32_t state_lowpass = 0;
+	int32_t state_bandpass = 0;
 };
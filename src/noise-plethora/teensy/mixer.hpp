@@ -97,7 +97,7 @@ public:
 		multiplier[channel] = gain * 256.0f; // TODO: proper roundoff?
 	}
 private:
-	int16_t multiplier[4];	
+	int16_t multiplier[4] = {};	
 };
 
 
@@ -136,5 +136,87 @@ public:
 		multiplier = n * 65536.0f;
 	}
 private:
-	int32_t multiplier;
-};
\ No newline at end of file
+	int32_t multiplier = 0;
+};
+
+
+/** Up to four AudioMixer4 fed by up to 16 inputs, 4 * group + channel, whose outputs are summed by a fifth mixer.
+ The whole tree is evaluated in one pass over the block, eight samples at a time with SSE saturating arithmetic, so
+ the group mixers' outputs never go through memory. Each input and each group saturates as it's added, so the output
+ is bit-identical to the chained mixers'. */
+class AudioMixerTree : public AudioStream {
+public:
+	static const int MAX_GROUPS = 4;
+	static const int MAX_INPUTS = 4 * MAX_GROUPS;
+
+	AudioMixerTree(void) : AudioStream(MAX_INPUTS) {
+		for (int i = 0; i < MAX_INPUTS; i++)
+			multiplier[i] = 256;
+		for (int group = 0; group < MAX_GROUPS; group++)
+			groupMultiplier[group] = 256;
+	}
+
+	/** Sums the first `numInputs` of the blocks at `in` */
+	void update(const audio_block_t* in, int numInputs, audio_block_t* out) {
+		if (!out) {
+			return;
+		}
+		numInputs = clamp(numInputs, 0, MAX_INPUTS);
+		const int numGroups = (numInputs + 3) / 4;
+
+		// eight samples at a time, with the sums in registers
+		for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i += 8) {
+			__m128i sum = _mm_setzero_si128();
+			for (int group = 0; group < numGroups; group++) {
+				const int end = std::min(4 * group + 4, numInputs);
+				__m128i groupSum = _mm_setzero_si128();
+				for (int input = 4 * group; input < end; input++) {
+					const __m128i x = _mm_loadu_si128((const __m128i*) &in[input].data[i]);
+					groupSum = addWithGain(groupSum, x, multiplier[input]);
+				}
+				sum = addWithGain(sum, groupSum, groupMultiplier[group]);
+			}
+			_mm_storeu_si128((__m128i*) &out->data[i], sum);
+		}
+	}
+
+	/** Gain of input `channel` into its group's mixer, as AudioMixer4::gain() */
+	void gain(unsigned int channel, float gain) {
+		if (channel >= MAX_INPUTS)
+			return;
+		multiplier[channel] = toMultiplier(gain);
+	}
+
+	/** Gain of a group's mixer into the output mixer */
+	void groupGain(unsigned int group, float gain) {
+		if (group >= MAX_GROUPS)
+			return;
+		groupMultiplier[group] = toMultiplier(gain);
+	}
+private:
+	// applyGainThenAdd() on eight samples: acc + ((x * mult) >> 8), saturated to 16 bits
+	static __m128i addWithGain(__m128i acc, __m128i x, int16_t mult) {
+		if (mult == MULTI_UNITYGAIN) {
+			return _mm_adds_epi16(acc, x);
+		}
+		const __m128i m = _mm_set1_epi16(mult);
+		const __m128i lo = _mm_mullo_epi16(x, m);
+		const __m128i hi = _mm_mulhi_epi16(x, m);
+		const __m128i x0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 8);
+		const __m128i x1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 8);
+		const __m128i acc0 = _mm_srai_epi32(_mm_unpacklo_epi16(acc, acc), 16);
+		const __m128i acc1 = _mm_srai_epi32(_mm_unpackhi_epi16(acc, acc), 16);
+		return _mm_packs_epi32(_mm_add_epi32(acc0, x0), _mm_add_epi32(acc1, x1));
+	}
+
+	static int16_t toMultiplier(float gain) {
+		if (gain > 127.0f)
+			gain = 127.0f;
+		else if (gain < -127.0f)
+			gain = -127.0f;
+		return gain * 256.0f;
+	}
+
+	int16_t multiplier[MAX_INPUTS] = {};
+	int16_t groupMultiplier[MAX_GROUPS] = {};
+};
@@ -194,8 +194,8 @@ public:
 	}
 
 private:
-	uint8_t  state;     // 0=steady output, 1=transitioning
-	int32_t  magnitude; // current output
-	int32_t  target;    // designed output (while transitiong)
-	int32_t  increment; // adjustment per sample (while transitiong)
+	uint8_t  state = 0;     // 0=steady output, 1=transitioning
+	int32_t  magnitude = 0; // current output
+	int32_t  target = 0;    // designed output (while transitiong)
+	int32_t  increment = 0; // adjustment per sample (while transitiong)
 };
@@ -50,10 +50,10 @@ private:
 	static const int32_t pfira[64];
 	static const int32_t pfirb[64];
 	static int16_t instance_cnt;
-	int32_t plfsr;		// linear feedback shift register
-	int32_t pinc;		// increment for all noise sources (bits)
-	int32_t pdec;		// decrement for all noise sources
-	int32_t paccu;		// accumulator
-	uint8_t pncnt;		// overflowing counter as index to pnmask[]
-	int32_t level;		// 0=off, 65536=max
+	int32_t plfsr = 0;		// linear feedback shift register
+	int32_t pinc = 0;		// increment for all noise sources (bits)
+	int32_t pdec = 0;		// decrement for all noise sources
+	int32_t paccu = 0;		// accumulator
+	uint8_t pncnt = 0;		// overflowing counter as index to pnmask[]
+	int32_t level = 0;		// 0=off, 65536=max
 };
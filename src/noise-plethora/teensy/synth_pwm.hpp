@@ -55,7 +55,7 @@ public:
 	}
 	virtual void update(const audio_block_t* modinput, audio_block_t* block);
 private:
-	uint32_t duration; // samples per half cycle (when 50% duty) * 65536
-	int32_t magnitude;
-	uint32_t elapsed;
+	uint32_t duration = 0; // samples per half cycle (when 50% duty) * 65536
+	int32_t magnitude = 0;
+	uint32_t elapsed = 0;
 };
\ No newline at end of file
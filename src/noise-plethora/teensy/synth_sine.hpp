@@ -90,9 +90,9 @@ public:
 		phase_accumulator += phase_increment * AUDIO_BLOCK_SAMPLES;
 	}
 private:
-	uint32_t phase_accumulator;
-	uint32_t phase_increment;
-	int32_t magnitude;
+	uint32_t phase_accumulator = 0;
+	uint32_t phase_increment = 0;
+	int32_t magnitude = 0;
 };
 
 
@@ -181,8 +181,8 @@ public:
 		phase_accumulator = ph;
 	}
 private:
-	uint32_t phase_accumulator;
-	uint32_t phase_increment;
-	int32_t magnitude;
+	uint32_t phase_accumulator = 0;
+	uint32_t phase_increment = 0;
+	int32_t magnitude = 0;
 };
 
@@ -234,15 +234,15 @@ public:
 	}
 
 private:
-	uint32_t phase_accumulator;
-	uint32_t phase_increment;
-	uint32_t phase_offset;
-	int32_t  magnitude;
-	uint32_t pulse_width;
-	const int16_t* arbdata;
-	int16_t  sample; // for WAVEFORM_SAMPLE_HOLD
-	short    tone_type;
-	int16_t  tone_offset;
+	uint32_t phase_accumulator = 0;
+	uint32_t phase_increment = 0;
+	uint32_t phase_offset = 0;
+	int32_t  magnitude = 0;
+	uint32_t pulse_width = 0;
+	const int16_t* arbdata = nullptr;
+	int16_t  sample = 0; // for WAVEFORM_SAMPLE_HOLD
+	short    tone_type = 0;
+	int16_t  tone_offset = 0;
 };
 
 class AudioSynthWaveformModulated : public AudioStream {
@@ -537,17 +537,17 @@ public:
 
 private:
 
-	uint32_t phase_accumulator;
-	uint32_t phase_increment;
-	uint32_t modulation_factor;
-	int32_t  magnitude;
-	const int16_t* arbdata;
-	uint32_t phasedata[AUDIO_BLOCK_SAMPLES];
-
-	int16_t  sample; // for WAVEFORM_SAMPLE_HOLD
-	int16_t  tone_offset;
-	uint8_t  tone_type;
-	uint8_t  modulation_type;
+	uint32_t phase_accumulator = 0;
+	uint32_t phase_increment = 0;
+	uint32_t modulation_factor = 0;
+	int32_t  magnitude = 0;
+	const int16_t* arbdata = nullptr;
+	uint32_t phasedata[AUDIO_BLOCK_SAMPLES] = {};
+
+	int16_t  sample = 0; // for WAVEFORM_SAMPLE_HOLD
+	int16_t  tone_offset = 0;
+	uint8_t  tone_type = 0;
+	uint8_t  modulation_type = 0;
 
 };
 
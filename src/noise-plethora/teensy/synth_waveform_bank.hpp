@@ -0,0 +1,60 @@
+#pragma once
+
+#include "audio_core.hpp"
+#include "mixer.hpp"
+#include "synth_waveform.hpp"
+
+/** Up to 16 AudioSynthWaveformModulated oscillators sharing a waveform and amplitude, summed with unity gain in
+ groups of four by four mixers and then by a fifth mixer, as the cluster algorithms wire them. Built from the same
+ oscillators the algorithms used to wire themselves and an AudioMixerTree, so the output is unchanged;
+ teensyfloat::AudioSynthWaveformBank has the same interface and renders all the partials at once. */
+class AudioSynthWaveformBank : public AudioStream {
+public:
+	static const int MAX_PARTIALS = 16;
+
+	AudioSynthWaveformBank(void) : AudioStream(2), numPartials(0) {
+	}
+
+	/** Uses the first `n` partials, all with the same amplitude (0 to 1.0) and waveform */
+	void begin(int n, float t_amp, short t_type) {
+		numPartials = clamp(n, 0, MAX_PARTIALS);
+		for (int i = 0; i < numPartials; i++) {
+			partials[i].begin(t_amp, 0, t_type);
+		}
+	}
+
+	void frequency(int partial, float freq) {
+		if (partial < 0 || partial >= numPartials) {
+			return;
+		}
+		partials[partial].frequency(freq);
+	}
+
+	/** Frequency modulation of every partial by the same input (8 octaves full scale), and the shape input that
+	 sets the width of WAVEFORM_PULSE and WAVEFORM_TRIANGLE_VARIABLE */
+	void update(const audio_block_t* moddata, const audio_block_t* shapedata, audio_block_t* out) {
+		for (int i = 0; i < numPartials; i++) {
+			partials[i].update(const_cast<audio_block_t*>(moddata), const_cast<audio_block_t*>(shapedata), &partialOut[i]);
+		}
+		mix(out);
+	}
+
+	/** Frequency modulation of each partial by its own input, `moddata` points to one block per partial */
+	void updatePerPartial(const audio_block_t* moddata, const audio_block_t* shapedata, audio_block_t* out) {
+		for (int i = 0; i < numPartials; i++) {
+			partials[i].update(const_cast<audio_block_t*>(&moddata[i]), const_cast<audio_block_t*>(shapedata), &partialOut[i]);
+		}
+		mix(out);
+	}
+
+private:
+
+	void mix(audio_block_t* out) {
+		mixer.update(partialOut, numPartials, out);
+	}
+
+	AudioSynthWaveformModulated partials[MAX_PARTIALS];
+	AudioMixerTree mixer;
+	audio_block_t partialOut[MAX_PARTIALS] = {};
+	int numPartials = 0;
+};
@@ -43,8 +43,8 @@ public:
 	}
 	virtual void update(audio_block_t* block);
 private:
-	int32_t  level; // 0=off, 65536=max
-	uint32_t seed;  // must start at 1
+	int32_t  level = 0; // 0=off, 65536=max
+	uint32_t seed = 0;  // must start at 1
 	static uint16_t instance_count;
 };
 
@@ -1,4 +1,6 @@
 #include "plugin.hpp"
+#include <mutex>
+#include <set>
 
 
 Plugin *pluginInstance;
@@ -30,3 +32,128 @@ void init(rack::Plugin *p) {
 	p->addModel(modelBurst);
 	p->addModel(modelVoltio);
 }
+
+
+std::atomic<bool> ProcessTelemetry::enabled{false};
+std::atomic<bool> FlushDenormals::enabled{true};
+
+// live instances, only touched from the UI/engine threads when modules are created or destroyed
+static std::mutex telemetryInstancesMutex;
+static std::set<ProcessTelemetry*> telemetryInstances;
+
+ProcessTelemetry::ProcessTelemetry(Module* module) : module(module) {
+	std::lock_guard<std::mutex> lock(telemetryInstancesMutex);
+	telemetryInstances.insert(this);
+}
+
+ProcessTelemetry::~ProcessTelemetry() {
+	std::lock_guard<std::mutex> lock(telemetryInstancesMutex);
+	telemetryInstances.erase(this);
+}
+
+// ns per tick of ProcessTelemetry::readTicks(), measured once against the steady clock
+static double nsPerTick() {
+	static const double ratio = []() {
+		const auto start = std::chrono::steady_clock::now();
+		const uint64_t startTicks = ProcessTelemetry::readTicks();
+		while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(10));
+		const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		const uint64_t ticks = ProcessTelemetry::readTicks() - startTicks;
+		return ticks > 0 ? ns / ticks : 1.;
+	}();
+	return ratio;
+}
+
+ProcessTelemetry::Summary ProcessTelemetry::summarise() const {
+	Summary summary;
+	const uint32_t count = std::min(numRecorded.load(std::memory_order_acquire), NUM_TIMINGS);
+	if (count == 0) {
+		return summary;
+	}
+
+	// the audio thread may overwrite the ring while we copy it, which only mixes in newer timings
+	std::vector<uint32_t> sorted(timings, timings + count);
+	std::sort(sorted.begin(), sorted.end());
+
+	double sum = 0.;
+	for (uint32_t ticks : sorted) {
+		sum += ticks;
+	}
+
+	const double scale = nsPerTick();
+	summary.meanNs = scale * sum / count;
+	summary.p99Ns = scale * sorted[std::min(count - 1, (uint32_t)(0.99 * count))];
+	summary.worstNs = scale * sorted.back();
+	summary.numTimings = count;
+	return summary;
+}
+
+json_t* ProcessTelemetry::allInstancesToJson() {
+	json_t* instancesJ = json_array();
+
+	std::lock_guard<std::mutex> lock(telemetryInstancesMutex);
+	for (ProcessTelemetry* telemetry : telemetryInstances) {
+		const Summary summary = telemetry->summarise();
+
+		json_t* instanceJ = json_object();
+		json_object_set_new(instanceJ, "module", json_string(telemetry->module->model ? telemetry->module->model->slug.c_str() : ""));
+		json_object_set_new(instanceJ, "id", json_integer(telemetry->module->id));
+		json_object_set_new(instanceJ, "meanNsPerSample", json_real(summary.meanNs));
+		json_object_set_new(instanceJ, "p99NsPerSample", json_real(summary.p99Ns));
+		json_object_set_new(instanceJ, "worstNsPerSample", json_real(summary.worstNs));
+		json_object_set_new(instanceJ, "samples", json_integer(summary.numTimings));
+		json_object_set_new(instanceJ, "channels", json_integer(telemetry->channels.load()));
+		json_object_set_new(instanceJ, "oversampling", json_integer(telemetry->oversamplingRatio.load()));
+		if (telemetry->idleDetector) {
+			json_object_set_new(instanceJ, "idlePercent", json_real(100.f * telemetry->idleDetector->getIdleFraction()));
+		}
+		json_array_append_new(instancesJ, instanceJ);
+	}
+	return instancesJ;
+}
+
+void appendTelemetryMenu(Menu* menu, ProcessTelemetry* telemetry) {
+	menu->addChild(new MenuSeparator());
+	menu->addChild(createSubmenuItem("CPU telemetry", "",
+	[ = ](Menu * menu) {
+		menu->addChild(createBoolMenuItem("Enabled (all modules)", "",
+		[]() {
+			return ProcessTelemetry::enabled.load();
+		},
+		[](bool enabled) {
+			ProcessTelemetry::enabled.store(enabled);
+		}
+		                                 ));
+
+		// idle detection is always on, so its savings are shown even with timing disabled
+		if (telemetry->idleDetector) {
+			menu->addChild(createMenuLabel(string::f("Idle: %.0f%%", 100.f * telemetry->idleDetector->getIdleFraction())));
+		}
+
+		if (!ProcessTelemetry::enabled) {
+			return;
+		}
+
+		const ProcessTelemetry::Summary summary = telemetry->summarise();
+		menu->addChild(createMenuLabel(string::f("Mean: %.0f ns/sample", summary.meanNs)));
+		menu->addChild(createMenuLabel(string::f("99th percentile: %.0f ns/sample", summary.p99Ns)));
+		menu->addChild(createMenuLabel(string::f("Worst case: %.0f ns/sample", summary.worstNs)));
+		menu->addChild(createMenuLabel(string::f("Oversampling: x%d", telemetry->oversamplingRatio.load())));
+		menu->addChild(createMenuLabel(string::f("Polyphony: %d channels", telemetry->channels.load())));
+
+		menu->addChild(createMenuItem("Save all instances as JSON", "",
+		[]() {
+			const std::string path = asset::user("Befaco-telemetry.json");
+			json_t* instancesJ = ProcessTelemetry::allInstancesToJson();
+			if (json_dump_file(instancesJ, path.c_str(), JSON_INDENT(2)) == 0) {
+				INFO("Saved CPU telemetry to %s", path.c_str());
+			}
+			else {
+				WARN("Could not save CPU telemetry to %s", path.c_str());
+			}
+			json_decref(instancesJ);
+		}
+		                             ));
+	}
+	                                ));
+}
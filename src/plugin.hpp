@@ -1,9 +1,18 @@
 #pragma once
 #include <rack.hpp>
+#include <atomic>
+#include <map>
+#include <mutex>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 
 using namespace rack;
 
+#include "FastMath.hpp"
+#include "Denormals.hpp"
+
 
 extern Plugin* pluginInstance;
 
@@ -242,26 +251,6 @@ inline int unsigned_modulo(int a, int b) {
 	return ((a % b) + b) % b;
 }
 
-template <typename T>
-T sin2pi_pade_05_5_4(T x) {
-	x -= 0.5f;
-	return (T(-6.283185307) * x + T(33.19863968) * simd::pow(x, 3) - T(32.44191367) * simd::pow(x, 5))
-	       / (1 + T(1.296008659) * simd::pow(x, 2) + T(0.7028072946) * simd::pow(x, 4));
-}
-
-template <typename T>
-T tanh_pade(T x) {
-	T x2 = x * x;
-	T q = 12.f + x2;
-	return 12.f * x * q / (36.f * x2 + q * q);
-}
-
-template <typename T>
-T exponentialBipolar80Pade_5_4(T x) {
-	return (T(0.109568) * x + T(0.281588) * simd::pow(x, 3) + T(0.133841) * simd::pow(x, 5))
-	       / (T(1.) - T(0.630374) * simd::pow(x, 2) + T(0.166271) * simd::pow(x, 4));
-}
-
 struct ADEnvelope {
 	enum Stage {
 		STAGE_OFF,
@@ -311,8 +300,8 @@ private:
 	float envLinear = 0.f;
 };
 
-// Creates a Butterworth 2*Nth order highpass filter for blocking DC
-template<int N>
+// Creates a Butterworth 2*Nth order highpass filter for blocking DC, on float or on simd::float_4 (one filter per lane)
+template<int N, typename T = float>
 struct DCBlockerT {
 
 	DCBlockerT() {
@@ -325,13 +314,28 @@ struct DCBlockerT {
 		recalculateCoefficients();
 	}
 
-	float process(float x) {
+	T process(T x) {
 		for (int idx = 0; idx < N; idx++) {
 			x = blockDCFilter[idx].process(x);
 		}
+		if (snapTimer.process()) {
+			flushDenormals();
+		}
 		return x;
 	}
 
+	/** Sets state that has decayed below DENORMAL_SNAP_THRESHOLD to zero, process() calls this periodically */
+	void flushDenormals() {
+		for (int idx = 0; idx < N; idx++) {
+			for (T& x : blockDCFilter[idx].x) {
+				x = snapToZero(x);
+			}
+			for (T& y : blockDCFilter[idx].y) {
+				y = snapToZero(y);
+			}
+		}
+	}
+
 private:
 
 	// https://www.earlevel.com/main/2016/09/29/cascading-filters/
@@ -342,14 +346,15 @@ private:
 
 		for (int idx = 0; idx < N; idx++) {
 			float Q = 1.0f / (2.0f * std::cos(firstAngle + idx * poleInc));
-			blockDCFilter[idx].setParameters(dsp::BiquadFilter::HIGHPASS, fc_, Q, 1.0f);
+			blockDCFilter[idx].setParameters(dsp::TBiquadFilter<T>::HIGHPASS, fc_, Q, 1.0f);
 		}
 	}
 
 	float fc_;
 	static const int order = 2 * N;
 
-	dsp::BiquadFilter blockDCFilter[N];
+	dsp::TBiquadFilter<T> blockDCFilter[N];
+	DenormalSnapTimer snapTimer;
 };
 
 typedef DCBlockerT<2> DCBlocker;
@@ -402,4 +407,562 @@ private:
 
 		return limit * (offset + x1 - simd::sqrt(x1 * x1 - y1 * x) * (1.0f / y1));
 	}
-};
\ No newline at end of file
+};
+
+/** Control-rate parameter pipeline. Every `division` samples process() returns true, and the module re-evaluates its
+ expensive parameter maps (exponentials, dB to gain, filter coefficients), using changed() to skip those whose
+ inputs haven't moved since the last tick. The results are handed to ControlRateValue ramps, which interpolate
+ them per sample so the steps don't cause zipper noise. The first call to process() is always a tick. */
+template <int NUM_TRACKED>
+struct ControlRate {
+
+	ControlRate() {
+		invalidate();
+	}
+
+	void setDivision(int division) {
+		this->division = std::max(division, 1);
+	}
+
+	int getDivision() const {
+		return division;
+	}
+
+	/** Call once per sample, returns true when the control-rate work is due */
+	bool process() {
+		if (countdown > 0) {
+			countdown--;
+			return false;
+		}
+		countdown = division - 1;
+		return true;
+	}
+
+	/** Forces a tick on the next call to process() */
+	void reset() {
+		countdown = 0;
+	}
+
+	/** True if `value` differs from the value seen the last time slot `id` was checked (and on the first check) */
+	bool changed(int id, float value) {
+		if (value == lastValues[id]) {
+			return false;
+		}
+		lastValues[id] = value;
+		return true;
+	}
+
+	/** Every slot reports a change on its next check, e.g. after a sample rate change */
+	void invalidate() {
+		for (int id = 0; id < NUM_TRACKED; ++id) {
+			lastValues[id] = NAN;
+		}
+	}
+
+private:
+	int division = 16;
+	int countdown = 0;
+	float lastValues[NUM_TRACKED];
+};
+
+/** A value set at control rate and interpolated per sample, see ControlRate. LINEAR ramps add a constant step,
+ EXPONENTIAL ramps multiply by a constant ratio (better suited to gains and frequencies, but values must be
+ positive). Works with float or simd::float_4, and costs a single branch once the ramp has finished. */
+template <typename T = float>
+struct ControlRateValue {
+	enum Interpolation {
+		LINEAR,
+		EXPONENTIAL
+	};
+	Interpolation interpolation = LINEAR;
+
+	/** Ramps to `target` over `samples` samples. The first call (and samples <= 1) jumps straight there. */
+	void setTarget(T newTarget, int samples) {
+		if (!initialised || samples <= 1) {
+			reset(newTarget);
+			return;
+		}
+		target = newTarget;
+		increment = (interpolation == EXPONENTIAL) ? simd::pow(target / value, T(1.f / samples)) : (target - value) / samples;
+		remaining = samples;
+	}
+
+	/** Jumps straight to `newValue` */
+	void reset(T newValue) {
+		value = target = newValue;
+		remaining = 0;
+		initialised = true;
+	}
+
+	/** Advances the ramp by one sample */
+	T process() {
+		if (remaining > 0) {
+			// land exactly on the target, whatever rounding has accumulated
+			value = (--remaining == 0) ? target : (interpolation == EXPONENTIAL) ? value * increment : value + increment;
+		}
+		return value;
+	}
+
+	T getValue() const {
+		return value;
+	}
+
+private:
+	T value = 0.f;
+	T target = 0.f;
+	T increment = 0.f;
+	int remaining = 0;
+	bool initialised = false;
+};
+
+/** Opt-in block processing for modules whose per-sample overhead (reading params, checking connections,
+ computing gains) outweighs their DSP. Input frames are gathered until a block is full, the module's
+ processBlock(args, frames) kernel then runs over the whole block, and its outputs are played back one frame
+ per process() call. Because Rack hands us one frame at a time, a block of N frames delays the outputs by
+ N - 1 samples, so the default block size of 1 behaves exactly like per-sample processing.
+
+ Usage: hold a BlockProcessor<NUM_INPUTS, NUM_OUTPUTS>, forward process() to block.process(this, args), and
+ in processBlock() read inputs/write outputs through the block's accessors. The kernel sets output channel
+ counts on the ports as usual. */
+template <int NUM_INPUTS, int NUM_OUTPUTS>
+struct BlockProcessor {
+	static const int MAX_BLOCK_SIZE = 32;
+
+	/** Sets the number of frames per processBlock() call, in [1, MAX_BLOCK_SIZE]. Safe from any thread, e.g. the
+	 context menu: the audio thread switches over at the start of its next block */
+	void setBlockSize(int newBlockSize) {
+		requestedBlockSize = clamp(newBlockSize, 1, MAX_BLOCK_SIZE);
+	}
+
+	int getBlockSize() const {
+		return requestedBlockSize;
+	}
+
+	template <class TModule>
+	void process(TModule* module, const Module::ProcessArgs& args) {
+		if (currentFrame == 0) {
+			const int newBlockSize = requestedBlockSize.load(std::memory_order_relaxed);
+			if (newBlockSize != blockSize) {
+				blockSize = newBlockSize;
+				// the rest of the previous block's outputs are for the old latency
+				std::memset(outputVoltages, 0, sizeof(outputVoltages));
+			}
+		}
+
+		for (int i = 0; i < NUM_INPUTS; ++i) {
+			// fixed size copies (all channels) are cheaper than working out how many are in use
+			inputChannels[i] = module->inputs[i].getChannels();
+			std::memcpy(inputVoltages[i][currentFrame], module->inputs[i].voltages, sizeof(inputVoltages[i][currentFrame]));
+		}
+
+		if (++currentFrame >= blockSize) {
+			module->processBlock(args, blockSize);
+			currentFrame = 0;
+		}
+
+		for (int i = 0; i < NUM_OUTPUTS; ++i) {
+			std::memcpy(module->outputs[i].voltages, outputVoltages[i][currentFrame], sizeof(outputVoltages[i][currentFrame]));
+		}
+	}
+
+	/** Input accessors, with the same semantics as the Input methods of the same name */
+	int getChannels(int input) const {
+		return inputChannels[input];
+	}
+
+	bool isConnected(int input) const {
+		return inputChannels[input] > 0;
+	}
+
+	float getVoltage(int input, int frame, int c = 0) const {
+		return inputVoltages[input][frame][c];
+	}
+
+	float getNormalVoltage(int input, int frame, float normalVoltage, int c = 0) const {
+		return isConnected(input) ? inputVoltages[input][frame][c] : normalVoltage;
+	}
+
+	float getPolyVoltage(int input, int frame, int c) const {
+		return inputChannels[input] == 1 ? inputVoltages[input][frame][0] : inputVoltages[input][frame][c];
+	}
+
+	float getVoltageSum(int input, int frame) const {
+		float sum = 0.f;
+		for (int c = 0; c < inputChannels[input]; ++c) {
+			sum += inputVoltages[input][frame][c];
+		}
+		return sum;
+	}
+
+	template <typename T>
+	T getVoltageSimd(int input, int frame, int c) const {
+		return T::load(&inputVoltages[input][frame][c]);
+	}
+
+	template <typename T>
+	T getPolyVoltageSimd(int input, int frame, int c) const {
+		return inputChannels[input] == 1 ? T(inputVoltages[input][frame][0]) : getVoltageSimd<T>(input, frame, c);
+	}
+
+	template <typename T>
+	T getNormalPolyVoltageSimd(int input, int frame, T normalVoltage, int c) const {
+		return isConnected(input) ? getPolyVoltageSimd<T>(input, frame, c) : normalVoltage;
+	}
+
+	/** Output accessors */
+	void setVoltage(int output, int frame, float voltage, int c = 0) {
+		outputVoltages[output][frame][c] = voltage;
+	}
+
+	template <typename T>
+	void setVoltageSimd(int output, int frame, T voltage, int c) {
+		voltage.store(&outputVoltages[output][frame][c]);
+	}
+
+private:
+	float inputVoltages[NUM_INPUTS][MAX_BLOCK_SIZE][PORT_MAX_CHANNELS] = {};
+	int inputChannels[NUM_INPUTS] = {};
+	float outputVoltages[NUM_OUTPUTS][MAX_BLOCK_SIZE][PORT_MAX_CHANNELS] = {};
+	// written by setBlockSize(), blockSize follows it on the audio thread
+	std::atomic<int> requestedBlockSize{1};
+	int blockSize = 1;
+	int currentFrame = 0;
+};
+
+/** Context menu entry for choosing a module's block size, the added latency is shown alongside */
+template <class TBlockProcessor>
+MenuItem* createBlockSizeMenuItem(TBlockProcessor* block) {
+	static const std::vector<int> blockSizes = {1, 8, 16, 32};
+	return createIndexSubmenuItem("Block processing",
+	{"Off", "8 samples (7 samples latency)", "16 samples (15 samples latency)", "32 samples (31 samples latency)"},
+	[ = ]() {
+		const auto it = std::find(blockSizes.begin(), blockSizes.end(), block->getBlockSize());
+		return it != blockSizes.end() ? it - blockSizes.begin() : 0;
+	},
+	[ = ](int index) {
+		block->setBlockSize(blockSizes[index]);
+	}
+	                             );
+}
+
+/** Lock-free channel for widgets to read audio-thread state (single producer, single consumer). The module fills in
+ back() at display rate and calls publish(). The widget calls consume() in step() and reads front(). The three
+ buffers are swapped with one atomic exchange, so neither side blocks or allocates, and the widget never sees a
+ half-written snapshot. T should be plain data. */
+template <typename T>
+struct UISnapshot {
+	/** Audio thread: the snapshot to fill in before publish() */
+	T& back() {
+		return buffers[backIndex];
+	}
+
+	/** Audio thread: hands back() to the UI. Returns false if the previously published snapshot was never consumed,
+	 in which case back() now holds that stale snapshot, so the module can merge into it rather than lose it. */
+	bool publish() {
+		const int previous = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel);
+		backIndex = previous & INDEX_MASK;
+		return !(previous & FRESH);
+	}
+
+	/** UI thread: picks up the latest snapshot, returns true if there was a new one */
+	bool consume() {
+		if (!(middle.load(std::memory_order_acquire) & FRESH)) {
+			return false;
+		}
+		frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	/** UI thread: the most recently consumed snapshot */
+	const T& front() const {
+		return buffers[frontIndex];
+	}
+
+private:
+	static const int INDEX_MASK = 3;
+	static const int FRESH = 4;
+
+	T buffers[3] = {};
+	int backIndex = 0;
+	std::atomic<int> middle{1};
+	int frontIndex = 2;
+};
+
+/** Plugin-wide cache of immutable tables (waveshaper LUTs, transformed impulse responses, ...), so that every
+ instance of a module shares one copy instead of building and storing its own. A table is identified by its type, a
+ name and the sample rate it was built for (0 if it doesn't depend on one). get() builds it on first request by
+ calling build(table) on a default-constructed TTable, and the table is freed when the last holder lets go of it.
+ get() locks and may allocate, so call it from the module's constructor or another UI-thread event. */
+template <typename TTable>
+struct SharedTable {
+	template <typename TBuild>
+	static std::shared_ptr<const TTable> get(const std::string& name, float sampleRate, TBuild build) {
+		Registry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		std::weak_ptr<const TTable>& entry = registry.tables[std::make_pair(name, sampleRate)];
+		std::shared_ptr<const TTable> table = entry.lock();
+		if (!table) {
+			std::shared_ptr<TTable> newTable = std::make_shared<TTable>();
+			build(*newTable);
+			table = newTable;
+			entry = table;
+		}
+		return table;
+	}
+
+private:
+	struct Registry {
+		std::mutex mutex;
+		// entries whose table has been freed are left behind, they are only a key and an expired weak_ptr
+		std::map<std::pair<std::string, float>, std::weak_ptr<const TTable>> tables;
+	};
+
+	// one registry per table type, independent of the builder
+	static Registry& getRegistry() {
+		static Registry registry;
+		return registry;
+	}
+};
+
+/** Lets a module skip its DSP once it has gone quiet. Every sample the module reports whether it is active, i.e.
+ whether anything could make it produce output: a non-zero input, a trigger, an envelope still running, or a filter
+ or reverb tail above the silence threshold. Once it has been inactive for holdSamples samples in a row it is idle,
+ and the module skips its DSP. As activity is still checked every sample, the module wakes on the same sample
+ that an input or trigger arrives. The fraction of idle samples is shown in the module's CPU telemetry menu. */
+struct IdleDetector {
+	/** Voltages at or below this are treated as silence, ~-140 dB relative to 10 V */
+	static constexpr float SILENCE_THRESHOLD = 1e-6f;
+	// idle fraction is published once per window, ~0.7s at 44.1kHz
+	static const int WINDOW = 1 << 15;
+
+	/** Returns true if the module can skip its DSP for this sample */
+	bool process(bool active, int holdSamples = 0) {
+		quietSamples = active ? 0 : std::min(quietSamples + 1, holdSamples + 1);
+
+		const bool wasIdle = idle;
+		idle = quietSamples > holdSamples;
+		wentIdle = idle && !wasIdle;
+		wokeUp = !idle && wasIdle;
+
+		idleSamples += idle;
+		if (++windowSamples == WINDOW) {
+			idleFraction.store((float) idleSamples / WINDOW, std::memory_order_relaxed);
+			idleSamples = windowSamples = 0;
+		}
+		return idle;
+	}
+
+	/** True only on the first idle sample, so the module can zero its outputs and lights once */
+	bool enteredIdle() const {
+		return wentIdle;
+	}
+
+	/** True only on the first sample after being idle, e.g. to refresh control-rate state straight away */
+	bool leftIdle() const {
+		return wokeUp;
+	}
+
+	/** Safe to call from the UI thread */
+	float getIdleFraction() const {
+		return idleFraction.load(std::memory_order_relaxed);
+	}
+
+	static bool isSilent(float x) {
+		return std::abs(x) <= SILENCE_THRESHOLD;
+	}
+
+	/** True if every channel is silent (or the input is unpatched) */
+	static bool isSilent(Input& input) {
+		for (int c = 0; c < input.getChannels(); c++) {
+			if (!isSilent(input.getVoltage(c))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	bool idle = false;
+	bool wentIdle = false;
+	bool wokeUp = false;
+	int quietSamples = 0;
+	int idleSamples = 0;
+	int windowSamples = 0;
+	std::atomic<float> idleFraction{0.f};
+};
+
+/** Audio-thread audit, a debug build mode (`make AUDIT=1`, Linux only). While a ProcessScope is alive on a thread,
+ any heap allocation, heap free or mutex lock made from plugin code on that thread is reported to stderr with the
+ offending module and a stack trace (once per module and kind), and counted. TelemetryModule opens a scope around
+ every process() and onSampleRateChange() call, which Rack makes from the engine threads. In normal builds
+ ProcessScope is empty and compiles away. */
+namespace audit {
+
+enum Violation {
+	ALLOCATION,
+	DEALLOCATION,
+	MUTEX_LOCK,
+	NUM_VIOLATIONS
+};
+
+#ifdef BEFACO_AUDIT_AUDIO_THREAD
+struct ProcessScope {
+	explicit ProcessScope(const Module* module);
+	~ProcessScope();
+private:
+	const Module* previous;
+};
+
+/** Total violations seen so far, from every thread */
+int getNumViolations();
+#else
+struct ProcessScope {
+	explicit ProcessScope(const Module* module) {}
+};
+
+inline int getNumViolations() {
+	return 0;
+}
+#endif
+
+} // namespace audit
+
+/** Per-instance CPU telemetry. Every module is wrapped in a TelemetryModule (see createModelWithTelemetry) so that,
+ while telemetry is enabled, each process() call is timed into a lock-free ring of recent timings. The UI thread
+ summarises the ring for the context menu, or for all instances at once as JSON. When disabled the only cost is
+ one relaxed atomic load per sample, and nothing is ever allocated on the audio thread. */
+struct ProcessTelemetry {
+	// a power of two, ~93ms of history at 44.1kHz
+	static const uint32_t NUM_TIMINGS = 4096;
+
+	struct Summary {
+		float meanNs = 0.f;
+		float p99Ns = 0.f;
+		float worstNs = 0.f;
+		int numTimings = 0;
+	};
+
+	/** Enables timing of all instances */
+	static std::atomic<bool> enabled;
+
+	Module* module;
+	// the module's IdleDetector, or nullptr for modules without idle detection
+	const IdleDetector* idleDetector = nullptr;
+	// last seen polyphony (most channels on any output) and oversampling factor
+	std::atomic<int> channels{0};
+	std::atomic<int> oversamplingRatio{1};
+
+	explicit ProcessTelemetry(Module* module);
+	~ProcessTelemetry();
+
+	/** Cheapest available timestamp, converted to ns by summarise() */
+	static uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#elif defined(__aarch64__)
+		uint64_t ticks;
+		asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+		return ticks;
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	/** Audio thread only */
+	void record(uint64_t ticks) {
+		const uint32_t index = numRecorded.load(std::memory_order_relaxed);
+		timings[index & (NUM_TIMINGS - 1)] = std::min<uint64_t>(ticks, UINT32_MAX);
+		numRecorded.store(index + 1, std::memory_order_release);
+	}
+
+	/** UI thread only, statistics over the ring's current contents */
+	Summary summarise() const;
+
+	/** UI thread only, summaries of every live instance */
+	static json_t* allInstancesToJson();
+
+private:
+	uint32_t timings[NUM_TIMINGS] = {};
+	std::atomic<uint32_t> numRecorded{0};
+};
+
+void appendTelemetryMenu(Menu* menu, ProcessTelemetry* telemetry);
+
+// modules with variable oversampling report it with int getOversamplingRatio()
+template <class TModule>
+auto oversamplingRatioOf(TModule* module, int) -> decltype(module->getOversamplingRatio()) {
+	return module->getOversamplingRatio();
+}
+
+template <class TModule>
+int oversamplingRatioOf(TModule* module, long) {
+	return 1;
+}
+
+// modules with idle detection hold an IdleDetector named idleDetector
+template <class TModule>
+auto idleDetectorOf(TModule* module, int) -> decltype(&module->idleDetector) {
+	return &module->idleDetector;
+}
+
+template <class TModule>
+const IdleDetector* idleDetectorOf(TModule* module, long) {
+	return nullptr;
+}
+
+template <class TModule>
+struct TelemetryModule : TModule {
+	ProcessTelemetry telemetry{this};
+
+	TelemetryModule() {
+		telemetry.idleDetector = idleDetectorOf<TModule>(this, 0);
+	}
+
+	void process(const Module::ProcessArgs& args) override {
+		audit::ProcessScope scope(this);
+		FlushDenormals::onThisThread();
+
+		if (!ProcessTelemetry::enabled.load(std::memory_order_relaxed)) {
+			TModule::process(args);
+			return;
+		}
+
+		const uint64_t start = ProcessTelemetry::readTicks();
+		TModule::process(args);
+		telemetry.record(ProcessTelemetry::readTicks() - start);
+
+		int channels = 0;
+		for (Output& output : this->outputs) {
+			channels = std::max(channels, output.getChannels());
+		}
+		telemetry.channels.store(channels, std::memory_order_relaxed);
+		telemetry.oversamplingRatio.store(oversamplingRatioOf<TModule>(this, 0), std::memory_order_relaxed);
+	}
+
+	// Rack calls this from the engine thread when the audio device's sample rate changes
+	void onSampleRateChange(const Module::SampleRateChangeEvent& e) override {
+		audit::ProcessScope scope(this);
+		// the modules override the argument-less overload, which Module's version calls
+		Module::onSampleRateChange(e);
+	}
+};
+
+template <class TModule, class TModuleWidget>
+struct TelemetryModuleWidget : TModuleWidget {
+	TelemetryModuleWidget(TelemetryModule<TModule>* module) : TModuleWidget(module) {}
+
+	void appendContextMenu(Menu* menu) override {
+		TModuleWidget::appendContextMenu(menu);
+
+		TelemetryModule<TModule>* module = dynamic_cast<TelemetryModule<TModule>*>(this->module);
+		assert(module);
+		appendTelemetryMenu(menu, &module->telemetry);
+	}
+};
+
+/** createModel(), with the module's process() instrumented and the telemetry added to its context menu */
+template <class TModule, class TModuleWidget>
+Model* createModelWithTelemetry(const std::string& slug) {
+	return createModel<TelemetryModule<TModule>, TelemetryModuleWidget<TModule, TModuleWidget>>(slug);
+}